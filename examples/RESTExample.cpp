@@ -57,7 +57,7 @@ int main( int , char** )
   }
 
 
-  simil::TSpikes spikes = spkData->spikes( );
+  const simil::Spikes& spikes = spkData->spikes( );
   float startTime = spkData->startTime( );
   float endTime = spkData->endTime( );
 
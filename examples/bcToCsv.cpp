@@ -86,7 +86,7 @@ int main( int argc, char** argv )
     std::cout << "Loaded GIDS: " << gids.size( ) << std::endl;
     simil::TPosVect positions = simData.positions( );
     std::cout << "Loaded positions: " << positions.size( ) << std::endl;
-    simil::TSpikes spikes = simData.spikes( );
+    const simil::Spikes& spikes = simData.spikes( );
 
     const float startTime = simData.startTime( );
     const float endTime = simData.endTime( );
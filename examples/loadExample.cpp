@@ -88,7 +88,7 @@ int main( int argc, char** argv )
 
     std::cout << "Loaded positions: " << positions.size( ) << std::endl;
 
-    simil::TSpikes spikes = simData.spikes( );
+    const simil::Spikes& spikes = simData.spikes( );
 
     float startTime = simData.startTime( );
     float endTime = simData.endTime( );
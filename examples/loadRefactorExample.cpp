@@ -123,7 +123,7 @@ int main( int argc , char** argv )
 
   std::cout << "Loaded GIDS: " << gids.size( ) << std::endl;
 
-  simil::TSpikes spikes = spkData->spikes( );
+  const simil::Spikes& spikes = spkData->spikes( );
   float startTime = spkData->startTime( );
   float endTime = spkData->endTime( );
 
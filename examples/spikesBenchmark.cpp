@@ -0,0 +1,321 @@
+/*
+ * Copyright (c) 2015-2020 VG-Lab/URJC.
+ *
+ * Authors: Sergio E. Galindo <sergio.galindo@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#include <simil/simil.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <numeric>
+#include <random>
+
+/** Synthetic spike generators. */
+simil::TSpikes uniformSpikes( size_t count, float endTime, std::mt19937& rng )
+{
+  std::uniform_real_distribution< float > time( 0.0f, endTime );
+  std::uniform_int_distribution< uint32_t > gid( 0, 100000 );
+
+  simil::TSpikes spikes( count );
+  for( auto& spike : spikes )
+    spike = std::make_pair( time( rng ), gid( rng ));
+
+  std::sort( spikes.begin( ), spikes.end( ));
+  return spikes;
+}
+
+simil::TSpikes burstySpikes( size_t count, float endTime, std::mt19937& rng )
+{
+  // 90% of the spikes inside a handful of very narrow bursts.
+  const unsigned int bursts = 5;
+  const float burstWidth = endTime * 1e-5f;
+
+  std::uniform_real_distribution< float > time( 0.0f, endTime );
+  std::uniform_real_distribution< float > burst( 0.0f, burstWidth );
+  std::uniform_real_distribution< float > coin( 0.0f, 1.0f );
+  std::uniform_int_distribution< uint32_t > gid( 0, 100000 );
+
+  std::vector< float > burstStarts( bursts );
+  for( auto& start : burstStarts )
+    start = time( rng );
+
+  simil::TSpikes spikes( count );
+  for( auto& spike : spikes )
+  {
+    float t = time( rng );
+    if( coin( rng ) < 0.9f )
+      t = burstStarts[ rng( ) % bursts ] + burst( rng );
+
+    spike = std::make_pair( t, gid( rng ));
+  }
+
+  std::sort( spikes.begin( ), spikes.end( ));
+  return spikes;
+}
+
+void benchmark( const std::string& name, const simil::TSpikes& data,
+                float endTime, std::mt19937& rng )
+{
+  auto start = std::chrono::high_resolution_clock::now( );
+  simil::Spikes spikes( data );
+  auto end = std::chrono::high_resolution_clock::now( );
+
+  const double buildMs =
+    std::chrono::duration< double, std::milli >( end - start ).count( );
+
+  const size_t queries = 1000000;
+  std::uniform_real_distribution< float > time( -1.0f, endTime + 1.0f );
+  std::vector< float > times( queries );
+  for( auto& t : times )
+  {
+    t = time( rng );
+    // Half of the queries fall inside dense regions.
+    if( rng( ) % 2 )
+      t = data[ rng( ) % data.size( )].first;
+  }
+
+  size_t checksum = 0;
+  start = std::chrono::high_resolution_clock::now( );
+  for( auto t : times )
+    checksum += spikes.elementAt( t ) - spikes.cbegin( );
+  end = std::chrono::high_resolution_clock::now( );
+
+  const double seekNs =
+    std::chrono::duration< double, std::nano >( end - start ).count( ) / queries;
+
+  size_t reference = 0;
+  start = std::chrono::high_resolution_clock::now( );
+  for( auto t : times )
+    reference += std::lower_bound( data.cbegin( ), data.cend( ), t,
+      []( const simil::Spike& s, float v ){ return s.first < v; }) - data.cbegin( );
+  end = std::chrono::high_resolution_clock::now( );
+
+  const double binaryNs =
+    std::chrono::duration< double, std::nano >( end - start ).count( ) / queries;
+
+  // Frame sized windows, as requested by the players every frame.
+  const size_t windows = 100000;
+  const float windowWidth = endTime * 1e-3f;
+  std::vector< uint32_t > gids;
+
+  size_t gathered = 0;
+  start = std::chrono::high_resolution_clock::now( );
+  for( size_t i = 0; i < windows; ++i )
+  {
+    spikes.gidsBetween( times[ i ], times[ i ] + windowWidth, gids );
+    gathered += gids.size( );
+  }
+  end = std::chrono::high_resolution_clock::now( );
+
+  const double gatherUs =
+    std::chrono::duration< double, std::micro >( end - start ).count( ) / windows;
+
+  size_t scanned = 0;
+  start = std::chrono::high_resolution_clock::now( );
+  for( size_t i = 0; i < windows; ++i )
+  {
+    gids.clear( );
+    auto it = std::lower_bound( data.cbegin( ), data.cend( ), times[ i ],
+      []( const simil::Spike& s, float v ){ return s.first < v; });
+    for( ; it != data.cend( ) && it->first < times[ i ] + windowWidth; ++it )
+      gids.push_back( it->second );
+    scanned += gids.size( );
+  }
+  end = std::chrono::high_resolution_clock::now( );
+
+  const double scanUs =
+    std::chrono::duration< double, std::micro >( end - start ).count( ) / windows;
+
+  std::cout << name << ": " << data.size( ) << " spikes, "
+            << simil::SpikeColumns::chunkCount( spikes.size( ))
+            << " chunks, build " << buildMs << " ms, elementAt "
+            << seekNs << " ns/query, std::lower_bound " << binaryNs
+            << " ns/query, gidsBetween " << gatherUs << " us/window, "
+            << "pair scan " << scanUs << " us/window"
+            << ( checksum == reference && gathered == scanned ?
+                 "" : " MISMATCH" )
+            << std::endl;
+}
+
+/** Streams batches as the REST loader does and compares the ingest cost of
+ * the first and the last batches, which should be the same. */
+void streaming( size_t count, float lateRatio, std::mt19937& rng )
+{
+  const size_t batchSize = 1000;
+  const size_t batches = std::max( count / batchSize, size_t( 10 ));
+  const float batchTime = 1.0f;
+
+  std::uniform_real_distribution< float > offset( 0.0f, batchTime );
+  std::uniform_real_distribution< float > coin( 0.0f, 1.0f );
+
+  simil::Spikes spikes;
+  simil::TSpikes batch( batchSize );
+  std::vector< double > costs( batches );
+
+  for( size_t b = 0; b < batches; ++b )
+  {
+    for( auto& spike : batch )
+    {
+      float t = b * batchTime + offset( rng );
+      // Late spikes belong to the previous batch.
+      if( b > 0 && coin( rng ) < lateRatio )
+        t -= batchTime;
+      spike = std::make_pair( t, static_cast< uint32_t >( rng( ) % 100000 ));
+    }
+    std::sort( batch.begin( ), batch.end( ));
+
+    const auto start = std::chrono::high_resolution_clock::now( );
+    spikes.append( batch );
+    const auto end = std::chrono::high_resolution_clock::now( );
+
+    costs[ b ] =
+      std::chrono::duration< double, std::micro >( end - start ).count( );
+  }
+
+  const size_t tenth = batches / 10;
+  const double first = std::accumulate( costs.begin( ),
+    costs.begin( ) + tenth, 0.0 ) / tenth;
+  const double last = std::accumulate( costs.end( ) - tenth,
+    costs.end( ), 0.0 ) / tenth;
+
+  std::cout << "streaming, " << lateRatio * 100 << "% late: " << batches
+            << " batches of " << batchSize << ", first 10% "
+            << first << " us/batch, last 10% " << last << " us/batch"
+            << std::endl;
+}
+
+/** Compares the memory and the access cost of compressed and plain spikes. */
+void compression( const std::string& name, const simil::TSpikes& data,
+                  float endTime, std::mt19937& rng )
+{
+  simil::Spikes plain( data );
+  simil::Spikes packed( plain );
+
+  auto start = std::chrono::high_resolution_clock::now( );
+  packed.setCompression( true );
+  auto end = std::chrono::high_resolution_clock::now( );
+
+  const double compressMs =
+    std::chrono::duration< double, std::milli >( end - start ).count( );
+  const size_t size = packed.size( );
+  const double ratio =
+    static_cast< double >( plain.memoryUsage( )) / packed.memoryUsage( );
+
+  // Sequential decode, as done when building trains and pyramids.
+  double timeSum = 0.0;
+  uint64_t gidSum = 0;
+  start = std::chrono::high_resolution_clock::now( );
+  for( size_t position = 0; position < size; )
+  {
+    const auto run = packed.run( position, size );
+    for( size_t i = 0; i < run.size; ++i )
+    {
+      timeSum += run.times[ i ];
+      gidSum += run.gids[ i ];
+    }
+    position += run.size;
+  }
+  end = std::chrono::high_resolution_clock::now( );
+
+  const double decodeSeconds =
+    std::chrono::duration< double >( end - start ).count( );
+  const double decodeGBs = size * ( sizeof( float ) + sizeof( uint32_t )) /
+    decodeSeconds * 1e-9;
+
+  const size_t queries = 100000;
+  std::uniform_real_distribution< float > time( 0.0f, endTime );
+  std::vector< float > times( queries );
+  for( auto& t : times )
+    t = time( rng );
+
+  const auto seek = [ & ]( const simil::Spikes& spikes, size_t& checksum )
+  {
+    const auto start_ = std::chrono::high_resolution_clock::now( );
+    for( auto t : times )
+      checksum += spikes.elementAt( t ) - spikes.cbegin( );
+    const auto end_ = std::chrono::high_resolution_clock::now( );
+    return std::chrono::duration< double, std::nano >( end_ - start_ ).count( )
+      / queries;
+  };
+
+  const float windowWidth = endTime * 1e-3f;
+  std::vector< uint32_t > gids;
+  const auto gather = [ & ]( const simil::Spikes& spikes, size_t& gathered )
+  {
+    const auto start_ = std::chrono::high_resolution_clock::now( );
+    for( auto t : times )
+    {
+      spikes.gidsBetween( t, t + windowWidth, gids );
+      gathered += gids.size( );
+    }
+    const auto end_ = std::chrono::high_resolution_clock::now( );
+    return std::chrono::duration< double, std::micro >( end_ - start_ ).count( )
+      / queries;
+  };
+
+  size_t plainSeeks = 0, packedSeeks = 0, plainGids = 0, packedGids = 0;
+  const double plainSeekNs = seek( plain, plainSeeks );
+  const double packedSeekNs = seek( packed, packedSeeks );
+  const double plainGatherUs = gather( plain, plainGids );
+  const double packedGatherUs = gather( packed, packedGids );
+
+  std::cout << name << " compressed: " << plain.memoryUsage( ) << " -> "
+            << packed.memoryUsage( ) << " bytes, ratio " << ratio
+            << ", compress " << compressMs << " ms, decode " << decodeGBs
+            << " GB/s, elementAt " << plainSeekNs << " -> " << packedSeekNs
+            << " ns/query, gidsBetween " << plainGatherUs << " -> "
+            << packedGatherUs << " us/window"
+            << ( plainSeeks == packedSeeks && plainGids == packedGids &&
+                 timeSum >= 0.0 && gidSum > 0 ? "" : " MISMATCH" )
+            << std::endl;
+}
+
+int main( int argc, char** argv )
+{
+  size_t count = 10000000;
+  if( argc > 1 )
+    count = std::stoul( argv[ 1 ]);
+
+  const float endTime = 3600.0f;
+  std::mt19937 rng( 42 );
+
+  benchmark( "uniform", uniformSpikes( count, endTime, rng ), endTime, rng );
+  benchmark( "bursty", burstySpikes( count, endTime, rng ), endTime, rng );
+  streaming( count, 0.0f, rng );
+  streaming( count, 0.01f, rng );
+
+  const auto uniform = uniformSpikes( count, endTime, rng );
+  compression( "uniform", uniform, endTime, rng );
+  const auto bursty = burstySpikes( count, endTime, rng );
+  compression( "bursty", bursty, endTime, rng );
+
+  // Optional real report: network and activity HDF5 files.
+  if( argc > 3 )
+  {
+    simil::SpikeData data( argv[ 2 ], simil::THDF5, argv[ 3 ]);
+    const auto pairs = data.spikes( ).toPairs( );
+    if( !pairs.empty( ))
+      compression( argv[ 3 ], pairs, pairs.back( ).first, rng );
+  }
+
+  return 0;
+}
@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+// Appends spikes from one writer thread while several readers scan them,
+// checking that readers always see consistent and complete data. Build
+// with -fsanitize=thread to check for data races.
+//
+// With the "late" option some spikes arrive a few batches late and are
+// merged into place, and stored chunks are compacted now and then, so
+// readers run while chunks are replaced and reclaimed. Positions shift
+// under readers in this mode, so they only check the values they read and
+// completeness is checked once the writer has finished.
+//
+// With the "compress" option full chunks are compressed as they fill up,
+// so readers also decode chunks that the writer replaces and frees.
+
+#include <simil/simil.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+  // Spike i has time i * TIME_STEP and gid i, so readers can validate any
+  // value they read.
+  const float TIME_STEP = 0.001f;
+
+  // Late mode holds back one of every LATE_STRIDE spikes for LATE_BATCHES
+  // batches, and compacts the stored spikes every COMPACT_BATCHES batches.
+  const size_t LATE_STRIDE = 7;
+  const size_t LATE_BATCHES = 2;
+  const size_t COMPACT_BATCHES = 64;
+
+  // Elements walked per read guard by the iterator reader.
+  const size_t GUARD_SPAN = 4096;
+
+  float spikeTime( size_t i )
+  {
+    return static_cast< float >( i ) * TIME_STEP;
+  }
+
+  bool lateSpikes = false;
+  bool compressSpikes = false;
+  size_t totalSpikes = 0;
+
+  std::atomic< bool > finished( false );
+  std::atomic< size_t > errors( 0 );
+
+  void report( const std::string& reader, const std::string& message )
+  {
+    if( errors++ < 10 )
+      std::cerr << reader << ": " << message << std::endl;
+  }
+
+  void writer( simil::Spikes& spikes, size_t total, size_t batchSize )
+  {
+    simil::TSpikes batch;
+    std::deque< simil::TSpikes > held;
+    size_t batches = 0;
+    for( size_t first = 0; first < total; first += batchSize )
+    {
+      batch.clear( );
+      simil::TSpikes late;
+      for( size_t i = first; i < std::min( total, first + batchSize ); ++i )
+      {
+        const simil::Spike spike( spikeTime( i ), static_cast< uint32_t >( i ));
+        if( lateSpikes && i % LATE_STRIDE == 0 )
+          late.push_back( spike );
+        else
+          batch.push_back( spike );
+      }
+
+      // Late spikes go after the new ones, so the batch is unsorted too.
+      if( held.size( ) == LATE_BATCHES )
+      {
+        batch.insert( batch.end( ), held.front( ).begin( ),
+                      held.front( ).end( ));
+        held.pop_front( );
+      }
+      held.push_back( std::move( late ));
+
+      spikes.append( batch );
+
+      if( lateSpikes && ++batches % COMPACT_BATCHES == 0 )
+        spikes.compact( );
+    }
+
+    for( const auto& late : held )
+      spikes.append( late );
+
+    finished = true;
+  }
+
+  // Keeps a cursor like SpikesPlayer does and reads the spikes of every
+  // frame through it.
+  void playerReader( const simil::Spikes& spikes )
+  {
+    auto previous = spikes.begin( );
+    std::vector< uint32_t > gids;
+    float now = 0.0f;
+
+    while( !finished || previous.index( ) < spikes.size( ))
+    {
+      now += 0.5f;
+      const size_t snapshot = spikes.size( );
+      const auto current = spikes.begin( ) +
+        spikes.lowerBound( now, previous.index( ));
+
+      spikes.gidsRange( previous.index( ), current.index( ), gids );
+      for( size_t i = 0; i < gids.size( ); ++i )
+        if( lateSpikes ? gids[ i ] >= totalSpikes :
+            gids[ i ] != previous.index( ) + i )
+          report( "player", "unexpected gid " + std::to_string( gids[ i ]));
+
+      if( !lateSpikes && current.index( ) < snapshot &&
+          ( *current ).first < now )
+        report( "player", "cursor behind current time" );
+
+      previous = current;
+    }
+  }
+
+  // Counts spikes per time bin, as the histogram widgets do.
+  void histogramReader( const simil::Spikes& spikes )
+  {
+    const float binWidth = 1.0f;
+    while( !finished )
+    {
+      const size_t snapshot = spikes.size( );
+      if( snapshot == 0 )
+        continue;
+
+      // Late spikes may be stored past the last in order one.
+      const float endTime =
+        spikeTime( lateSpikes ? totalSpikes : snapshot - 1 );
+      size_t counted = 0;
+      for( float start = 0.0f; start <= endTime; start += binWidth )
+        counted += spikes.countBetween( start, start + binWidth );
+
+      // Bins counted while a merge is published may see shifted spikes.
+      if( lateSpikes ? counted > totalSpikes : counted < snapshot )
+        report( "histogram", "wrong count: " + std::to_string( counted ) +
+                " of " + std::to_string( snapshot ));
+    }
+  }
+
+  // Walks the pair view with iterators taken while the container grows,
+  // holding a read guard as chunks may be replaced in late mode.
+  void iteratorReader( const simil::Spikes& spikes )
+  {
+    auto it = spikes.begin( );
+    while( !finished || it != spikes.end( ))
+    {
+      simil::Spikes::ReadGuard guard( spikes );
+      const auto last = std::min( it + GUARD_SPAN, spikes.end( ));
+      for( ; it < last; ++it )
+      {
+        const size_t i = it.index( );
+        const simil::Spike spike = *it;
+        if( lateSpikes ? spike.second >= totalSpikes ||
+                         spike.first != spikeTime( spike.second ) :
+            spike.second != i || spike.first != spikeTime( i ))
+          report( "iterator", "wrong spike at " + std::to_string( i ));
+      }
+    }
+  }
+}
+
+int main( int argc, char** argv )
+{
+  size_t total = 5000000;
+  size_t batchSize = 1000;
+  unsigned int readers = 2;
+
+  if( argc > 1 )
+    total = std::stoul( argv[ 1 ]);
+  if( argc > 2 )
+    batchSize = std::stoul( argv[ 2 ]);
+  if( argc > 3 )
+    readers = std::stoul( argv[ 3 ]);
+  for( int i = 4; i < argc; ++i )
+  {
+    if( std::string( argv[ i ]) == "late" )
+      lateSpikes = true;
+    else if( std::string( argv[ i ]) == "compress" )
+      compressSpikes = true;
+    else
+    {
+      std::cerr << "Usage: " << argv[ 0 ]
+                << " [total [batchSize [readers]]] [late] [compress]"
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  totalSpikes = total;
+
+  simil::Spikes spikes;
+  spikes.setCompression( compressSpikes );
+
+  std::vector< std::thread > threads;
+  for( unsigned int i = 0; i < readers; ++i )
+  {
+    threads.emplace_back( playerReader, std::cref( spikes ));
+    threads.emplace_back( histogramReader, std::cref( spikes ));
+    threads.emplace_back( iteratorReader, std::cref( spikes ));
+  }
+  threads.emplace_back( writer, std::ref( spikes ), total, batchSize );
+
+  for( auto& thread : threads )
+    thread.join( );
+
+  if( spikes.size( ) != total )
+    report( "main", "final size " + std::to_string( spikes.size( )));
+
+  for( size_t i = 0; i < spikes.size( ); ++i )
+  {
+    const simil::Spike spike = spikes.spike( i );
+    if( spike.second != i || spike.first != spikeTime( i ))
+    {
+      report( "main", "wrong final spike at " + std::to_string( i ));
+      break;
+    }
+  }
+
+  std::cout << spikes.size( ) << " spikes appended in batches of "
+            << batchSize << ( lateSpikes ? " with late spikes" : "" )
+            << ( compressSpikes ? " compressed" : "" )
+            << " with " << readers * 3 << " readers, "
+            << errors << " errors." << std::endl;
+
+  return errors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
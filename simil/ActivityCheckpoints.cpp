@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "ActivityCheckpoints.h"
+
+#include <cmath>
+#include <limits>
+
+namespace simil
+{
+  ActivityCheckpoints::ActivityCheckpoints( float interval )
+  : _interval( interval > 0.0f ? interval : 0.0f )
+  , _stop( false )
+  , _building( false )
+  { }
+
+  ActivityCheckpoints::~ActivityCheckpoints( void )
+  {
+    stopBuild( );
+  }
+
+  void ActivityCheckpoints::setInterval( float interval )
+  {
+    clear( );
+    _interval = interval > 0.0f ? interval : 0.0f;
+  }
+
+  bool ActivityCheckpoints::stopBuild( void )
+  {
+    if( !_builder.joinable( ))
+      return false;
+
+    _stop = true;
+    _builder.join( );
+    _stop = false;
+
+    const bool unfinished = _building;
+    _building = false;
+    return unfinished;
+  }
+
+  void ActivityCheckpoints::clear( void )
+  {
+    stopBuild( );
+
+    std::lock_guard< std::mutex > lock( _mutex );
+    _snapshots.clear( );
+  }
+
+  bool ActivityCheckpoints::invalidate( float time )
+  {
+    const bool stopped = stopBuild( );
+
+    // The checkpoint of a slot holds the spikes before the slot time.
+    std::lock_guard< std::mutex > lock( _mutex );
+    for( auto it = _snapshots.begin( ); it != _snapshots.end( ); )
+    {
+      if( it->second.time > time )
+        it = _snapshots.erase( it );
+      else
+        ++it;
+    }
+
+    return stopped;
+  }
+
+  size_t ActivityCheckpoints::size( void ) const
+  {
+    std::lock_guard< std::mutex > lock( _mutex );
+    return _snapshots.size( );
+  }
+
+  int64_t ActivityCheckpoints::slotOf( float time ) const
+  {
+    const double slot = std::floor( static_cast< double >( time ) / _interval );
+    if( !( std::abs( slot ) < static_cast< double >(
+           std::numeric_limits< int32_t >::max( ))))
+      return std::numeric_limits< int64_t >::min( );
+
+    return static_cast< int64_t >( slot );
+  }
+
+  void ActivityCheckpoints::seek( NeuronActivity& activity, float time,
+                                  const SpikeColumns& spikes,
+                                  const NeuronIndex& index )
+  {
+    const int64_t slot = _interval > 0.0f ? slotOf( time ) :
+      std::numeric_limits< int64_t >::min( );
+    if( slot == std::numeric_limits< int64_t >::min( ))
+    {
+      activity.rebuild( time, spikes, index );
+      return;
+    }
+
+    const float slotTime = static_cast< float >( slot * double( _interval ));
+
+    // The buffer itself is a better start than an older checkpoint when it
+    // is still before the checkpoint time.
+    bool saved = false;
+    {
+      std::lock_guard< std::mutex > lock( _mutex );
+      auto it = _snapshots.upper_bound( slot );
+      if( it != _snapshots.begin( ))
+      {
+        --it;
+        saved = it->first == slot;
+        if( saved || !activity.valid( ) || activity.time( ) > slotTime ||
+            activity.time( ) < it->second.time )
+          activity.restore( it->second, index.size( ));
+      }
+    }
+
+    if( !saved )
+    {
+      // advance( ) falls back to a rebuild when that is cheaper.
+      if( activity.valid( ) && activity.time( ) <= slotTime )
+        activity.advance( slotTime, spikes,
+                          spikes.lowerBound( activity.time( )),
+                          spikes.lowerBound( slotTime ), index );
+      else
+        activity.rebuild( slotTime, spikes, index );
+
+      NeuronActivity::Snapshot snapshot;
+      activity.save( snapshot );
+
+      std::lock_guard< std::mutex > lock( _mutex );
+      _snapshots.emplace( slot, std::move( snapshot ));
+    }
+
+    activity.advance( time, spikes, spikes.lowerBound( slotTime ),
+                      spikes.lowerBound( time ), index );
+  }
+
+  void ActivityCheckpoints::buildAsync( const NeuronActivity& model,
+                                        float startTime, float endTime,
+                                        const SpikeColumns& spikes,
+                                        const NeuronIndex& index )
+  {
+    stopBuild( );
+    if( !( _interval > 0.0f ) || endTime < startTime )
+      return;
+
+    const int64_t first = slotOf( startTime );
+    const int64_t last = slotOf( endTime );
+    if( first == std::numeric_limits< int64_t >::min( ) ||
+        last == std::numeric_limits< int64_t >::min( ))
+      return;
+
+    const float interval = _interval;
+    _building = true;
+    _builder = std::thread(
+      [ this, first, last, interval, &spikes ]( NeuronActivity activity,
+                                                NeuronIndex neurons )
+      {
+        for( int64_t slot = first; slot <= last && !_stop; ++slot )
+        {
+          // Guarded per slot, so the writer can reclaim chunks meanwhile.
+          const SpikeColumns::ReadGuard guard( spikes );
+
+          const float time = static_cast< float >( slot * double( interval ));
+          {
+            std::lock_guard< std::mutex > lock( _mutex );
+            const auto it = _snapshots.find( slot );
+            if( it != _snapshots.end( ))
+            {
+              activity.restore( it->second, neurons.size( ));
+              continue;
+            }
+          }
+
+          if( !activity.valid( ))
+            activity.rebuild( time, spikes, neurons );
+          else
+            activity.advance( time, spikes, spikes.lowerBound( activity.time( )),
+                              spikes.lowerBound( time ), neurons );
+
+          std::lock_guard< std::mutex > lock( _mutex );
+          if( _snapshots.count( slot ) == 0 )
+            activity.save( _snapshots[ slot ]);
+        }
+
+        if( !_stop )
+          _building = false;
+      },
+      NeuronActivity( model.model( ), model.duration( )), index );
+  }
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef __SIMIL_ACTIVITYCHECKPOINTS_H__
+#define __SIMIL_ACTIVITYCHECKPOINTS_H__
+
+#include "NeuronActivity.h"
+#include <simil/api.h>
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace simil
+{
+  /** \class ActivityCheckpoints
+   * \brief Snapshots of a NeuronActivity buffer at every multiple of a time
+   * interval, so seeking restores the closest earlier one and only replays
+   * the spikes after it.
+   *
+   * The snapshot of an interval is saved the first time a seek lands in
+   * it, or ahead of time by a background build. Snapshots only keep the
+   * active neurons. They are only valid for one decay model, neuron index
+   * and set of spikes, and must be cleared when any of them changes. When
+   * spikes are added, only the checkpoints after them are dropped.
+   *
+   */
+  class SIMIL_API ActivityCheckpoints
+  {
+  public:
+
+    /** \brief ActivityCheckpoints class constructor.
+     * \param[in] interval Time between checkpoints, zero to disable them.
+     *
+     */
+    ActivityCheckpoints( float interval = 0.0f );
+
+    ActivityCheckpoints( const ActivityCheckpoints& ) = delete;
+    ActivityCheckpoints& operator=( const ActivityCheckpoints& ) = delete;
+
+    ~ActivityCheckpoints( void );
+
+    /** \brief Changes the time between checkpoints, dropping the current
+     * ones.
+     * \param[in] interval Time between checkpoints, zero to disable them.
+     *
+     */
+    void setInterval( float interval );
+
+    float interval( void ) const
+    {
+      return _interval;
+    }
+
+    /** \brief Drops every checkpoint, stopping the background build first.
+     *
+     */
+    void clear( void );
+
+    /** \brief Drops the checkpoints taken after the given time, for spikes
+     * added at that time. A background build is stopped first, and can be
+     * started again to resume from the last checkpoint kept.
+     * \param[in] time Time of the earliest added spike.
+     * \return True if an unfinished background build was stopped.
+     *
+     */
+    bool invalidate( float time );
+
+    /** \brief Returns the number of saved checkpoints.
+     *
+     */
+    size_t size( void ) const;
+
+    /** \brief Brings the activity to the given time from the checkpoint of
+     * its interval, saving that checkpoint first if it is missing.
+     * Without interval the activity is rebuilt.
+     * \param[in,out] activity Activity buffer.
+     * \param[in] time Time to seek to.
+     * \param[in] spikes Spike columns.
+     * \param[in] index Dense index of the neurons.
+     *
+     */
+    void seek( NeuronActivity& activity, float time,
+               const SpikeColumns& spikes, const NeuronIndex& index );
+
+    /** \brief Saves the missing checkpoints of [startTime, endTime] in a
+     * background thread, with its own copies of the decay model and of the
+     * neuron index. Existing checkpoints are restored instead of computed.
+     * The spikes must not be replaced until the build ends or clear( ) is
+     * called, and invalidate( ) must be called when spikes are added.
+     * \param[in] model Activity whose decay model is used.
+     * \param[in] startTime Start of the range.
+     * \param[in] endTime End of the range.
+     * \param[in] spikes Spike columns.
+     * \param[in] index Dense index of the neurons.
+     *
+     */
+    void buildAsync( const NeuronActivity& model, float startTime,
+                     float endTime, const SpikeColumns& spikes,
+                     const NeuronIndex& index );
+
+  protected:
+
+    int64_t slotOf( float time ) const;
+
+    /** \brief Stops the background build. Returns true if it had not
+     * finished.
+     *
+     */
+    bool stopBuild( void );
+
+    float _interval;
+
+    mutable std::mutex _mutex;
+    std::map< int64_t, NeuronActivity::Snapshot > _snapshots;
+
+    std::thread _builder;
+    std::atomic< bool > _stop;
+    std::atomic< bool > _building;
+  };
+}
+
+#endif /* __SIMIL_ACTIVITYCHECKPOINTS_H__ */
@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "ActivityPyramid.h"
+#include "Parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace simil
+{
+  ActivityPyramid::ActivityPyramid( void )
+  : _startTime( 0.0f )
+  , _binWidth( 1.0f )
+  , _invBinWidth( 1.0f )
+  , _levels( 1 )
+  { }
+
+  ActivityPyramid::ActivityPyramid( const SpikeColumns& spikes,
+                                    float startTime, float endTime,
+                                    std::shared_ptr< const GIDFilter > gids )
+  : _startTime( startTime )
+  , _levels( 1 )
+  , _gids( std::move( gids ))
+  {
+    // Without a usable range, bins are sized after the time magnitude.
+    const float range = endTime - startTime;
+    _binWidth = range / BASE_BINS > std::numeric_limits< float >::min( ) ?
+      range / BASE_BINS : std::max( std::abs( startTime ) * 1e-6f, 1e-6f );
+    _invBinWidth = 1.0f / _binWidth;
+
+    // One guard covers the worker threads, which finish before it ends.
+    const SpikeColumns::ReadGuard guard( spikes );
+
+    const size_t size = spikes.size( );
+    if( size == 0 )
+      return;
+
+    // Data may run far beyond the expected end time.
+    const float lastTime = spikes.time( size - 1 );
+    if( binOf( lastTime ) >= MAX_BINS )
+    {
+      _binWidth = ( lastTime - startTime ) / BASE_BINS;
+      _invBinWidth = 1.0f / _binWidth;
+    }
+    const size_t numBins = binOf( lastTime ) + 1;
+
+    const unsigned int threads = parallel::threadCount( size );
+    std::vector< std::vector< uint32_t >> counts( threads );
+
+    parallel::forRanges( size, threads,
+      [ & ]( unsigned int t, size_t begin, size_t end )
+      {
+        auto& local = counts[ t ];
+        local.assign( numBins, 0 );
+        while( begin < end )
+        {
+          const auto run = spikes.run( begin, end );
+          for( size_t i = 0; i < run.size; ++i )
+            if( !_gids || _gids->contains( run.gids[ i ]))
+              ++local[ std::min( binOf( run.times[ i ]), numBins - 1 )];
+
+          begin += run.size;
+        }
+      });
+
+    auto& base = _levels[ 0 ];
+    base.swap( counts[ 0 ]);
+    parallel::forRanges( numBins, threads,
+      [ & ]( unsigned int, size_t begin, size_t end )
+      {
+        for( size_t t = 1; t < counts.size( ); ++t )
+          for( size_t b = begin; b < end; ++b )
+            base[ b ] += counts[ t ][ b ];
+      });
+
+    update( 0, numBins - 1 );
+  }
+
+  size_t ActivityPyramid::binOf( float time ) const
+  {
+    // Spikes before the start time fall in the first bin.
+    const float bin = ( time - _startTime ) * _invBinWidth;
+    if( !( bin > 0.0f ))
+      return 0;
+
+    return bin < static_cast< float >( MAX_BINS ) * MAX_BINS ?
+      static_cast< size_t >( bin ) : size_t( MAX_BINS ) * MAX_BINS;
+  }
+
+  void ActivityPyramid::coarsen( void )
+  {
+    if( _levels.size( ) == 1 )
+    {
+      const auto& base = _levels[ 0 ];
+      std::vector< uint32_t > upper(( base.size( ) + 1 ) / 2, 0 );
+      for( size_t b = 0; b < base.size( ); ++b )
+        upper[ b / 2 ] += base[ b ];
+      _levels.push_back( std::move( upper ));
+    }
+
+    _levels.erase( _levels.begin( ));
+    _binWidth *= 2.0f;
+    _invBinWidth = 1.0f / _binWidth;
+  }
+
+  void ActivityPyramid::add( const TSpikes& spikes )
+  {
+    size_t first = std::numeric_limits< size_t >::max( );
+    size_t last = 0;
+
+    for( const auto& spike : spikes )
+    {
+      if( _gids && !_gids->contains( spike.second ))
+        continue;
+
+      size_t bin = binOf( spike.first );
+      if( bin >= MAX_BINS )
+      {
+        // Level 1 becomes the base, so it must hold the spikes counted
+        // so far before level 0 is dropped.
+        if( first <= last )
+          update( first, last );
+        first = std::numeric_limits< size_t >::max( );
+        last = 0;
+
+        while( bin >= MAX_BINS )
+        {
+          coarsen( );
+          bin = binOf( spike.first );
+        }
+      }
+
+      auto& base = _levels[ 0 ];
+      if( bin >= base.size( ))
+        base.resize( bin + 1, 0 );
+
+      ++base[ bin ];
+      first = std::min( first, bin );
+      last = std::max( last, bin );
+    }
+
+    if( first <= last )
+      update( first, last );
+  }
+
+  void ActivityPyramid::update( size_t first, size_t last )
+  {
+    size_t l = 1;
+    for( ; _levels[ l - 1 ].size( ) > 1; ++l )
+    {
+      if( l == _levels.size( ))
+        _levels.emplace_back( );
+
+      const auto& lower = _levels[ l - 1 ];
+      auto& upper = _levels[ l ];
+      const size_t size = upper.size( );
+      upper.resize(( lower.size( ) + 1 ) / 2, 0 );
+
+      first >>= 1;
+      last = std::min( last >> 1, upper.size( ) - 1 );
+
+      // Bins added to this level, and its old last bin, may cover lower
+      // bins counted before.
+      if( upper.size( ) > size )
+      {
+        first = std::min( first, size > 0 ? size - 1 : 0 );
+        last = upper.size( ) - 1;
+      }
+      for( size_t b = first; b <= last; ++b )
+      {
+        const size_t child = b * 2;
+        upper[ b ] = lower[ child ] +
+          ( child + 1 < lower.size( ) ? lower[ child + 1 ] : 0 );
+      }
+    }
+
+    // Levels above a single bin are left over from before a coarsen( ).
+    _levels.resize( l );
+  }
+
+  std::vector< float > ActivityPyramid::histogram( float startTime,
+                                                   float endTime,
+                                                   size_t bins ) const
+  {
+    std::vector< float > result( bins, 0.0f );
+    if( bins == 0 || endTime <= startTime )
+      return result;
+
+    const float width = ( endTime - startTime ) / bins;
+
+    size_t index = 0;
+    while( index + 1 < _levels.size( ) && binWidth( index + 1 ) <= width )
+      ++index;
+
+    const auto& counts = _levels[ index ];
+    const float levelWidth = binWidth( index );
+
+    const float firstBin = std::floor(( startTime - _startTime ) / levelWidth );
+    const size_t first = firstBin > 0.0f ? static_cast< size_t >( firstBin ) : 0;
+    const size_t last = std::min( counts.size( ), static_cast< size_t >(
+      std::max( 0.0f, std::ceil(( endTime - _startTime ) / levelWidth ))));
+
+    const float invWidth = 1.0f / width;
+    for( size_t b = first; b < last; ++b )
+    {
+      if( counts[ b ] == 0 )
+        continue;
+
+      const float binStart = _startTime + b * levelWidth;
+      const float binEnd = binStart + levelWidth;
+      const float density = counts[ b ] / levelWidth;
+
+      // Spread the bin over the result bins it overlaps.
+      float from = std::max( binStart, startTime );
+      const float to = std::min( binEnd, endTime );
+      size_t target = std::min( static_cast< size_t >(
+        std::max( 0.0f, ( from - startTime ) * invWidth )), bins - 1 );
+      while( from < to )
+      {
+        const float targetEnd = target + 1 < bins ?
+          startTime + ( target + 1 ) * width : endTime;
+        const float until = std::min( to, targetEnd );
+        result[ target ] += ( until - from ) * density;
+        from = until;
+        if( target + 1 == bins )
+          break;
+        ++target;
+      }
+    }
+
+    return result;
+  }
+}
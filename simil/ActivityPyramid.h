@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef __SIMIL_ACTIVITYPYRAMID_H__
+#define __SIMIL_ACTIVITYPYRAMID_H__
+
+#include "types.h"
+#include "GIDFilter.h"
+#include "SpikeColumns.h"
+#include <simil/api.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace simil
+{
+  /** \class ActivityPyramid
+   * \brief Spike counts per time bin at power of two resolutions. Level 0
+   * has the finest bins and each level above halves the number of bins,
+   * so a histogram of any size is computed from the level whose bins are
+   * closest to, but not wider than, the requested ones.
+   *
+   * Counts can be limited to a set of gids and updated with new spikes in
+   * any time order. When a spike falls past MAX_BINS level 0 bins the
+   * finest level is dropped, doubling the base bin width.
+   *
+   */
+  class SIMIL_API ActivityPyramid
+  {
+  public:
+
+    enum : size_t
+    {
+      BASE_BINS = 1 << 20,
+      MAX_BINS = 1 << 22
+    };
+
+    ActivityPyramid( void );
+
+    /** \brief Builds the pyramid from the given spikes using several
+     * threads.
+     * \param[in] spikes Time sorted spikes.
+     * \param[in] startTime Start time of the first bin.
+     * \param[in] endTime Expected end time, used to choose the bin width.
+     * \param[in] gids Gids whose spikes are counted, nullptr for all.
+     *
+     */
+    ActivityPyramid( const SpikeColumns& spikes, float startTime,
+                     float endTime,
+                     std::shared_ptr< const GIDFilter > gids = nullptr );
+
+    /** \brief Counts the given spikes, which may be in any order.
+     * \param[in] spikes Spikes to add.
+     *
+     */
+    void add( const TSpikes& spikes );
+
+    /** \brief Returns the number of spikes in each of the given number of
+     * equal bins of the [startTime, endTime) window. Pyramid bins that
+     * straddle two result bins are split proportionally.
+     * \param[in] startTime Window start time.
+     * \param[in] endTime Window end time.
+     * \param[in] bins Number of result bins.
+     *
+     */
+    std::vector< float > histogram( float startTime, float endTime,
+                                    size_t bins ) const;
+
+    size_t levels( void ) const
+    {
+      return _levels.size( );
+    }
+
+    /** \brief Returns the counts of the given level.
+     *
+     */
+    const std::vector< uint32_t >& level( size_t index ) const
+    {
+      return _levels[ index ];
+    }
+
+    float binWidth( size_t index ) const
+    {
+      return _binWidth * static_cast< float >( size_t( 1 ) << index );
+    }
+
+    float startTime( void ) const
+    {
+      return _startTime;
+    }
+
+  protected:
+
+    size_t binOf( float time ) const;
+
+    /** \brief Drops level 0, doubling the base bin width.
+     *
+     */
+    void coarsen( void );
+
+    /** \brief Resizes the upper levels to level 0 and recomputes them over
+     * the [first, last] range of level 0 bins.
+     *
+     */
+    void update( size_t first, size_t last );
+
+    float _startTime;
+    float _binWidth;
+    float _invBinWidth;
+
+    std::vector< std::vector< uint32_t >> _levels;
+
+    std::shared_ptr< const GIDFilter > _gids;
+  };
+}
+
+#endif /* __SIMIL_ACTIVITYPYRAMID_H__ */
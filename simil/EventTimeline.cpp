@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "EventTimeline.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+  template< typename Interval >
+  float buildMaxEnd( const std::vector< Interval >& intervals,
+                     std::vector< float >& maxEnd, size_t first, size_t last )
+  {
+    if( first >= last )
+      return -std::numeric_limits< float >::infinity( );
+
+    const size_t middle = ( first + last ) / 2;
+    maxEnd[ middle ] = std::max({ intervals[ middle ].end,
+                                  buildMaxEnd( intervals, maxEnd, first,
+                                               middle ),
+                                  buildMaxEnd( intervals, maxEnd, middle + 1,
+                                               last )});
+    return maxEnd[ middle ];
+  }
+}
+
+namespace simil
+{
+  EventTimeline::EventTimeline( void )
+  : _eventOffsets( 1, 0 )
+  { }
+
+  EventTimeline::EventTimeline( const EventMap& events )
+  : _eventOffsets( 1, 0 )
+  {
+    for( const auto& event : events )
+    {
+      const auto number = static_cast< uint32_t >( _names.size( ));
+      _names.push_back( event.first );
+      for( const auto& frame : event.second )
+        _intervals.push_back({ frame.first, frame.second, number });
+
+      _eventFrames.insert( _eventFrames.end( ), event.second.begin( ),
+                           event.second.end( ));
+      _eventOffsets.push_back( _eventFrames.size( ));
+    }
+
+    std::sort( _intervals.begin( ), _intervals.end( ),
+      []( const Interval& a, const Interval& b ){ return a.start < b.start; });
+
+    _maxEnd.resize( _intervals.size( ));
+    buildMaxEnd( _intervals, _maxEnd, 0, _intervals.size( ));
+  }
+
+  void EventTimeline::collect( size_t first, size_t last, float maxStart,
+                               bool includeMaxStart, float minEnd,
+                               std::vector< uint32_t >& result ) const
+  {
+    if( first >= last )
+      return;
+
+    const size_t middle = ( first + last ) / 2;
+    if( _maxEnd[ middle ] <= minEnd )
+      return;
+
+    collect( first, middle, maxStart, includeMaxStart, minEnd, result );
+
+    // Everything from here on starts too late.
+    const Interval& interval = _intervals[ middle ];
+    if( includeMaxStart ? interval.start > maxStart :
+                          interval.start >= maxStart )
+      return;
+
+    if( interval.end > minEnd )
+      result.push_back( interval.event );
+
+    collect( middle + 1, last, maxStart, includeMaxStart, minEnd, result );
+  }
+
+  std::vector< uint32_t > EventTimeline::activeAt( float time ) const
+  {
+    std::vector< uint32_t > result;
+    collect( 0, _intervals.size( ), time, true, time, result );
+
+    std::sort( result.begin( ), result.end( ));
+    result.erase( std::unique( result.begin( ), result.end( )), result.end( ));
+    return result;
+  }
+
+  std::vector< uint32_t > EventTimeline::activeBetween( float startTime,
+                                                        float endTime ) const
+  {
+    std::vector< uint32_t > result;
+    if( endTime <= startTime )
+      return result;
+
+    collect( 0, _intervals.size( ), endTime, false, startTime, result );
+
+    std::sort( result.begin( ), result.end( ));
+    result.erase( std::unique( result.begin( ), result.end( )), result.end( ));
+    return result;
+  }
+
+  void EventTimeline::activity( uint32_t event, float deltaTime, size_t bins,
+                                std::vector< float >& coverage,
+                                std::vector< int >& full,
+                                std::vector< bool >& result ) const
+  {
+    // Boundary bins get their exact overlap; the bins in between are fully
+    // covered and are counted with a difference array.
+    coverage.assign( bins, 0.0f );
+    full.assign( bins + 1, 0 );
+
+    const double invDeltaTime = 1.0 / deltaTime;
+    const auto overlap = [ deltaTime ]( size_t bin, const Event& frame )
+    {
+      return std::min( ( bin + 1 ) * deltaTime, frame.second ) -
+             std::max( bin * deltaTime, frame.first );
+    };
+
+    for( size_t i = _eventOffsets[ event ]; i < _eventOffsets[ event + 1 ]; ++i )
+    {
+      const Event& frame = _eventFrames[ i ];
+      const double firstBin =
+        std::max( std::floor( frame.first * invDeltaTime ), 0.0 );
+      const double endBin = std::min( std::ceil( frame.second * invDeltaTime ),
+                                      static_cast< double >( bins ));
+      if( !( firstBin < endBin ))
+        continue;
+
+      const auto first = static_cast< size_t >( firstBin );
+      const auto last = static_cast< size_t >( endBin ) - 1;
+      coverage[ first ] += overlap( first, frame );
+      if( last > first )
+      {
+        coverage[ last ] += overlap( last, frame );
+        ++full[ first + 1 ];
+        --full[ last ];
+      }
+    }
+
+    const float threshold = deltaTime * 0.5f;
+    result.assign( bins, false );
+    int covering = 0;
+    for( size_t bin = 0; bin < bins; ++bin )
+    {
+      covering += full[ bin ];
+      result[ bin ] = coverage[ bin ] + covering * deltaTime >= threshold;
+    }
+  }
+
+  std::vector< bool > EventTimeline::activity( uint32_t event, float deltaTime,
+                                               float totalTime ) const
+  {
+    std::vector< bool > result;
+    if( event >= _names.size( ) || !( deltaTime > 0.0f ))
+      return result;
+
+    const auto bins = static_cast< size_t >(
+      std::max( std::ceil( totalTime * ( 1.0 / deltaTime )), 0.0 ));
+    std::vector< float > coverage;
+    std::vector< int > full;
+    activity( event, deltaTime, bins, coverage, full, result );
+    return result;
+  }
+
+  std::vector< std::vector< bool >>
+  EventTimeline::activity( float deltaTime, float totalTime ) const
+  {
+    std::vector< std::vector< bool >> result( _names.size( ));
+    if( !( deltaTime > 0.0f ))
+      return result;
+
+    const auto bins = static_cast< size_t >(
+      std::max( std::ceil( totalTime * ( 1.0 / deltaTime )), 0.0 ));
+    std::vector< float > coverage;
+    std::vector< int > full;
+    for( uint32_t event = 0; event < _names.size( ); ++event )
+      activity( event, deltaTime, bins, coverage, full, result[ event ]);
+    return result;
+  }
+}
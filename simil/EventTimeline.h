@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef __SIMIL_EVENTTIMELINE_H__
+#define __SIMIL_EVENTTIMELINE_H__
+
+#include "types.h"
+#include <simil/api.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace simil
+{
+  /** \class EventTimeline
+   * \brief Index of the time frames of a set of events.
+   *
+   * Time frames are kept sorted by start time as an implicit binary tree
+   * where every node stores the latest end of its subtree, so the frames
+   * active at a time or in a window are found without scanning the frames
+   * that ended before it. A time frame [start, end) is active at t if
+   * start <= t < end. Events are numbered in name order.
+   *
+   */
+  class SIMIL_API EventTimeline
+  {
+  public:
+
+    EventTimeline( void );
+
+    /** \brief EventTimeline class constructor.
+     * \param[in] events Time frames of each event.
+     *
+     */
+    explicit EventTimeline( const EventMap& events );
+
+    /** \brief Returns the names of the events, indexed by event number.
+     *
+     */
+    const std::vector< std::string >& names( void ) const
+    {
+      return _names;
+    }
+
+    size_t numEvents( void ) const
+    {
+      return _names.size( );
+    }
+
+    /** \brief Returns the sorted numbers of the events active at the given
+     * time.
+     * \param[in] time Time to query.
+     *
+     */
+    std::vector< uint32_t > activeAt( float time ) const;
+
+    /** \brief Returns the sorted numbers of the events active at some point
+     * of the [startTime, endTime) window.
+     * \param[in] startTime Start of the window.
+     * \param[in] endTime End of the window.
+     *
+     */
+    std::vector< uint32_t > activeBetween( float startTime,
+                                           float endTime ) const;
+
+    /** \brief Returns, for each bin of deltaTime, whether the event covers
+     * at least half of it.
+     * \param[in] event Event number.
+     * \param[in] deltaTime Bin size.
+     * \param[in] totalTime Time covered by the bins.
+     *
+     */
+    std::vector< bool > activity( uint32_t event, float deltaTime,
+                                  float totalTime ) const;
+
+    /** \brief Returns the activity bins of every event, indexed by event
+     * number.
+     * \param[in] deltaTime Bin size.
+     * \param[in] totalTime Time covered by the bins.
+     *
+     */
+    std::vector< std::vector< bool >> activity( float deltaTime,
+                                                float totalTime ) const;
+
+  private:
+    struct Interval
+    {
+      float start;
+      float end;
+      uint32_t event;
+    };
+
+    void collect( size_t first, size_t last, float maxStart,
+                  bool includeMaxStart, float minEnd,
+                  std::vector< uint32_t >& result ) const;
+
+    void activity( uint32_t event, float deltaTime, size_t bins,
+                   std::vector< float >& coverage, std::vector< int >& full,
+                   std::vector< bool >& result ) const;
+
+    std::vector< std::string > _names;
+
+    // Sorted by start, with the latest end of each implicit subtree.
+    std::vector< Interval > _intervals;
+    std::vector< float > _maxEnd;
+
+    // Time frames grouped by event.
+    std::vector< Event > _eventFrames;
+    std::vector< size_t > _eventOffsets;
+  };
+}
+
+#endif /* __SIMIL_EVENTTIMELINE_H__ */
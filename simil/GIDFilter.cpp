@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "GIDFilter.h"
+#include "SubsetEventManager.h"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+namespace simil
+{
+  GIDFilter::GIDFilter( void )
+  : _size( 0 )
+  { }
+
+  GIDFilter::GIDFilter( const TGIDSet& gids )
+  : _size( 0 )
+  {
+    if( !gids.empty( ))
+      _bits.resize(( size_t( gids.last( )) >> 6 ) + 1, 0 );
+
+    for( const auto gid : gids )
+      add( gid );
+  }
+
+  GIDFilter::GIDFilter( const GIDVec& gids )
+  : _size( 0 )
+  {
+    const auto last = std::max_element( gids.cbegin( ), gids.cend( ));
+    if( last != gids.cend( ))
+      _bits.resize(( size_t( *last ) >> 6 ) + 1, 0 );
+
+    for( const auto gid : gids )
+      add( gid );
+  }
+
+  GIDFilter::GIDFilter( const SubsetEventManager& subsets,
+                        const std::vector< std::string >& names )
+  : _size( 0 )
+  {
+    for( const auto& name : names )
+    {
+      if( !subsets.hasSubset( name ))
+      {
+        const std::string errorText = "GIDFilter: subset " + name +
+          " NOT found.";
+        std::cerr << "EXCEPTION: " << errorText << " -> " << __FILE__ << ":"
+                  << __LINE__ << std::endl;
+        throw std::runtime_error( errorText );
+      }
+
+      for( const auto gid : subsets.subsetGIDs( name ))
+        add( gid );
+    }
+  }
+
+  void GIDFilter::add( uint32_t gid )
+  {
+    const size_t word = gid >> 6;
+    if( word >= _bits.size( ))
+      _bits.resize( word + 1, 0 );
+
+    const uint64_t bit = uint64_t( 1 ) << ( gid & 63 );
+    _size += ( _bits[ word ] & bit ) == 0;
+    _bits[ word ] |= bit;
+  }
+
+  bool GIDFilter::containsAny( uint32_t first, uint32_t last ) const
+  {
+    if( first >= last )
+      return false;
+
+    const size_t firstWord = first >> 6;
+    const size_t lastWord = std::min( size_t( last - 1 ) >> 6,
+                                      _bits.size( ) - 1 );
+    if( _bits.empty( ) || firstWord > lastWord )
+      return false;
+
+    for( size_t word = firstWord; word <= lastWord; ++word )
+    {
+      uint64_t bits = _bits[ word ];
+      if( word == firstWord )
+        bits &= ~uint64_t( 0 ) << ( first & 63 );
+      if( word == ( size_t( last - 1 ) >> 6 ))
+        bits &= ~uint64_t( 0 ) >> ( 63 - (( last - 1 ) & 63 ));
+      if( bits )
+        return true;
+    }
+
+    return false;
+  }
+
+  size_t GIDFilter::size( void ) const
+  {
+    return _size;
+  }
+
+  bool GIDFilter::empty( void ) const
+  {
+    return _size == 0;
+  }
+
+  GIDVec GIDFilter::gids( void ) const
+  {
+    GIDVec result;
+    result.reserve( _size );
+    for( size_t word = 0; word < _bits.size( ); ++word )
+    {
+      if( _bits[ word ] == 0 )
+        continue;
+
+      for( uint32_t bit = 0; bit < 64; ++bit )
+        if(( _bits[ word ] >> bit ) & 1 )
+          result.push_back( static_cast< uint32_t >(( word << 6 ) + bit ));
+    }
+
+    return result;
+  }
+
+  void GIDFilter::filter( TSpikes& spikes ) const
+  {
+    spikes.erase( std::remove_if( spikes.begin( ), spikes.end( ),
+      [ this ]( const Spike& spike ){ return !contains( spike.second ); }),
+      spikes.end( ));
+  }
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef __SIMIL_GIDFILTER_H__
+#define __SIMIL_GIDFILTER_H__
+
+#include "types.h"
+#include <simil/api.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace simil
+{
+  class SubsetEventManager;
+
+  /** \class GIDFilter
+   * \brief Dense bitmap of the gids to keep when loading activity. Loaders
+   * test each spike against it before storing it, so rejected spikes take
+   * no memory.
+   *
+   * An empty filter accepts no gid. Code taking an optional filter uses a
+   * null pointer to accept every gid.
+   *
+   */
+  class SIMIL_API GIDFilter
+  {
+  public:
+    /** \brief GIDFilter class constructor, accepts no gid.
+     *
+     */
+    GIDFilter( void );
+
+    /** \brief GIDFilter class constructor.
+     * \param[in] gids Gids to accept.
+     *
+     */
+    GIDFilter( const TGIDSet& gids );
+
+    /** \brief GIDFilter class constructor.
+     * \param[in] gids Gids to accept.
+     *
+     */
+    GIDFilter( const GIDVec& gids );
+
+    /** \brief GIDFilter class constructor from subsets. Throws
+     * std::runtime_error if a name is not a subset of the manager.
+     * \param[in] subsets Subset event manager with the subsets.
+     * \param[in] names Names of the subsets whose gids are accepted.
+     *
+     */
+    GIDFilter( const SubsetEventManager& subsets,
+               const std::vector< std::string >& names );
+
+    /** \brief Accepts the given gid.
+     * \param[in] gid Gid to accept.
+     *
+     */
+    void add( uint32_t gid );
+
+    /** \brief Returns true if the gid is accepted.
+     * \param[in] gid Gid to test.
+     *
+     */
+    bool contains( uint32_t gid ) const
+    {
+      const size_t word = gid >> 6;
+      return word < _bits.size( ) && (( _bits[ word ] >> ( gid & 63 )) & 1 );
+    }
+
+    /** \brief Returns true if any gid in [first, last) is accepted.
+     * \param[in] first First gid of the range.
+     * \param[in] last End of the range.
+     *
+     */
+    bool containsAny( uint32_t first, uint32_t last ) const;
+
+    /** \brief Returns the number of accepted gids.
+     *
+     */
+    size_t size( void ) const;
+
+    /** \brief Returns true if no gid is accepted.
+     *
+     */
+    bool empty( void ) const;
+
+    /** \brief Returns the accepted gids, in increasing order.
+     *
+     */
+    GIDVec gids( void ) const;
+
+    /** \brief Removes the spikes of rejected gids, keeping the order of the
+     * rest.
+     * \param[in,out] spikes Spikes to filter.
+     *
+     */
+    void filter( TSpikes& spikes ) const;
+
+  private:
+    std::vector< uint64_t > _bits;
+    size_t _size;
+  };
+}
+
+#endif /* __SIMIL_GIDFILTER_H__ */
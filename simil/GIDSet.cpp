@@ -0,0 +1,816 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "GIDSet.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+  constexpr size_t ARRAY_MAX = 4096;
+  constexpr size_t BITMAP_WORDS = 1024;
+
+  inline unsigned int popcount( uint64_t word )
+  {
+    word = word - (( word >> 1 ) & 0x5555555555555555ull );
+    word = ( word & 0x3333333333333333ull ) +
+           (( word >> 2 ) & 0x3333333333333333ull );
+    word = ( word + ( word >> 4 )) & 0x0F0F0F0F0F0F0F0Full;
+    return static_cast< unsigned int >(( word * 0x0101010101010101ull ) >> 56 );
+  }
+
+  inline unsigned int lowestBit( uint64_t word )
+  {
+    return popcount(( word & ( ~word + 1 )) - 1 );
+  }
+
+  inline unsigned int highestBit( uint64_t word )
+  {
+    unsigned int bit = 63;
+    while(( word >> bit ) == 0 )
+      --bit;
+    return bit;
+  }
+
+  /** Sets the bits [first, last]. */
+  void setRange( uint64_t* bits, unsigned int first, unsigned int last )
+  {
+    const unsigned int firstWord = first >> 6;
+    const unsigned int lastWord = last >> 6;
+    const uint64_t firstMask = ~uint64_t( 0 ) << ( first & 63 );
+    const uint64_t lastMask = ~uint64_t( 0 ) >> ( 63 - ( last & 63 ));
+
+    if( firstWord == lastWord )
+    {
+      bits[ firstWord ] |= firstMask & lastMask;
+      return;
+    }
+
+    bits[ firstWord ] |= firstMask;
+    for( unsigned int word = firstWord + 1; word < lastWord; ++word )
+      bits[ word ] = ~uint64_t( 0 );
+    bits[ lastWord ] |= lastMask;
+  }
+}
+
+namespace simil
+{
+  /** Operations on a single container. Run containers store pairs of
+   * start and length minus one in values. */
+  struct GIDSet::Containers
+  {
+    typedef uint64_t Bits[ BITMAP_WORDS ];
+
+    static size_t runCount( const Container& c )
+    {
+      return c.values.size( ) / 2;
+    }
+
+    /** Index of the last run starting at or before low, or runCount( c ) if
+     * there is none. */
+    static size_t findRun( const Container& c, uint16_t low )
+    {
+      size_t lower = 0;
+      size_t upper = runCount( c );
+      while( lower < upper )
+      {
+        const size_t middle = ( lower + upper ) / 2;
+        if( c.values[ 2 * middle ] <= low )
+          lower = middle + 1;
+        else
+          upper = middle;
+      }
+      return lower == 0 ? runCount( c ) : lower - 1;
+    }
+
+    static bool contains( const Container& c, uint16_t low )
+    {
+      switch( c.type )
+      {
+        case ARRAY:
+          return std::binary_search( c.values.begin( ), c.values.end( ), low );
+        case BITMAP:
+          return ( c.bits[ low >> 6 ] >> ( low & 63 )) & 1;
+        case RUNS:
+        {
+          const size_t run = findRun( c, low );
+          return run < runCount( c ) &&
+                 low - c.values[ 2 * run ] <= c.values[ 2 * run + 1 ];
+        }
+      }
+      return false;
+    }
+
+    static uint16_t first( const Container& c )
+    {
+      if( c.type != BITMAP )
+        return c.values.front( );
+
+      size_t word = 0;
+      while( c.bits[ word ] == 0 )
+        ++word;
+      return static_cast< uint16_t >( word * 64 + lowestBit( c.bits[ word ]));
+    }
+
+    static uint16_t last( const Container& c )
+    {
+      switch( c.type )
+      {
+        case ARRAY:
+          return c.values.back( );
+        case RUNS:
+          return static_cast< uint16_t >( c.values[ c.values.size( ) - 2 ] +
+                                          c.values.back( ));
+        case BITMAP:
+        {
+          size_t word = BITMAP_WORDS - 1;
+          while( c.bits[ word ] == 0 )
+            --word;
+          return static_cast< uint16_t >( word * 64 +
+                                          highestBit( c.bits[ word ]));
+        }
+      }
+      return 0;
+    }
+
+    /** Builds the smallest container for sorted unique values. */
+    static Container fromSorted( uint16_t key, const uint16_t* lows,
+                                 size_t count )
+    {
+      Container c;
+      c.key = key;
+      c.cardinality = static_cast< uint32_t >( count );
+
+      size_t runs = count ? 1 : 0;
+      for( size_t i = 1; i < count; ++i )
+        runs += lows[ i ] != lows[ i - 1 ] + 1;
+
+      if( 2 * runs < std::min( count, ARRAY_MAX ))
+      {
+        c.type = RUNS;
+        c.values.reserve( 2 * runs );
+        for( size_t i = 0; i < count; ++i )
+        {
+          if( i > 0 && lows[ i ] == lows[ i - 1 ] + 1 )
+            ++c.values.back( );
+          else
+          {
+            c.values.push_back( lows[ i ]);
+            c.values.push_back( 0 );
+          }
+        }
+      }
+      else if( count <= ARRAY_MAX )
+      {
+        c.type = ARRAY;
+        c.values.assign( lows, lows + count );
+      }
+      else
+      {
+        c.type = BITMAP;
+        c.bits.assign( BITMAP_WORDS, 0 );
+        for( size_t i = 0; i < count; ++i )
+          c.bits[ lows[ i ] >> 6 ] |= uint64_t( 1 ) << ( lows[ i ] & 63 );
+      }
+      return c;
+    }
+
+    /** Builds the smallest container for the values [first, last]. */
+    static Container fromRange( uint16_t key, uint16_t first, uint16_t last )
+    {
+      Container c;
+      c.key = key;
+      c.cardinality = uint32_t( last ) - first + 1;
+
+      if( c.cardinality <= 2 )
+      {
+        c.type = ARRAY;
+        for( uint32_t low = first; low <= last; ++low )
+          c.values.push_back( static_cast< uint16_t >( low ));
+      }
+      else
+      {
+        c.type = RUNS;
+        c.values = { first, static_cast< uint16_t >( last - first ) };
+      }
+      return c;
+    }
+
+    /** Builds the smallest container for a bitmap. Returns false if it is
+     * empty. */
+    static bool fromBits( uint16_t key, const uint64_t* bits, Container& c )
+    {
+      size_t cardinality = 0;
+      size_t runs = 0;
+      uint64_t carry = 0;
+      for( size_t word = 0; word < BITMAP_WORDS; ++word )
+      {
+        cardinality += popcount( bits[ word ]);
+        runs += popcount( bits[ word ] & ~(( bits[ word ] << 1 ) | carry ));
+        carry = bits[ word ] >> 63;
+      }
+
+      if( cardinality == 0 )
+        return false;
+
+      c.key = key;
+      c.cardinality = static_cast< uint32_t >( cardinality );
+      c.values.clear( );
+      c.bits.clear( );
+
+      if( 2 * runs >= std::min( cardinality, ARRAY_MAX ) &&
+          cardinality > ARRAY_MAX )
+      {
+        c.type = BITMAP;
+        c.bits.assign( bits, bits + BITMAP_WORDS );
+        return true;
+      }
+
+      const bool asRuns = 2 * runs < std::min( cardinality, ARRAY_MAX );
+      c.type = asRuns ? RUNS : ARRAY;
+      c.values.reserve( asRuns ? 2 * runs : cardinality );
+      for( size_t word = 0; word < BITMAP_WORDS; ++word )
+      {
+        for( uint64_t remaining = bits[ word ]; remaining;
+             remaining &= remaining - 1 )
+        {
+          const auto low = static_cast< uint16_t >(
+            word * 64 + lowestBit( remaining ));
+          if( !asRuns )
+            c.values.push_back( low );
+          else if( !c.values.empty( ) &&
+                   c.values[ c.values.size( ) - 2 ] + c.values.back( ) + 1 ==
+                   low )
+            ++c.values.back( );
+          else
+          {
+            c.values.push_back( low );
+            c.values.push_back( 0 );
+          }
+        }
+      }
+      return true;
+    }
+
+    static void toBits( const Container& c, uint64_t* bits )
+    {
+      if( c.type == BITMAP )
+      {
+        std::memcpy( bits, c.bits.data( ), BITMAP_WORDS * sizeof( uint64_t ));
+        return;
+      }
+
+      std::memset( bits, 0, BITMAP_WORDS * sizeof( uint64_t ));
+      if( c.type == ARRAY )
+      {
+        for( const auto low : c.values )
+          bits[ low >> 6 ] |= uint64_t( 1 ) << ( low & 63 );
+      }
+      else
+      {
+        for( size_t run = 0; run < runCount( c ); ++run )
+          setRange( bits, c.values[ 2 * run ],
+                    c.values[ 2 * run ] + c.values[ 2 * run + 1 ]);
+      }
+    }
+
+    /** Converts the container to its smallest representation. */
+    static void optimize( Container& c )
+    {
+      Bits bits;
+      toBits( c, bits );
+      fromBits( c.key, bits, c );
+    }
+
+    static bool add( Container& c, uint16_t low )
+    {
+      switch( c.type )
+      {
+        case ARRAY:
+        {
+          const auto it = std::lower_bound( c.values.begin( ), c.values.end( ),
+                                            low );
+          if( it != c.values.end( ) && *it == low )
+            return false;
+
+          c.values.insert( it, low );
+          if( ++c.cardinality > ARRAY_MAX )
+          {
+            optimize( c );
+            c.values.shrink_to_fit( );
+          }
+          return true;
+        }
+        case BITMAP:
+        {
+          uint64_t& word = c.bits[ low >> 6 ];
+          const uint64_t bit = uint64_t( 1 ) << ( low & 63 );
+          if( word & bit )
+            return false;
+
+          word |= bit;
+          ++c.cardinality;
+          return true;
+        }
+        case RUNS:
+        {
+          if( contains( c, low ))
+            return false;
+
+          const size_t runs = runCount( c );
+          const size_t run = findRun( c, low );
+          const size_t next = run < runs ? run + 1 : 0;
+          const bool extendsRun = run < runs &&
+            c.values[ 2 * run ] + c.values[ 2 * run + 1 ] + 1 == low;
+          const bool extendsNext = next < runs &&
+                                   low + 1 == c.values[ 2 * next ];
+
+          if( extendsRun && extendsNext )
+          {
+            c.values[ 2 * run + 1 ] += c.values[ 2 * next + 1 ] + 2;
+            c.values.erase( c.values.begin( ) + 2 * next,
+                            c.values.begin( ) + 2 * next + 2 );
+          }
+          else if( extendsRun )
+            ++c.values[ 2 * run + 1 ];
+          else if( extendsNext )
+          {
+            c.values[ 2 * next ] = low;
+            ++c.values[ 2 * next + 1 ];
+          }
+          else
+          {
+            const uint16_t run_[ 2 ] = { low, 0 };
+            c.values.insert( c.values.begin( ) + 2 * next, run_, run_ + 2 );
+          }
+
+          ++c.cardinality;
+          if( 2 * runCount( c ) >= std::min< size_t >( c.cardinality,
+                                                       ARRAY_MAX ))
+            optimize( c );
+          return true;
+        }
+      }
+      return false;
+    }
+
+    static bool remove( Container& c, uint16_t low )
+    {
+      switch( c.type )
+      {
+        case ARRAY:
+        {
+          const auto it = std::lower_bound( c.values.begin( ), c.values.end( ),
+                                            low );
+          if( it == c.values.end( ) || *it != low )
+            return false;
+
+          c.values.erase( it );
+          --c.cardinality;
+          return true;
+        }
+        case BITMAP:
+        {
+          uint64_t& word = c.bits[ low >> 6 ];
+          const uint64_t bit = uint64_t( 1 ) << ( low & 63 );
+          if(( word & bit ) == 0 )
+            return false;
+
+          word &= ~bit;
+          if( --c.cardinality <= ARRAY_MAX && c.cardinality > 0 )
+            optimize( c );
+          return true;
+        }
+        case RUNS:
+        {
+          if( !contains( c, low ))
+            return false;
+
+          const size_t run = findRun( c, low );
+          const unsigned int start = c.values[ 2 * run ];
+          const unsigned int end = start + c.values[ 2 * run + 1 ];
+
+          if( start == end )
+            c.values.erase( c.values.begin( ) + 2 * run,
+                            c.values.begin( ) + 2 * run + 2 );
+          else if( low == start )
+          {
+            ++c.values[ 2 * run ];
+            --c.values[ 2 * run + 1 ];
+          }
+          else if( low == end )
+            --c.values[ 2 * run + 1 ];
+          else
+          {
+            c.values[ 2 * run + 1 ] = static_cast< uint16_t >( low - start - 1 );
+            const uint16_t run_[ 2 ] = {
+              static_cast< uint16_t >( low + 1 ),
+              static_cast< uint16_t >( end - low - 1 )};
+            c.values.insert( c.values.begin( ) + 2 * run + 2, run_, run_ + 2 );
+          }
+
+          --c.cardinality;
+          if( c.cardinality > 0 &&
+              2 * runCount( c ) >= std::min< size_t >( c.cardinality,
+                                                       ARRAY_MAX ))
+            optimize( c );
+          return true;
+        }
+      }
+      return false;
+    }
+
+    /** Combines two containers with the same key. Returns false if the
+     * result is empty. */
+    static bool combine( const Container& a, const Container& b,
+                         Operation operation, Container& result )
+    {
+      std::vector< uint16_t > lows;
+
+      // Sparse sides are filtered value by value instead of expanded.
+      if( operation != UNION && ( a.type == ARRAY ||
+          ( operation == INTERSECTION && b.type == ARRAY )))
+      {
+        const bool aIsArray = a.type == ARRAY;
+        const Container& values = aIsArray ? a : b;
+        const Container& other = aIsArray ? b : a;
+        const bool keep = operation == INTERSECTION;
+        for( const auto low : values.values )
+          if( contains( other, low ) == keep )
+            lows.push_back( low );
+      }
+      else if( operation == UNION && a.type == ARRAY && b.type == ARRAY )
+      {
+        std::set_union( a.values.begin( ), a.values.end( ),
+                        b.values.begin( ), b.values.end( ),
+                        std::back_inserter( lows ));
+      }
+      else
+      {
+        Bits bitsA;
+        Bits bitsB;
+        toBits( a, bitsA );
+        toBits( b, bitsB );
+        for( size_t word = 0; word < BITMAP_WORDS; ++word )
+        {
+          switch( operation )
+          {
+            case UNION: bitsA[ word ] |= bitsB[ word ]; break;
+            case INTERSECTION: bitsA[ word ] &= bitsB[ word ]; break;
+            case DIFFERENCE: bitsA[ word ] &= ~bitsB[ word ]; break;
+          }
+        }
+        return fromBits( a.key, bitsA, result );
+      }
+
+      if( lows.empty( ))
+        return false;
+
+      result = fromSorted( a.key, lows.data( ), lows.size( ));
+      return true;
+    }
+  };
+
+  GIDSet::const_iterator::const_iterator( const GIDSet* set, size_t container )
+  : _set( set )
+  {
+    seek( container );
+  }
+
+  void GIDSet::const_iterator::seek( size_t container )
+  {
+    _container = container;
+    _index = 0;
+    _value = 0;
+    if( container >= _set->_containers.size( ))
+      return;
+
+    const auto& c = _set->_containers[ container ];
+    const uint16_t low = Containers::first( c );
+    if( c.type == BITMAP )
+      _index = low;
+    _value = ( uint32_t( c.key ) << 16 ) | low;
+  }
+
+  GIDSet::const_iterator& GIDSet::const_iterator::operator++( void )
+  {
+    const auto& c = _set->_containers[ _container ];
+    const uint32_t high = uint32_t( c.key ) << 16;
+    const unsigned int low = _value & 0xFFFF;
+
+    switch( c.type )
+    {
+      case ARRAY:
+        if( ++_index < c.values.size( ))
+        {
+          _value = high | c.values[ _index ];
+          return *this;
+        }
+        break;
+      case RUNS:
+        if( low < unsigned( c.values[ 2 * _index ] ) +
+                  c.values[ 2 * _index + 1 ])
+        {
+          ++_value;
+          return *this;
+        }
+        if( ++_index < Containers::runCount( c ))
+        {
+          _value = high | c.values[ 2 * _index ];
+          return *this;
+        }
+        break;
+      case BITMAP:
+        if( low < 0xFFFF )
+        {
+          size_t word = ( low + 1 ) >> 6;
+          uint64_t bits = c.bits[ word ] & ( ~uint64_t( 0 ) << (( low + 1 ) & 63 ));
+          while( true )
+          {
+            if( bits )
+            {
+              _index = word * 64 + lowestBit( bits );
+              _value = high | static_cast< uint32_t >( _index );
+              return *this;
+            }
+            if( ++word == BITMAP_WORDS )
+              break;
+            bits = c.bits[ word ];
+          }
+        }
+        break;
+    }
+
+    seek( _container + 1 );
+    return *this;
+  }
+
+  GIDSet::GIDSet( void )
+  : _size( 0 )
+  { }
+
+  GIDSet::GIDSet( const std::set< uint32_t >& gids )
+  : _size( 0 )
+  {
+    insert( gids.begin( ), gids.end( ));
+  }
+
+  GIDSet::GIDSet( std::initializer_list< uint32_t > gids )
+  : _size( 0 )
+  {
+    insert( gids.begin( ), gids.end( ));
+  }
+
+  std::vector< GIDSet::Container >::const_iterator
+  GIDSet::findContainer( uint16_t key ) const
+  {
+    return std::lower_bound( _containers.begin( ), _containers.end( ), key,
+      []( const Container& c, uint16_t key_ ){ return c.key < key_; });
+  }
+
+  bool GIDSet::insert( uint32_t gid )
+  {
+    const auto key = static_cast< uint16_t >( gid >> 16 );
+    const auto low = static_cast< uint16_t >( gid & 0xFFFF );
+
+    // Ascending insertion only ever touches the last container.
+    auto it = _containers.end( );
+    if( !_containers.empty( ) && _containers.back( ).key >= key )
+      it = _containers.begin( ) + ( findContainer( key ) - _containers.cbegin( ));
+
+    if( it == _containers.end( ) || it->key != key )
+    {
+      Container c;
+      c.key = key;
+      c.type = ARRAY;
+      c.cardinality = 1;
+      c.values.push_back( low );
+      _containers.insert( it, std::move( c ));
+    }
+    else if( !Containers::add( *it, low ))
+      return false;
+
+    ++_size;
+    return true;
+  }
+
+  void GIDSet::insertValues( std::vector< uint32_t >& gids )
+  {
+    if( !std::is_sorted( gids.begin( ), gids.end( )))
+      std::sort( gids.begin( ), gids.end( ));
+    gids.erase( std::unique( gids.begin( ), gids.end( )), gids.end( ));
+    if( gids.empty( ))
+      return;
+
+    GIDSet built;
+    std::vector< uint16_t > lows;
+    for( size_t i = 0; i < gids.size( ); )
+    {
+      const auto key = static_cast< uint16_t >( gids[ i ] >> 16 );
+      lows.clear( );
+      for( ; i < gids.size( ) && ( gids[ i ] >> 16 ) == key; ++i )
+        lows.push_back( static_cast< uint16_t >( gids[ i ] & 0xFFFF ));
+
+      built._containers.push_back(
+        Containers::fromSorted( key, lows.data( ), lows.size( )));
+    }
+    built._size = gids.size( );
+
+    if( _containers.empty( ))
+      *this = std::move( built );
+    else
+      *this |= built;
+  }
+
+  void GIDSet::insertRange( uint32_t first, uint32_t last )
+  {
+    if( first >= last )
+      return;
+
+    GIDSet built;
+    for( uint64_t gid = first; gid < last; )
+    {
+      const auto key = static_cast< uint16_t >( gid >> 16 );
+      const uint64_t containerLast =
+        std::min< uint64_t >(( uint64_t( key ) << 16 ) | 0xFFFF, last - 1 );
+
+      built._containers.push_back( Containers::fromRange(
+        key, static_cast< uint16_t >( gid & 0xFFFF ),
+        static_cast< uint16_t >( containerLast & 0xFFFF )));
+      gid = containerLast + 1;
+    }
+    built._size = last - first;
+
+    if( _containers.empty( ))
+      *this = std::move( built );
+    else
+      *this |= built;
+  }
+
+  size_t GIDSet::erase( uint32_t gid )
+  {
+    const auto key = static_cast< uint16_t >( gid >> 16 );
+    auto it = _containers.begin( ) +
+              ( findContainer( key ) - _containers.cbegin( ));
+    if( it == _containers.end( ) || it->key != key ||
+        !Containers::remove( *it, static_cast< uint16_t >( gid & 0xFFFF )))
+      return 0;
+
+    if( it->cardinality == 0 )
+      _containers.erase( it );
+    --_size;
+    return 1;
+  }
+
+  void GIDSet::clear( void )
+  {
+    _containers.clear( );
+    _size = 0;
+  }
+
+  bool GIDSet::contains( uint32_t gid ) const
+  {
+    const auto key = static_cast< uint16_t >( gid >> 16 );
+    const auto it = findContainer( key );
+    return it != _containers.end( ) && it->key == key &&
+           Containers::contains( *it, static_cast< uint16_t >( gid & 0xFFFF ));
+  }
+
+  GIDSet::const_iterator GIDSet::find( uint32_t gid ) const
+  {
+    if( !contains( gid ))
+      return end( );
+
+    const auto it = findContainer( static_cast< uint16_t >( gid >> 16 ));
+    const auto low = static_cast< uint16_t >( gid & 0xFFFF );
+    size_t index = low;
+    if( it->type == ARRAY )
+      index = std::lower_bound( it->values.begin( ), it->values.end( ), low ) -
+              it->values.begin( );
+    else if( it->type == RUNS )
+      index = Containers::findRun( *it, low );
+
+    return const_iterator( this, it - _containers.begin( ), index, gid );
+  }
+
+  uint32_t GIDSet::first( void ) const
+  {
+    const auto& c = _containers.front( );
+    return ( uint32_t( c.key ) << 16 ) | Containers::first( c );
+  }
+
+  uint32_t GIDSet::last( void ) const
+  {
+    const auto& c = _containers.back( );
+    return ( uint32_t( c.key ) << 16 ) | Containers::last( c );
+  }
+
+  void GIDSet::combine( const GIDSet& other, Operation operation )
+  {
+    if( &other == this )
+    {
+      if( operation == DIFFERENCE )
+        clear( );
+      return;
+    }
+
+    std::vector< Container > result;
+    result.reserve( _containers.size( ) +
+                    ( operation == UNION ? other._containers.size( ) : 0 ));
+
+    auto a = _containers.begin( );
+    auto b = other._containers.begin( );
+    while( a != _containers.end( ) && b != other._containers.end( ))
+    {
+      if( a->key < b->key )
+      {
+        if( operation != INTERSECTION )
+          result.push_back( std::move( *a ));
+        ++a;
+      }
+      else if( b->key < a->key )
+      {
+        if( operation == UNION )
+          result.push_back( *b );
+        ++b;
+      }
+      else
+      {
+        Container c;
+        if( Containers::combine( *a, *b, operation, c ))
+          result.push_back( std::move( c ));
+        ++a;
+        ++b;
+      }
+    }
+
+    if( operation != INTERSECTION )
+      std::move( a, _containers.end( ), std::back_inserter( result ));
+    if( operation == UNION )
+      result.insert( result.end( ), b, other._containers.end( ));
+
+    _containers.swap( result );
+    _size = 0;
+    for( const auto& c : _containers )
+      _size += c.cardinality;
+  }
+
+  GIDSet& GIDSet::operator|=( const GIDSet& other )
+  {
+    combine( other, UNION );
+    return *this;
+  }
+
+  GIDSet& GIDSet::operator&=( const GIDSet& other )
+  {
+    combine( other, INTERSECTION );
+    return *this;
+  }
+
+  GIDSet& GIDSet::operator-=( const GIDSet& other )
+  {
+    combine( other, DIFFERENCE );
+    return *this;
+  }
+
+  bool GIDSet::operator==( const GIDSet& other ) const
+  {
+    return _size == other._size &&
+           std::equal( begin( ), end( ), other.begin( ));
+  }
+
+  std::set< uint32_t > GIDSet::toSet( void ) const
+  {
+    return std::set< uint32_t >( begin( ), end( ));
+  }
+
+  size_t GIDSet::memoryUsage( void ) const
+  {
+    size_t bytes = sizeof( *this ) +
+                   _containers.capacity( ) * sizeof( Container );
+    for( const auto& c : _containers )
+      bytes += c.values.capacity( ) * sizeof( uint16_t ) +
+               c.bits.capacity( ) * sizeof( uint64_t );
+    return bytes;
+  }
+}
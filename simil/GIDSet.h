@@ -0,0 +1,309 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef __SIMIL_GIDSET_H__
+#define __SIMIL_GIDSET_H__
+
+#include <simil/api.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <set>
+#include <vector>
+
+namespace simil
+{
+  /** \class GIDSet
+   * \brief Compressed set of gids, ordered like std::set< uint32_t >.
+   *
+   * Gids are grouped by their upper 16 bits. Each group is kept as a sorted
+   * array, a 65536 bit bitmap or a list of runs, whichever is smallest, so
+   * contiguous gid ranges take a few bytes and dense ones one bit per gid.
+   * Iterators are read only and visit the gids in ascending order.
+   *
+   */
+  class SIMIL_API GIDSet
+  {
+    enum ContainerType : uint8_t
+    {
+      ARRAY = 0,
+      BITMAP,
+      RUNS
+    };
+
+    struct Container
+    {
+      uint16_t key;
+      ContainerType type;
+      uint32_t cardinality;
+      std::vector< uint16_t > values; /** array values or run start, length-1 */
+      std::vector< uint64_t > bits;
+    };
+
+    struct Containers;
+
+  public:
+    /** \class const_iterator
+     * \brief Forward iterator over the gids of the set.
+     *
+     */
+    class SIMIL_API const_iterator
+    {
+    public:
+      typedef std::forward_iterator_tag iterator_category;
+      typedef uint32_t value_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef const uint32_t* pointer;
+      typedef uint32_t reference;
+
+      const_iterator( void )
+      : _set( nullptr )
+      , _container( 0 )
+      , _index( 0 )
+      , _value( 0 )
+      { }
+
+      uint32_t operator*( void ) const
+      {
+        return _value;
+      }
+
+      const_iterator& operator++( void );
+
+      const_iterator operator++( int )
+      {
+        const_iterator previous = *this;
+        ++( *this );
+        return previous;
+      }
+
+      bool operator==( const const_iterator& other ) const
+      {
+        return _container == other._container && _index == other._index &&
+               _value == other._value;
+      }
+
+      bool operator!=( const const_iterator& other ) const
+      {
+        return !( *this == other );
+      }
+
+    private:
+      friend class GIDSet;
+
+      const_iterator( const GIDSet* set, size_t container );
+      const_iterator( const GIDSet* set, size_t container, size_t index,
+                      uint32_t value )
+      : _set( set )
+      , _container( container )
+      , _index( index )
+      , _value( value )
+      { }
+
+      void seek( size_t container );
+
+      const GIDSet* _set;
+      size_t _container;
+      size_t _index;
+      uint32_t _value;
+    };
+
+    typedef const_iterator iterator;
+    typedef uint32_t value_type;
+    typedef uint32_t key_type;
+    typedef size_t size_type;
+
+    GIDSet( void );
+
+    /** \brief GIDSet class constructor.
+     * \param[in] gids Set to copy, as returned by Brion.
+     *
+     */
+    GIDSet( const std::set< uint32_t >& gids );
+
+    GIDSet( std::initializer_list< uint32_t > gids );
+
+    /** \brief GIDSet class constructor from a range of gids in any order.
+     * \param[in] first First gid.
+     * \param[in] last End of the gids.
+     *
+     */
+    template< typename Iterator >
+    GIDSet( Iterator first, Iterator last )
+    : _size( 0 )
+    {
+      insert( first, last );
+    }
+
+    /** \brief Adds a gid. Adding gids in ascending order is the fastest.
+     * \param[in] gid Gid to add.
+     * \return true if the gid was not in the set.
+     *
+     */
+    bool insert( uint32_t gid );
+
+    bool emplace( uint32_t gid )
+    {
+      return insert( gid );
+    }
+
+    /** \brief Adds a range of gids in any order, sorting them once.
+     * \param[in] first First gid.
+     * \param[in] last End of the gids.
+     *
+     */
+    template< typename Iterator >
+    void insert( Iterator first, Iterator last )
+    {
+      std::vector< uint32_t > gids( first, last );
+      insertValues( gids );
+    }
+
+    /** \brief Adds the contiguous gids [first, last) without expanding
+     * them, a single run per 65536 gids.
+     * \param[in] first First gid.
+     * \param[in] last Gid after the last one.
+     *
+     */
+    void insertRange( uint32_t first, uint32_t last );
+
+    /** \brief Removes a gid.
+     * \param[in] gid Gid to remove.
+     * \return Number of removed gids, 0 or 1.
+     *
+     */
+    size_t erase( uint32_t gid );
+
+    void clear( void );
+
+    bool contains( uint32_t gid ) const;
+
+    size_t count( uint32_t gid ) const
+    {
+      return contains( gid ) ? 1 : 0;
+    }
+
+    /** \brief Returns an iterator to the gid or end( ) if it is not in the
+     * set.
+     * \param[in] gid Gid to find.
+     *
+     */
+    const_iterator find( uint32_t gid ) const;
+
+    size_t size( void ) const
+    {
+      return _size;
+    }
+
+    bool empty( void ) const
+    {
+      return _size == 0;
+    }
+
+    /** \brief Returns the smallest gid. The set must not be empty.
+     *
+     */
+    uint32_t first( void ) const;
+
+    /** \brief Returns the largest gid. The set must not be empty.
+     *
+     */
+    uint32_t last( void ) const;
+
+    const_iterator begin( void ) const
+    {
+      return const_iterator( this, 0 );
+    }
+
+    const_iterator end( void ) const
+    {
+      return const_iterator( this, _containers.size( ), 0, 0 );
+    }
+
+    const_iterator cbegin( void ) const
+    {
+      return begin( );
+    }
+
+    const_iterator cend( void ) const
+    {
+      return end( );
+    }
+
+    GIDSet& operator|=( const GIDSet& other );
+    GIDSet& operator&=( const GIDSet& other );
+    GIDSet& operator-=( const GIDSet& other );
+
+    bool operator==( const GIDSet& other ) const;
+
+    bool operator!=( const GIDSet& other ) const
+    {
+      return !( *this == other );
+    }
+
+    /** \brief Returns a copy as a std::set, for APIs like Brion that
+     * need one.
+     *
+     */
+    std::set< uint32_t > toSet( void ) const;
+
+    /** \brief Returns the bytes used by the set.
+     *
+     */
+    size_t memoryUsage( void ) const;
+
+  private:
+    enum Operation
+    {
+      UNION,
+      INTERSECTION,
+      DIFFERENCE
+    };
+
+    void insertValues( std::vector< uint32_t >& gids );
+    void combine( const GIDSet& other, Operation operation );
+    std::vector< Container >::const_iterator
+    findContainer( uint16_t key ) const;
+
+    std::vector< Container > _containers;
+    size_t _size;
+  };
+
+  inline GIDSet operator|( GIDSet lhs, const GIDSet& rhs )
+  {
+    return lhs |= rhs;
+  }
+
+  inline GIDSet operator&( GIDSet lhs, const GIDSet& rhs )
+  {
+    return lhs &= rhs;
+  }
+
+  inline GIDSet operator-( GIDSet lhs, const GIDSet& rhs )
+  {
+    return lhs -= rhs;
+  }
+}
+
+#endif /* __SIMIL_GIDSET_H__ */
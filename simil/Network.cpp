@@ -21,6 +21,10 @@
  */
 
 #include "Network.h"
+#include "loaders/auxiliar/BinaryContainer.h"
+
+#include <iostream>
+#include <stdexcept>
 
 namespace simil
 {
@@ -30,6 +34,7 @@ namespace simil
     , _dataType( dataType )
     , _simulationType( TSimNetwork )
     , _needUpdate( false )
+    , _placeholder( false )
 #ifdef SIMIL_USE_BRION
     , _blueConfig( nullptr )
     , _target( target )
@@ -48,12 +53,13 @@ namespace simil
 
         brain::Circuit* circuit = new brain::Circuit( *_blueConfig );
 
-        if ( !target.empty( ) )
-          _gids = brion::Target::parse( targets, target );
-        else
-          _gids = circuit->getGIDs( );
+        const TGIDSet gids = !target.empty( ) ?
+          TGIDSet( brion::Target::parse( targets, target )) :
+          TGIDSet( circuit->getGIDs( ));
 
-        _positions = circuit->getPositions( _gids );
+        // Circuit positions come in gid order.
+        addNeurons( GIDVec( gids.begin( ), gids.end( )),
+                    circuit->getPositions( gids.toSet( )));
 
         delete circuit;
 #else
@@ -67,9 +73,8 @@ namespace simil
         _h5Network = new H5Network( filePath_ );
         _h5Network->load( );
 
-        _gids = _h5Network->getGIDs( );
-
-        _positions = _h5Network->getComposedPositions( );
+        const TPosVect positions = _h5Network->getComposedPositions( );
+        addNeurons( _h5Network->getGIDVec( ), positions );
 
         auto subsetIts = _h5Network->getSubsets( );
         for ( simil::SubsetMapCIt it = subsetIts.first; it != subsetIts.second;
@@ -83,14 +88,28 @@ namespace simil
         _csvNetwork = new CSVNetwork( filePath_ );
         _csvNetwork->load( );
 
-        _gids = _csvNetwork->getGIDs( );
+        addNeurons( _csvNetwork->getGIDVec( ),
+                    _csvNetwork->getComposedPositions( ));
+        break;
+      }
+      case TBINARY:
+      {
+        BinaryContainer container( filePath_ );
+        container.load( );
+
+        // Gids are stored sorted, in the order of the positions.
+        const TGIDSet gids = container.gids( );
+        addNeurons( GIDVec( gids.begin( ), gids.end( )),
+                    container.positions( ));
 
-        _positions = _csvNetwork->getComposedPositions( );
+        _subsetEventManager = container.subsets( );
         break;
       }
       default:
         break;
     }
+
+    _gidSize = _positions.size( );
   }
 
   Network::Network( )
@@ -98,6 +117,7 @@ namespace simil
   , _dataType( TDataUndefined )
   , _simulationType( TSimNetwork )
   , _needUpdate( false )
+  , _placeholder( true )
 #ifdef SIMIL_USE_BRION
   , _blueConfig( nullptr )
 #endif
@@ -106,7 +126,7 @@ namespace simil
   {
     _gids.insert( 0 );
     _positions.push_back( vmml::Vector3f( 0, 0, 0 ) );
-    _gidsV.push_back( 0 );
+    _index.push_back( 0 );
     _gidSize = 1;
   }
 
@@ -136,6 +156,8 @@ namespace simil
       return;
     }
 
+    dropPlaceholder( );
+
     unsigned int width = sqrt( gids.size( )+_gidSize );
     unsigned int i = 0;
 
@@ -145,7 +167,7 @@ namespace simil
       if ( _gids.count( number ) < 1 )
       {
         _gids.insert( ( number ) );
-        _gidsV.push_back( number );
+        _index.push_back( number );
 
         if ( generatePos )
         {
@@ -158,6 +180,7 @@ namespace simil
     if ( generatePos )
       _gidSize = _positions.size( );
 
+    resetSpatialIndex( );
     _needUpdate = true;
   }
 
@@ -165,34 +188,78 @@ namespace simil
   {
     if ( append )
     {
-      _positions.insert( _positions.begin( ), positions.begin( ),
+      _positions.insert( _positions.end( ), positions.begin( ),
                          positions.end( ) );
-      _gidSize = _positions.size( );
     }
     else
     {
-      _positions.clear( );
-      _positions = positions;
-      _gidSize = _positions.size( );
+      _positions = std::move( positions );
     }
+    checkPositions( );
+
+    _gidSize = _positions.size( );
+    resetSpatialIndex( );
     _needUpdate = true;
   }
 
   void Network::setNeurons( const TGIDVect& gids, const TPosVect& positions)
   {
-    for (unsigned int i = 0; i < gids.size(); ++i)
+    dropPlaceholder( );
+    addNeurons( gids, positions );
+
+    _gidSize = _positions.size();
+    resetSpatialIndex( );
+  }
+
+  void Network::addNeurons( const GIDVec& gids, const TPosVect& positions )
+  {
+    if ( gids.size( ) != positions.size( ))
     {
-      unsigned int number = gids[i];
-      if (_gids.count(number) < 1)
-      {
-        _gids.insert((number));
-        _gidsV.push_back(number);
-        _positions.push_back(positions[i]);
+      const std::string errorText = "Network: " +
+        std::to_string( gids.size( )) + " gids for " +
+        std::to_string( positions.size( )) + " positions.";
+      std::cerr << "EXCEPTION: " << errorText << " -> " << __FILE__ << ":"
+                << __LINE__ << std::endl;
 
+      throw std::runtime_error( errorText );
+    }
+
+    // Repeated gids keep the position of their first appearance.
+    for ( size_t i = 0; i < gids.size( ); ++i )
+    {
+      if ( _gids.count( gids[ i ] ) < 1 )
+      {
+        _gids.insert( gids[ i ] );
+        _index.push_back( gids[ i ] );
+        _positions.push_back( positions[ i ] );
       }
     }
+  }
 
-    _gidSize = _positions.size();
+  void Network::dropPlaceholder( void )
+  {
+    if ( !_placeholder )
+      return;
+
+    _gids.clear( );
+    _index.clear( );
+    _positions.clear( );
+    _gidSize = 0;
+    _placeholder = false;
+  }
+
+  void Network::checkPositions( void ) const
+  {
+    if ( _positions.size( ) == _index.size( ))
+      return;
+
+    const std::string errorText = "Network: " +
+      std::to_string( _index.size( )) + " neurons but " +
+      std::to_string( _positions.size( )) + " positions.";
+    std::cerr << "EXCEPTION: " << errorText << " -> " << __FILE__ << ":"
+              << __LINE__ << std::endl;
+
+    throw std::runtime_error( errorText );
   }
 
   void Network::setSubset( SubsetEventManager subsets )
@@ -222,7 +289,35 @@ namespace simil
 
   const GIDVec& Network::gidsVec( void ) const
   {
-    return _gidsV;
+    return _index.gids( );
+  }
+
+  const NeuronIndex& Network::neuronIndex( void ) const
+  {
+    return _index;
+  }
+
+  std::shared_ptr< const SpatialIndex > Network::spatialIndex( void ) const
+  {
+    std::lock_guard< std::mutex > lock( _spatialMutex );
+    if ( !_spatialIndex )
+    {
+      checkPositions( );
+
+      std::vector< SpatialIndex::Neuron > neurons;
+      neurons.reserve( _positions.size( ));
+      for ( size_t i = 0; i < _positions.size( ); ++i )
+        neurons.emplace_back( _index.gid( i ), _positions[ i ] );
+
+      _spatialIndex = std::make_shared< SpatialIndex >( neurons );
+    }
+    return _spatialIndex;
+  }
+
+  void Network::resetSpatialIndex( void )
+  {
+    std::lock_guard< std::mutex > lock( _spatialMutex );
+    _spatialIndex.reset( );
   }
 
   const TPosVect& Network::positions( void ) const
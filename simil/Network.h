@@ -24,11 +24,16 @@
 #define __SIMIL__NETWORK_H__
 
 #include "types.h"
+#include "NeuronIndex.h"
+#include "SpatialIndex.h"
 #include "SubsetEventManager.h"
 #include "loaders/auxiliar/H5Network.h"
 #include "loaders/auxiliar/CSVNetwork.h"
 #include <simil/api.h>
 
+#include <memory>
+#include <mutex>
+
 #ifdef SIMIL_USE_BRION
 #include <brion/brion.h>
 #include <brain/brain.h>
@@ -40,6 +45,10 @@ namespace simil
   class SIMIL_API Network
   {
   public:
+    /** \brief Network class constructor. The network holds a placeholder
+     * neuron with gid 0 until the first gids are set.
+     *
+     */
     Network( );
 
     Network( const std::string& filePath, TDataType dataType,
@@ -48,6 +57,12 @@ namespace simil
 
     bool isUpdated();
 
+    /** \brief Adds the given gids, in gid order. Without generated
+     * positions, setPositions( ) must follow with one position per neuron.
+     * \param[in] gids Gids to add.
+     * \param[in] generatePos Places the new neurons on a grid if true.
+     *
+     */
     void setGids( const TGIDSet& gids, bool generatePos = false );
     const TGIDSet& gids( void );
 
@@ -58,9 +73,34 @@ namespace simil
 
     const GIDVec& gidsVec( void ) const;
 
+    /** \brief Returns the dense index of the neurons, in the same order as
+     * gidsVec( ) and positions( ).
+     *
+     */
+    const NeuronIndex& neuronIndex( void ) const;
+
+    /** \brief Returns the spatial index of the positions, built on the first
+     * call after the neurons or their positions change.
+     *
+     */
+    std::shared_ptr< const SpatialIndex > spatialIndex( void ) const;
+
     const TPosVect& positions( void ) const;
+
+    /** \brief Sets or appends positions, in the order of gidsVec( ).
+     * Throws if the result does not hold one position per neuron.
+     * \param[in] positions Positions to set or append.
+     * \param[in] append Appends the positions if true.
+     *
+     */
     void setPositions( TPosVect positions, bool append = false );
 
+    /** \brief Adds neurons with their positions. Gids already in the
+     * network are skipped. Throws if the sizes differ.
+     * \param[in] gids Gids of the neurons.
+     * \param[in] positions Position of each gid, in the same order.
+     *
+     */
     void setNeurons( const TGIDVect& gids, const TPosVect& positions);
 
     void setSubset( SubsetEventManager subsets );
@@ -77,14 +117,36 @@ namespace simil
 #endif
 
   protected:
+    void resetSpatialIndex( void );
+
+    /** \brief Appends the neurons not in the network yet, keeping gids
+     * and positions paired. Throws if the sizes differ.
+     *
+     */
+    void addNeurons( const GIDVec& gids, const TPosVect& positions );
+
+    /** \brief Removes the placeholder neuron of default constructed
+     * networks.
+     *
+     */
+    void dropPlaceholder( void );
+
+    /** \brief Throws if there is not one position per neuron.
+     *
+     */
+    void checkPositions( void ) const;
+
     std::string filePath;
 
     TGIDSet _gids;
-    TGIDVect _gidsV;
+    NeuronIndex _index;
     TPosVect _positions;
 
     unsigned int _gidSize;
 
+    mutable std::mutex _spatialMutex;
+    mutable std::shared_ptr< const SpatialIndex > _spatialIndex;
+
     simil::SubsetEventManager _subsetEventManager;
 
     //    simil::SubsetMap _subsets;
@@ -94,6 +156,9 @@ namespace simil
 
     bool _needUpdate;
 
+    // True while the network only holds the default placeholder neuron.
+    bool _placeholder;
+
 #ifdef SIMIL_USE_BRION
     brion::BlueConfig* _blueConfig;
 
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "NeuronActivity.h"
+#include "SpikeKernels.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+  // Activity below this value is dropped, which bounds the look back
+  // window of the exponential decay and keeps values out of denormals.
+  constexpr float MIN_ACTIVITY = 1e-3f;
+
+  constexpr size_t BATCH_SIZE = 256;
+}
+
+namespace simil
+{
+  NeuronActivity::NeuronActivity( TDecayModel model, float duration )
+  : _model( model )
+  , _duration( duration > 0.0f ? duration : 1.0f )
+  , _time( 0.0f )
+  , _valid( false )
+  { }
+
+  void NeuronActivity::setModel( TDecayModel model, float duration )
+  {
+    _model = model;
+    _duration = duration > 0.0f ? duration : 1.0f;
+    _valid = false;
+  }
+
+  float NeuronActivity::lookBack( void ) const
+  {
+    return _model == T_DECAY_EXPONENTIAL ?
+      _duration * std::log( 1.0f / MIN_ACTIVITY ) : _duration;
+  }
+
+  float NeuronActivity::decay( float elapsed ) const
+  {
+    if( _model == T_DECAY_LINEAR )
+      return std::max( 1.0f - elapsed / _duration, 0.0f );
+
+    const float value = std::exp( -elapsed / _duration );
+    return value >= MIN_ACTIVITY ? value : 0.0f;
+  }
+
+  void NeuronActivity::clear( void )
+  {
+    _valid = false;
+  }
+
+  void NeuronActivity::advance( float time, const SpikeColumns& spikes,
+                                size_t first, size_t last,
+                                const NeuronIndex& index )
+  {
+    if( !_valid || _values.size( ) != index.size( ) || time < _time ||
+        time - _time >= lookBack( ))
+    {
+      rebuild( time, spikes, index );
+      return;
+    }
+
+    const float elapsed = time - _time;
+    if( elapsed > 0.0f )
+    {
+      if( _model == T_DECAY_EXPONENTIAL )
+        kernels::scaleValues( _values.data( ), _values.size( ),
+                              std::exp( -elapsed / _duration ), MIN_ACTIVITY );
+      else
+        kernels::subtractValues( _values.data( ), _values.size( ),
+                                 elapsed / _duration );
+    }
+
+    addSpikes( time, spikes, first, last, index );
+    _time = time;
+  }
+
+  void NeuronActivity::rebuild( float time, const SpikeColumns& spikes,
+                                const NeuronIndex& index )
+  {
+    _values.assign( index.size( ), 0.0f );
+    addSpikes( time, spikes, spikes.lowerBound( time - lookBack( )),
+               spikes.lowerBound( time ), index );
+    _time = time;
+    _valid = true;
+  }
+
+  void NeuronActivity::save( Snapshot& snapshot ) const
+  {
+    snapshot.time = _time;
+    snapshot.neurons.clear( );
+    snapshot.values.clear( );
+    for( size_t i = 0; i < _values.size( ); ++i )
+    {
+      if( _values[ i ] > 0.0f )
+      {
+        snapshot.neurons.push_back( static_cast< uint32_t >( i ));
+        snapshot.values.push_back( _values[ i ]);
+      }
+    }
+  }
+
+  void NeuronActivity::restore( const Snapshot& snapshot, size_t neurons )
+  {
+    _values.assign( neurons, 0.0f );
+    for( size_t i = 0; i < snapshot.neurons.size( ); ++i )
+      if( snapshot.neurons[ i ] < neurons )
+        _values[ snapshot.neurons[ i ]] = snapshot.values[ i ];
+
+    _time = snapshot.time;
+    _valid = true;
+  }
+
+  void NeuronActivity::addSpikes( float time, const SpikeColumns& spikes,
+                                  size_t first, size_t last,
+                                  const NeuronIndex& index )
+  {
+    const SpikeColumns::ReadGuard guard( spikes );
+
+    // Later spikes of the same neuron overwrite the earlier ones.
+    uint32_t neurons[ BATCH_SIZE ];
+    last = std::min( last, spikes.size( ));
+    while( first < last )
+    {
+      const auto run = spikes.run( first, last );
+      for( size_t batch = 0; batch < run.size; batch += BATCH_SIZE )
+      {
+        const size_t count = std::min( BATCH_SIZE, run.size - batch );
+        index.toIndices( run.gids + batch, neurons, count );
+        for( size_t i = 0; i < count; ++i )
+          if( neurons[ i ] < _values.size( ))
+            _values[ neurons[ i ]] = decay( time - run.times[ batch + i ]);
+      }
+
+      first += run.size;
+    }
+  }
+}
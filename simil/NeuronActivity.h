@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef __SIMIL_NEURONACTIVITY_H__
+#define __SIMIL_NEURONACTIVITY_H__
+
+#include "types.h"
+#include "NeuronIndex.h"
+#include "SpikeColumns.h"
+#include <simil/api.h>
+
+#include <vector>
+
+namespace simil
+{
+  typedef enum
+  {
+    T_DECAY_EXPONENTIAL = 0,
+    T_DECAY_LINEAR
+  } TDecayModel;
+
+  /** \class NeuronActivity
+   * \brief Activity of every neuron at a point in time, in neuron index
+   * order. A spike sets the activity of its neuron to one, and it then
+   * fades either exponentially or linearly.
+   *
+   * Moving forward decays the whole buffer with a single SIMD sweep and
+   * only writes the neurons that fired in between. Any other move rebuilds
+   * the buffer from the spikes of the last lookBack( ) time units, since
+   * older ones have faded out.
+   *
+   */
+  class SIMIL_API NeuronActivity
+  {
+  public:
+
+    /** \brief Copy of the buffer at some time that only keeps the active
+     * neurons.
+     *
+     */
+    struct Snapshot
+    {
+      float time;
+      std::vector< uint32_t > neurons;
+      std::vector< float > values;
+    };
+
+    /** \brief NeuronActivity class constructor.
+     * \param[in] model Decay model.
+     * \param[in] duration Time constant of the exponential decay, or time
+     * to fade out of the linear one.
+     *
+     */
+    NeuronActivity( TDecayModel model = T_DECAY_EXPONENTIAL,
+                    float duration = 1.0f );
+
+    /** \brief Changes the decay model. The buffer is rebuilt on its next
+     * update.
+     * \param[in] model Decay model.
+     * \param[in] duration Time constant of the exponential decay, or time
+     * to fade out of the linear one.
+     *
+     */
+    void setModel( TDecayModel model, float duration );
+
+    TDecayModel model( void ) const
+    {
+      return _model;
+    }
+
+    float duration( void ) const
+    {
+      return _duration;
+    }
+
+    /** \brief Returns how long a spike keeps its neuron active.
+     *
+     */
+    float lookBack( void ) const;
+
+    /** \brief Returns the activity left the given time after a spike.
+     * \param[in] elapsed Time since the spike.
+     *
+     */
+    float decay( float elapsed ) const;
+
+    /** \brief Moves the buffer forward to the given time.
+     * \param[in] time New time.
+     * \param[in] spikes Spike columns.
+     * \param[in] first Position of the first spike after the current time.
+     * \param[in] last Position of the first spike at or after time.
+     * \param[in] index Dense index of the neurons.
+     *
+     * The buffer is rebuilt instead if it is not valid, if time is behind
+     * the current one, too far ahead or the number of neurons changed.
+     *
+     */
+    void advance( float time, const SpikeColumns& spikes, size_t first,
+                  size_t last, const NeuronIndex& index );
+
+    /** \brief Computes the buffer at the given time from the spikes of the
+     * lookBack( ) window before it.
+     * \param[in] time Time of the buffer.
+     * \param[in] spikes Spike columns.
+     * \param[in] index Dense index of the neurons.
+     *
+     */
+    void rebuild( float time, const SpikeColumns& spikes,
+                  const NeuronIndex& index );
+
+    /** \brief Saves the active neurons of a valid buffer.
+     * \param[out] snapshot Saved state.
+     *
+     */
+    void save( Snapshot& snapshot ) const;
+
+    /** \brief Replaces the buffer with a saved one.
+     * \param[in] snapshot Saved state, with the same decay model.
+     * \param[in] neurons Number of neurons.
+     *
+     */
+    void restore( const Snapshot& snapshot, size_t neurons );
+
+    /** \brief Invalidates the buffer until it is rebuilt.
+     *
+     */
+    void clear( void );
+
+    bool valid( void ) const
+    {
+      return _valid;
+    }
+
+    float time( void ) const
+    {
+      return _time;
+    }
+
+    const std::vector< float >& values( void ) const
+    {
+      return _values;
+    }
+
+  protected:
+
+    /** \brief Sets the activity at time of the neurons that fired in
+     * [first, last).
+     *
+     */
+    void addSpikes( float time, const SpikeColumns& spikes, size_t first,
+                    size_t last, const NeuronIndex& index );
+
+    TDecayModel _model;
+    float _duration;
+
+    float _time;
+    bool _valid;
+    std::vector< float > _values;
+  };
+}
+
+#endif /* __SIMIL_NEURONACTIVITY_H__ */
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "NeuronIndex.h"
+#include "Spikes.hpp"
+
+#include <algorithm>
+
+namespace
+{
+  size_t directLimit( size_t neurons )
+  {
+    return std::max< size_t >( simil::NeuronIndex::DIRECT_SLACK * neurons,
+                               simil::NeuronIndex::DIRECT_MIN );
+  }
+}
+
+namespace simil
+{
+  NeuronIndex::NeuronIndex( void )
+  : _minGid( 0 )
+  , _hashed( false )
+  { }
+
+  NeuronIndex::NeuronIndex( const GIDVec& gids )
+  : _gids( gids )
+  , _minGid( 0 )
+  , _hashed( false )
+  {
+    rebuild( );
+  }
+
+  void NeuronIndex::assign( const GIDVec& gids )
+  {
+    _gids = gids;
+    rebuild( );
+  }
+
+  void NeuronIndex::clear( void )
+  {
+    _gids.clear( );
+    _table.clear( );
+    _hash.clear( );
+    _minGid = 0;
+    _hashed = false;
+  }
+
+  void NeuronIndex::rebuild( void )
+  {
+    _table.clear( );
+    _hash.clear( );
+    _minGid = 0;
+    _hashed = false;
+    if( _gids.empty( ))
+      return;
+
+    const auto range = std::minmax_element( _gids.cbegin( ), _gids.cend( ));
+    const uint64_t span = uint64_t( *range.second ) - *range.first + 1;
+    if( span > directLimit( _gids.size( )))
+    {
+      useHash( );
+      return;
+    }
+
+    _minGid = *range.first;
+    _table.assign( span, INVALID );
+    for( size_t i = 0; i < _gids.size( ); ++i )
+    {
+      uint32_t& slot = _table[ _gids[ i ] - _minGid ];
+      if( slot == INVALID )
+        slot = static_cast< uint32_t >( i );
+    }
+  }
+
+  void NeuronIndex::useHash( void )
+  {
+    _hashed = true;
+    std::vector< uint32_t >( ).swap( _table );
+    _hash.reserve( _gids.size( ));
+    for( size_t i = 0; i < _gids.size( ); ++i )
+      _hash.emplace( _gids[ i ], static_cast< uint32_t >( i ));
+  }
+
+  uint32_t NeuronIndex::push_back( uint32_t gid )
+  {
+    const auto index_ = static_cast< uint32_t >( _gids.size( ));
+    _gids.push_back( gid );
+
+    if( _hashed )
+    {
+      _hash.emplace( gid, index_ );
+      return index_;
+    }
+
+    if( _table.empty( ))
+    {
+      _minGid = gid;
+      _table.assign( 1, index_ );
+      return index_;
+    }
+
+    const uint64_t first = std::min( _minGid, gid );
+    const uint64_t end = std::max( uint64_t( _minGid ) + _table.size( ),
+                                   uint64_t( gid ) + 1 );
+    const size_t limit = directLimit( _gids.size( ));
+    if( end - first > limit )
+    {
+      useHash( );
+      return index_;
+    }
+
+    if( gid < _minGid )
+    {
+      // Room is left below so that descending gids do not shift the table
+      // on every insertion.
+      const uint64_t slack = std::min< uint64_t >(
+        gid, std::min< uint64_t >( _table.size( ), limit - ( end - first )));
+      const auto minGid = static_cast< uint32_t >( gid - slack );
+      _table.insert( _table.begin( ), _minGid - minGid, INVALID );
+      _minGid = minGid;
+    }
+    else if( gid - _minGid >= _table.size( ))
+      _table.resize( size_t( gid - _minGid ) + 1, INVALID );
+
+    uint32_t& slot = _table[ gid - _minGid ];
+    if( slot == INVALID )
+      slot = index_;
+    return index_;
+  }
+
+  void NeuronIndex::toIndices( const uint32_t* gids, uint32_t* indices,
+                               size_t count ) const
+  {
+    for( size_t i = 0; i < count; ++i )
+      indices[ i ] = index( gids[ i ]);
+  }
+
+  Spikes NeuronIndex::toIndices( const Spikes& spikes ) const
+  {
+    const Spikes::ReadGuard guard( spikes );
+
+    Spikes result;
+    const size_t count = spikes.size( );
+    result.reserve( count );
+
+    for( size_t position = 0; position < count; )
+    {
+      const auto segment = spikes.run( position, count );
+      for( size_t i = 0; i < segment.size; ++i )
+      {
+        const uint32_t index_ = index( segment.gids[ i ]);
+        if( index_ != INVALID )
+          result.push_back( segment.times[ i ], index_ );
+      }
+      position += segment.size;
+    }
+
+    return result;
+  }
+
+  size_t NeuronIndex::memoryUsage( void ) const
+  {
+    return ( _gids.capacity( ) + _table.capacity( )) * sizeof( uint32_t ) +
+           _hash.bucket_count( ) * sizeof( void* ) +
+           _hash.size( ) * ( sizeof( std::pair< const uint32_t, uint32_t > ) +
+                             2 * sizeof( void* ));
+  }
+}
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef __SIMIL_NEURONINDEX_H__
+#define __SIMIL_NEURONINDEX_H__
+
+#include "types.h"
+#include <simil/api.h>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace simil
+{
+  /** \class NeuronIndex
+   * \brief Assigns the dense index [0, N) of each neuron in network order to
+   * its gid, so per neuron state can live in plain arrays.
+   *
+   * Gid to index lookups go through a direct table covering the gid range
+   * while it is at most DIRECT_SLACK times larger than the number of
+   * neurons, and through a hash table for sparser gids such as REST node
+   * ids.
+   *
+   */
+  class SIMIL_API NeuronIndex
+  {
+  public:
+
+    enum : uint32_t
+    {
+      INVALID = 0xFFFFFFFFu,
+      DIRECT_SLACK = 4,
+      DIRECT_MIN = 1u << 16
+    };
+
+    NeuronIndex( void );
+
+    /** \brief NeuronIndex class constructor.
+     * \param[in] gids Gids in network order. Repeated gids keep the index
+     * of their first appearance.
+     *
+     */
+    explicit NeuronIndex( const GIDVec& gids );
+
+    /** \brief Replaces the neurons with the given ones.
+     * \param[in] gids Gids in network order.
+     *
+     */
+    void assign( const GIDVec& gids );
+
+    /** \brief Appends a neuron.
+     * \param[in] gid Gid of the neuron.
+     * \return Index of the neuron.
+     *
+     */
+    uint32_t push_back( uint32_t gid );
+
+    void clear( void );
+
+    /** \brief Returns the index of the gid, or INVALID if it is not in the
+     * network.
+     * \param[in] gid Gid to look for.
+     *
+     */
+    uint32_t index( uint32_t gid ) const
+    {
+      if( _hashed )
+      {
+        const auto it = _hash.find( gid );
+        return it == _hash.end( ) ? uint32_t( INVALID ) : it->second;
+      }
+
+      const uint32_t offset = gid - _minGid;
+      return offset < _table.size( ) ? _table[ offset ] : uint32_t( INVALID );
+    }
+
+    bool contains( uint32_t gid ) const
+    {
+      return index( gid ) != INVALID;
+    }
+
+    /** \brief Returns the gid of the neuron with the given index.
+     * \param[in] index Index in [0, size( )).
+     *
+     */
+    uint32_t gid( uint32_t index ) const
+    {
+      return _gids[ index ];
+    }
+
+    /** \brief Returns the gids in network order.
+     *
+     */
+    const GIDVec& gids( void ) const
+    {
+      return _gids;
+    }
+
+    size_t size( void ) const
+    {
+      return _gids.size( );
+    }
+
+    bool empty( void ) const
+    {
+      return _gids.empty( );
+    }
+
+    /** \brief Translates gids to indices, INVALID for unknown ones.
+     * \param[in] gids Gids to translate.
+     * \param[out] indices Translated indices, may alias gids.
+     * \param[in] count Number of gids.
+     *
+     */
+    void toIndices( const uint32_t* gids, uint32_t* indices,
+                    size_t count ) const;
+
+    /** \brief Returns a copy of the spikes with the neuron index instead of
+     * the gid in the gid column. Spikes of gids outside the network are
+     * dropped.
+     * \param[in] spikes Spikes to translate.
+     *
+     */
+    Spikes toIndices( const Spikes& spikes ) const;
+
+    /** \brief Returns the bytes used by the lookup tables.
+     *
+     */
+    size_t memoryUsage( void ) const;
+
+  private:
+    void rebuild( void );
+    void useHash( void );
+
+    GIDVec _gids;
+    std::vector< uint32_t > _table;
+    std::unordered_map< uint32_t, uint32_t > _hash;
+    uint32_t _minGid;
+    bool _hashed;
+  };
+}
+
+#endif /* __SIMIL_NEURONINDEX_H__ */
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "PackedSpikes.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+  // Maps float bit patterns to unsigned integers with the same order.
+  inline uint32_t toKey( float value )
+  {
+    uint32_t bits;
+    std::memcpy( &bits, &value, sizeof( bits ));
+    return ( bits & 0x80000000u ) ? ~bits : ( bits | 0x80000000u );
+  }
+
+  inline float fromKey( uint32_t key )
+  {
+    const uint32_t negative = ( key >> 31 ) - 1u;
+    const uint32_t bits = key ^ ( negative | 0x80000000u );
+    float value;
+    std::memcpy( &value, &bits, sizeof( value ));
+    return value;
+  }
+
+  inline unsigned int bitWidth( uint32_t value )
+  {
+    unsigned int width = 0;
+    for( ; value; value >>= 1 )
+      ++width;
+    return width;
+  }
+
+  inline uint64_t load64( const uint8_t* data )
+  {
+    uint64_t value;
+    std::memcpy( &value, data, sizeof( value ));
+    return value;
+  }
+
+  /** Appends values of the given bit width, least significant bit first. */
+  class BitWriter
+  {
+  public:
+    explicit BitWriter( std::vector< uint8_t >& data )
+    : _data( data )
+    , _buffer( 0 )
+    , _bits( 0 )
+    { }
+
+    void write( uint32_t value, unsigned int width )
+    {
+      if( width == 0 )
+        return;
+
+      _buffer |= static_cast< uint64_t >( value ) << _bits;
+      _bits += width;
+      while( _bits >= 8 )
+      {
+        _data.push_back( static_cast< uint8_t >( _buffer ));
+        _buffer >>= 8;
+        _bits -= 8;
+      }
+    }
+
+    void flush( void )
+    {
+      if( _bits > 0 )
+        _data.push_back( static_cast< uint8_t >( _buffer ));
+      _buffer = 0;
+      _bits = 0;
+    }
+
+  private:
+    std::vector< uint8_t >& _data;
+    uint64_t _buffer;
+    unsigned int _bits;
+  };
+
+  /** Reads the i-th value of the given bit width. Needs 8 readable bytes
+   * past the value, guaranteed by the padding at the end of the data. */
+  inline uint32_t readBits( const uint8_t* data, size_t i, unsigned int width,
+                            uint64_t mask )
+  {
+    const size_t bit = i * width;
+    return static_cast< uint32_t >(
+      ( load64( data + ( bit >> 3 )) >> ( bit & 7 )) & mask );
+  }
+}
+
+namespace simil
+{
+  PackedSpikes::PackedSpikes( const float* times, const uint32_t* gids,
+                              size_t size )
+  : _size( size )
+  {
+    _offsets.reserve(( size + PACK_SIZE - 1 ) / PACK_SIZE );
+
+    for( size_t first = 0; first < size; first += PACK_SIZE )
+    {
+      const size_t count = std::min( static_cast< size_t >( PACK_SIZE ),
+                                     size - first );
+      const float* packTimes = times + first;
+      const uint32_t* packGids = gids + first;
+
+      // Deltas wrap around if equal times come as -0 after +0, which
+      // costs bits but stays exact.
+      uint32_t maxDelta = 0;
+      for( size_t i = 1; i < count; ++i )
+        maxDelta = std::max( maxDelta,
+          toKey( packTimes[ i ]) - toKey( packTimes[ i - 1 ]));
+
+      const auto gidRange =
+        std::minmax_element( packGids, packGids + count );
+      const uint32_t gidBase = *gidRange.first;
+
+      const unsigned int timeBits = bitWidth( maxDelta );
+      const unsigned int gidBits = bitWidth( *gidRange.second - gidBase );
+
+      _offsets.push_back( static_cast< uint32_t >( _data.size( )));
+
+      const uint32_t firstKey = toKey( packTimes[ 0 ]);
+      const uint16_t packCount = static_cast< uint16_t >( count );
+      const uint8_t widths[ 2 ] = { static_cast< uint8_t >( timeBits ),
+                                    static_cast< uint8_t >( gidBits )};
+
+      uint8_t header[ HEADER_SIZE ];
+      std::memcpy( header, &firstKey, 4 );
+      std::memcpy( header + 4, &gidBase, 4 );
+      std::memcpy( header + 8, &packCount, 2 );
+      std::memcpy( header + 10, widths, 2 );
+      _data.insert( _data.end( ), header, header + HEADER_SIZE );
+
+      BitWriter writer( _data );
+      for( size_t i = 1; i < count; ++i )
+        writer.write( toKey( packTimes[ i ]) - toKey( packTimes[ i - 1 ]),
+                      timeBits );
+      writer.flush( );
+
+      for( size_t i = 0; i < count; ++i )
+        writer.write( packGids[ i ] - gidBase, gidBits );
+      writer.flush( );
+    }
+
+    // Padding for the 64 bit reads of the decoder.
+    _data.resize( _data.size( ) + 8, 0 );
+    _data.shrink_to_fit( );
+  }
+
+  size_t PackedSpikes::decode( size_t pack, float* times,
+                               uint32_t* gids ) const
+  {
+    const uint8_t* data = _data.data( ) + _offsets[ pack ];
+
+    uint32_t key;
+    uint32_t gidBase;
+    uint16_t count;
+    std::memcpy( &key, data, 4 );
+    std::memcpy( &gidBase, data + 4, 4 );
+    std::memcpy( &count, data + 8, 2 );
+    const unsigned int timeBits = data[ 10 ];
+    const unsigned int gidBits = data[ 11 ];
+
+    const uint8_t* deltas = data + HEADER_SIZE;
+    const uint8_t* offsets = deltas + (( count - 1 ) * timeBits + 7 ) / 8;
+
+    const uint64_t timeMask = ( uint64_t( 1 ) << timeBits ) - 1;
+    const uint64_t gidMask = ( uint64_t( 1 ) << gidBits ) - 1;
+
+    times[ 0 ] = fromKey( key );
+    for( size_t i = 1; i < count; ++i )
+    {
+      key += readBits( deltas, i - 1, timeBits, timeMask );
+      times[ i ] = fromKey( key );
+    }
+
+    for( size_t i = 0; i < count; ++i )
+      gids[ i ] = gidBase + readBits( offsets, i, gidBits, gidMask );
+
+    return count;
+  }
+}
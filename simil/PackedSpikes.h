@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef __SIMIL_PACKEDSPIKES_H__
+#define __SIMIL_PACKEDSPIKES_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace simil
+{
+  /** \class PackedSpikes
+   * \brief Lossless compressed copy of a run of time sorted spikes.
+   *
+   * Spikes are split in packs of PACK_SIZE. Each pack starts with a header
+   * holding the first time, the number of spikes, the gid base and the bit
+   * widths, followed by the bit packed time deltas and gid offsets. Times
+   * are stored as differences between their IEEE bit patterns, mapped so
+   * that they grow with the value, which keeps the encoding exact.
+   *
+   */
+  class PackedSpikes
+  {
+  public:
+
+    enum : size_t
+    {
+      PACK_SIZE = 128,
+      HEADER_SIZE = 12
+    };
+
+    /** \brief Compresses the given spikes.
+     * \param[in] times Sorted times.
+     * \param[in] gids Gids of the spikes.
+     * \param[in] size Number of spikes.
+     *
+     */
+    PackedSpikes( const float* times, const uint32_t* gids, size_t size );
+
+    size_t size( void ) const
+    {
+      return _size;
+    }
+
+    size_t packs( void ) const
+    {
+      return _offsets.size( );
+    }
+
+    /** \brief Returns the size in bytes of the compressed data.
+     *
+     */
+    size_t bytes( void ) const
+    {
+      return _data.size( ) + _offsets.size( ) * sizeof( uint32_t );
+    }
+
+    /** \brief Decodes one pack. Returns the number of decoded spikes.
+     * \param[in] pack Pack index.
+     * \param[out] times Buffer for at least PACK_SIZE times.
+     * \param[out] gids Buffer for at least PACK_SIZE gids.
+     *
+     */
+    size_t decode( size_t pack, float* times, uint32_t* gids ) const;
+
+  protected:
+
+    std::vector< uint8_t > _data;
+    std::vector< uint32_t > _offsets;
+    size_t _size;
+  };
+}
+
+#endif /* __SIMIL_PACKEDSPIKES_H__ */
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef __SIMIL_PARALLEL_H__
+#define __SIMIL_PARALLEL_H__
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace simil
+{
+  /** \brief Helpers to split work over a few threads. Internal header.
+   *
+   */
+  namespace parallel
+  {
+    /** \brief Returns the number of threads to use for the given number of
+     * items, giving each thread at least minItems of them.
+     *
+     */
+    inline unsigned int threadCount( size_t items, size_t minItems = 1 << 16 )
+    {
+      const size_t hardware =
+        std::max( std::thread::hardware_concurrency( ), 1u );
+      return static_cast< unsigned int >( std::max< size_t >( 1,
+        std::min( hardware, items / std::max< size_t >( minItems, 1 ))));
+    }
+
+    /** \brief Splits [0, items) in as many consecutive ranges as threads and
+     * calls func( thread, begin, end ) for each one in its own thread. The
+     * first range runs in the calling thread.
+     *
+     */
+    template< typename Func >
+    void forRanges( size_t items, unsigned int threads, Func func )
+    {
+      threads = std::max( threads, 1u );
+      const auto rangeBegin = [ & ]( unsigned int thread )
+      {
+        return items / threads * thread +
+          std::min< size_t >( thread, items % threads );
+      };
+
+      std::vector< std::thread > workers;
+      workers.reserve( threads - 1 );
+      for( unsigned int t = 1; t < threads; ++t )
+        workers.emplace_back( func, t, rangeBegin( t ), rangeBegin( t + 1 ));
+
+      func( 0u, rangeBegin( 0 ), rangeBegin( 1 ));
+
+      for( auto& worker : workers )
+        worker.join( );
+    }
+  }
+}
+
+#endif /* __SIMIL_PARALLEL_H__ */
@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "RateEngine.h"
+#include "Parallel.h"
+#include "SpikeData.h"
+#include "SubsetEventManager.h"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace simil
+{
+  RateEngine::RateEngine( void )
+  : _startTime( 0.0f )
+  , _binSize( 1.0f )
+  , _invBinSize( 1.0f )
+  , _signatureOffsets( 1, 0 )
+  , _stride( 0 )
+  , _bins( 0 )
+  { }
+
+  RateEngine::RateEngine( const SubsetEventManager& subsets, float binSize,
+                          float startTime )
+  : _startTime( startTime )
+  , _binSize( binSize )
+  , _invBinSize( 1.0f / binSize )
+  , _names( subsets.subsetNames( ))
+  , _signatureOffsets( 1, 0 )
+  , _stride( 0 )
+  , _bins( 0 )
+  {
+    if( !( binSize > 0.0f ))
+    {
+      const std::string errorText = "Invalid rate bin size " +
+                                    std::to_string( binSize );
+      std::cerr << "EXCEPTION: " << errorText << " -> " << __FILE__ << ":"
+                << __LINE__ << std::endl;
+
+      throw std::runtime_error( errorText );
+    }
+
+    const GIDSet all = subsets.subsetsUnion( _names );
+    _index.assign( GIDVec( all.begin( ), all.end( )));
+    _signatureOf.assign( _index.size( ), 0 );
+
+    // Subsets are visited in order, so a gid moves from the signature of its
+    // previous subsets to the one that also has the current subset. Runs of
+    // gids usually share signatures, so the last transition is cached.
+    std::vector< std::vector< uint32_t >> signatures( 1 );
+    std::unordered_map< uint64_t, uint32_t > transitions;
+    for( uint32_t subset = 0; subset < _names.size( ); ++subset )
+    {
+      const auto& gids = subsets.subsetGIDs( _names[ subset ]);
+      _sizes.push_back( gids.size( ));
+
+      uint32_t from = NeuronIndex::INVALID;
+      uint32_t to = 0;
+      for( const auto gid : gids )
+      {
+        auto& signature = _signatureOf[ _index.index( gid )];
+        if( signature != from )
+        {
+          from = signature;
+          const uint64_t key = ( uint64_t( from ) << 32 ) | subset;
+          const auto it = transitions.find( key );
+          if( it != transitions.end( ))
+            to = it->second;
+          else
+          {
+            auto list = signatures[ from ];
+            list.push_back( subset );
+            to = static_cast< uint32_t >( signatures.size( ));
+            signatures.push_back( std::move( list ));
+            transitions.emplace( key, to );
+          }
+        }
+        signature = to;
+      }
+    }
+
+    for( const auto& list : signatures )
+    {
+      _signatureSubsets.insert( _signatureSubsets.end( ), list.begin( ),
+                                list.end( ));
+      _signatureOffsets.push_back(
+        static_cast< uint32_t >( _signatureSubsets.size( )));
+    }
+  }
+
+  RateEngine::RateEngine( const SpikeData& data, float binSize )
+  : RateEngine( *data.subsetsEvents( ), binSize, data.startTime( ))
+  {
+    compute( data.spikes( ));
+  }
+
+  size_t RateEngine::binOf( float time ) const
+  {
+    const float bin = ( time - _startTime ) * _invBinSize;
+    if( !( bin >= 0.0f && bin < static_cast< float >( MAX_BINS )))
+      return NO_BIN;
+
+    return static_cast< size_t >( bin );
+  }
+
+  void RateEngine::grow( size_t bins )
+  {
+    if( bins <= _bins )
+      return;
+
+    if( bins > _stride )
+    {
+      const size_t stride = std::max( bins,
+        std::min< size_t >( _stride * 2, MAX_BINS ));
+      std::vector< uint32_t > counts( numSubsets( ) * stride, 0 );
+      for( size_t subset = 0; subset < numSubsets( ); ++subset )
+        std::copy_n( _counts.begin( ) + subset * _stride, _bins,
+                     counts.begin( ) + subset * stride );
+
+      _counts.swap( counts );
+      _stride = stride;
+    }
+
+    _bins = bins;
+  }
+
+  void RateEngine::reset( void )
+  {
+    std::fill( _counts.begin( ), _counts.end( ), 0 );
+    _bins = 0;
+  }
+
+  void RateEngine::compute( const SpikeColumns& spikes )
+  {
+    reset( );
+
+    // One guard covers the worker threads, which finish before it ends.
+    const SpikeColumns::ReadGuard guard( spikes );
+
+    const size_t first = spikes.lowerBound( _startTime );
+    if( _names.empty( ))
+      return;
+
+    // Spikes past MAX_BINS bins are left out, so they neither get counted
+    // nor size the matrix.
+    size_t size = spikes.lowerBound( static_cast< float >(
+      _startTime + double( MAX_BINS ) * _binSize ));
+    while( size > first && binOf( spikes.time( size - 1 )) == NO_BIN )
+      --size;
+    if( first >= size )
+      return;
+
+    grow( binOf( spikes.time( size - 1 )) + 1 );
+
+    // Threads get consecutive time ranges, so only the first and last bins
+    // of each range can be shared with a neighbour. Those are counted apart
+    // and every other bin is written in place.
+    const size_t subsets = numSubsets( );
+    const unsigned int threads = parallel::threadCount( size - first );
+    std::vector< uint32_t > edges( threads * 2 * subsets, 0 );
+    std::vector< size_t > edgeBins( threads * 2, NO_BIN );
+
+    parallel::forRanges( size - first, threads,
+      [ & ]( unsigned int t, size_t begin, size_t end )
+      {
+        begin += first;
+        end += first;
+        if( begin == end )
+          return;
+
+        const size_t low = binOf( spikes.time( begin ));
+        const size_t high = binOf( spikes.time( end - 1 ));
+        edgeBins[ 2 * t ] = low;
+        edgeBins[ 2 * t + 1 ] = high;
+        uint32_t* lowCounts = &edges[ 2 * t * subsets ];
+        uint32_t* highCounts = lowCounts + subsets;
+
+        // Gids are translated in batches so the table lookups of several
+        // spikes overlap.
+        uint32_t signatures[ BATCH_SIZE ];
+        while( begin < end )
+        {
+          const auto run = spikes.run( begin, end );
+          for( size_t batch = 0; batch < run.size; batch += BATCH_SIZE )
+          {
+            const size_t count = std::min< size_t >( BATCH_SIZE,
+                                                     run.size - batch );
+            _index.toIndices( run.gids + batch, signatures, count );
+            for( size_t i = 0; i < count; ++i )
+              signatures[ i ] = signatures[ i ] == NeuronIndex::INVALID ?
+                0 : _signatureOf[ signatures[ i ]];
+
+            for( size_t i = 0; i < count; ++i )
+            {
+              const size_t bin = binOf( run.times[ batch + i ]);
+              if( bin == NO_BIN )
+                continue;
+
+              const uint32_t* subset = _signatureSubsets.data( ) +
+                                       _signatureOffsets[ signatures[ i ]];
+              const uint32_t* subsetsEnd = _signatureSubsets.data( ) +
+                _signatureOffsets[ signatures[ i ] + 1 ];
+
+              if( bin == low )
+                for( ; subset != subsetsEnd; ++subset )
+                  ++lowCounts[ *subset ];
+              else if( bin == high )
+                for( ; subset != subsetsEnd; ++subset )
+                  ++highCounts[ *subset ];
+              else
+                for( ; subset != subsetsEnd; ++subset )
+                  ++_counts[ *subset * _stride + bin ];
+            }
+          }
+
+          begin += run.size;
+        }
+      });
+
+    for( size_t t = 0; t < threads; ++t )
+    {
+      const size_t low = edgeBins[ 2 * t ];
+      const size_t high = edgeBins[ 2 * t + 1 ];
+      const uint32_t* lowCounts = &edges[ 2 * t * subsets ];
+      for( size_t subset = 0; subset < subsets; ++subset )
+      {
+        if( low != NO_BIN )
+          _counts[ subset * _stride + low ] += lowCounts[ subset ];
+        if( high != NO_BIN && high != low )
+          _counts[ subset * _stride + high ] += lowCounts[ subsets + subset ];
+      }
+    }
+  }
+
+  void RateEngine::add( const TSpikes& spikes )
+  {
+    if( _names.empty( ))
+      return;
+
+    for( const auto& spike : spikes )
+    {
+      const size_t bin = binOf( spike.first );
+      const uint32_t index = _index.index( spike.second );
+      if( bin == NO_BIN || index == NeuronIndex::INVALID )
+        continue;
+
+      grow( bin + 1 );
+
+      const uint32_t signature = _signatureOf[ index ];
+      for( uint32_t i = _signatureOffsets[ signature ];
+           i < _signatureOffsets[ signature + 1 ]; ++i )
+        ++_counts[ _signatureSubsets[ i ] * _stride + bin ];
+    }
+  }
+
+  float RateEngine::rate( size_t subset, size_t bin ) const
+  {
+    if( _sizes[ subset ] == 0 )
+      return 0.0f;
+
+    return count( subset, bin ) * _invBinSize /
+           static_cast< float >( _sizes[ subset ]);
+  }
+
+  std::vector< uint32_t > RateEngine::countMatrix( void ) const
+  {
+    std::vector< uint32_t > result( numSubsets( ) * _bins );
+    for( size_t subset = 0; subset < numSubsets( ); ++subset )
+      std::copy_n( _counts.begin( ) + subset * _stride, _bins,
+                   result.begin( ) + subset * _bins );
+
+    return result;
+  }
+
+  std::vector< float > RateEngine::rateMatrix( void ) const
+  {
+    std::vector< float > result( numSubsets( ) * _bins );
+    for( size_t subset = 0; subset < numSubsets( ); ++subset )
+      for( size_t bin = 0; bin < _bins; ++bin )
+        result[ subset * _bins + bin ] = rate( subset, bin );
+
+    return result;
+  }
+}
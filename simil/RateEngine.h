@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef __SIMIL_RATEENGINE_H__
+#define __SIMIL_RATEENGINE_H__
+
+#include "types.h"
+#include "NeuronIndex.h"
+#include "SpikeColumns.h"
+#include <simil/api.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace simil
+{
+  class SpikeData;
+  class SubsetEventManager;
+
+  /** \class RateEngine
+   * \brief Spike counts and firing rates of every subset in fixed size time
+   * bins, kept as a subsets x bins matrix.
+   *
+   * Each gid is mapped to the combination of subsets it belongs to when the
+   * engine is built, so counting a spike is a table lookup plus one
+   * increment per subset of its gid. Spikes are counted in a single pass,
+   * split by time over several threads, and new spikes can be added later
+   * in any order. Spikes before the start time or past MAX_BINS bins are
+   * not counted.
+   *
+   */
+  class SIMIL_API RateEngine
+  {
+  public:
+
+    enum : size_t
+    {
+      MAX_BINS = 1 << 22,
+      NO_BIN = ~size_t( 0 ),
+      BATCH_SIZE = 256
+    };
+
+    RateEngine( void );
+
+    /** \brief Builds an empty engine for the subsets of the given manager,
+     * in subsetNames( ) order.
+     * \param[in] subsets Subset manager.
+     * \param[in] binSize Bin width, in simulation time units.
+     * \param[in] startTime Start time of the first bin.
+     *
+     */
+    RateEngine( const SubsetEventManager& subsets, float binSize,
+                float startTime = 0.0f );
+
+    /** \brief Builds the engine for the subsets of the given data and counts
+     * its spikes from the data start time.
+     * \param[in] data Spike data.
+     * \param[in] binSize Bin width, in simulation time units.
+     *
+     */
+    RateEngine( const SpikeData& data, float binSize );
+
+    /** \brief Replaces the counts with the ones of the given spikes, using
+     * several threads.
+     * \param[in] spikes Time sorted spikes.
+     *
+     */
+    void compute( const SpikeColumns& spikes );
+
+    /** \brief Counts the given spikes, which may be in any order.
+     * \param[in] spikes Spikes to add.
+     *
+     */
+    void add( const TSpikes& spikes );
+
+    /** \brief Sets every count to zero.
+     *
+     */
+    void reset( void );
+
+    size_t numSubsets( void ) const
+    {
+      return _names.size( );
+    }
+
+    /** \brief Returns the number of bins, up to the last counted spike.
+     *
+     */
+    size_t numBins( void ) const
+    {
+      return _bins;
+    }
+
+    float binSize( void ) const
+    {
+      return _binSize;
+    }
+
+    float startTime( void ) const
+    {
+      return _startTime;
+    }
+
+    const std::vector< std::string >& subsetNames( void ) const
+    {
+      return _names;
+    }
+
+    /** \brief Returns the number of neurons of the subset.
+     * \param[in] subset Subset index.
+     *
+     */
+    size_t subsetSize( size_t subset ) const
+    {
+      return _sizes[ subset ];
+    }
+
+    uint32_t count( size_t subset, size_t bin ) const
+    {
+      return _counts[ subset * _stride + bin ];
+    }
+
+    /** \brief Returns the mean rate of the subset neurons in the bin, in
+     * spikes per neuron and time unit.
+     * \param[in] subset Subset index.
+     * \param[in] bin Bin index.
+     *
+     */
+    float rate( size_t subset, size_t bin ) const;
+
+    /** \brief Returns the counts as a row major subsets x bins matrix.
+     *
+     */
+    std::vector< uint32_t > countMatrix( void ) const;
+
+    /** \brief Returns the rates as a row major subsets x bins matrix.
+     *
+     */
+    std::vector< float > rateMatrix( void ) const;
+
+    /** \brief Returns the bin of the given time, or NO_BIN if spikes at that
+     * time are not counted.
+     * \param[in] time Spike time.
+     *
+     */
+    size_t binOf( float time ) const;
+
+  protected:
+
+    /** \brief Makes room for at least the given number of bins.
+     *
+     */
+    void grow( size_t bins );
+
+    float _startTime;
+    float _binSize;
+    float _invBinSize;
+
+    std::vector< std::string > _names;
+    std::vector< size_t > _sizes;
+
+    // Gid to signature, the sorted list of subsets of the gid.
+    NeuronIndex _index;
+    std::vector< uint32_t > _signatureOf;
+    std::vector< uint32_t > _signatureOffsets;
+    std::vector< uint32_t > _signatureSubsets;
+
+    // Row major counts, _stride >= _bins columns per subset.
+    std::vector< uint32_t > _counts;
+    size_t _stride;
+    size_t _bins;
+  };
+}
+
+#endif /* __SIMIL_RATEENGINE_H__ */
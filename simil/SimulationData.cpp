@@ -62,7 +62,7 @@ namespace simil
           _gids = circuit->getGIDs( );
         }
 
-        _positions = circuit->getPositions( _gids );
+        _positions = circuit->getPositions( _gids.toSet( ));
 
         delete circuit;
 #else
@@ -97,6 +97,18 @@ namespace simil
         _positions = _csvNetwork->getComposedPositions( );
         break;
       }
+      case TBINARY:
+      {
+        _binaryContainer = std::make_shared< BinaryContainer >( filePath_ );
+        _binaryContainer->load( );
+
+        _gids = _binaryContainer->gids( );
+
+        _positions = _binaryContainer->positions( );
+
+        _subsetEventManager = _binaryContainer->subsets( );
+        break;
+      }
       default:
         break;
     }
@@ -33,6 +33,7 @@
 #include "SubsetEventManager.h"
 #include "loaders/auxiliar/H5Network.h"
 #include "loaders/auxiliar/CSVNetwork.h"
+#include "loaders/auxiliar/BinaryContainer.h"
 #include <simil/api.h>
 
 namespace simil
@@ -71,7 +72,7 @@ namespace simil
     void setEndTime( float endTime );
 
     bool isDirty( void ) const;
-    void cleanDirty( void );
+    virtual void cleanDirty( void );
 
 
 #ifdef SIMIL_USE_BRION
@@ -103,6 +104,8 @@ namespace simil
 
     CSVNetwork* _csvNetwork;
 
+    std::shared_ptr< BinaryContainer > _binaryContainer;
+
     float _startTime;
     float _endTime;
 
@@ -109,6 +109,7 @@ namespace simil
     {
       case TDataType::TBlueConfig:
       case TDataType::THDF5:
+      case TDataType::TBINARY:
       {
         _simData = std::make_shared< SimulationData >( networkPath_ ,
                                                        dataType );
@@ -264,7 +265,7 @@ namespace simil
     return gids( ).size( );
   }
 
-  TPosVect SimulationPlayer::positions( void ) const
+  const TPosVect& SimulationPlayer::positions( void ) const
   {
     if ( _network )
       return _network->positions( );
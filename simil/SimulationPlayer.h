@@ -122,7 +122,7 @@ namespace simil
 
     unsigned int gidsSize( ) const;
 
-    TPosVect positions( void ) const;
+    const TPosVect& positions( void ) const;
 
     TSimulationType simulationType( void ) const;
 
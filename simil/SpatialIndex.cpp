@@ -0,0 +1,335 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "SpatialIndex.h"
+#include "Parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+
+namespace
+{
+  enum Overlap
+  {
+    NONE = 0,
+    PARTIAL,
+    FULL
+  };
+
+  // Nodes below this many points are built in the calling thread.
+  constexpr size_t MIN_PARALLEL_POINTS = 1 << 14;
+
+  template< typename Node >
+  float boxDistance( const Node& node, const float* point )
+  {
+    float distance = 0.0f;
+    for( int axis = 0; axis < 3; ++axis )
+    {
+      const float delta = std::max( { node.min[ axis ] - point[ axis ], 0.0f,
+                                      point[ axis ] - node.max[ axis ]});
+      distance += delta * delta;
+    }
+    return distance;
+  }
+
+  template< typename Node >
+  float farthestDistance( const Node& node, const float* point )
+  {
+    float distance = 0.0f;
+    for( int axis = 0; axis < 3; ++axis )
+    {
+      const float delta = std::max( std::abs( point[ axis ] - node.min[ axis ]),
+                                    std::abs( node.max[ axis ] - point[ axis ]));
+      distance += delta * delta;
+    }
+    return distance;
+  }
+
+  inline float pointDistance( const float* a, const float* b )
+  {
+    const float x = a[ 0 ] - b[ 0 ];
+    const float y = a[ 1 ] - b[ 1 ];
+    const float z = a[ 2 ] - b[ 2 ];
+    return x * x + y * y + z * z;
+  }
+}
+
+namespace simil
+{
+  SpatialIndex::SpatialIndex( const std::vector< Neuron >& neurons )
+  : _depth( 0 )
+  {
+    const size_t count = neurons.size( );
+    if( count == 0 )
+      return;
+
+    const unsigned int threads =
+      parallel::threadCount( count, MIN_PARALLEL_POINTS );
+
+    _points.resize( count );
+    parallel::forRanges( count, threads,
+      [ & ]( unsigned int, size_t begin, size_t end )
+      {
+        for( size_t i = begin; i < end; ++i )
+        {
+          Point& point = _points[ i ];
+          for( int axis = 0; axis < 3; ++axis )
+            point.position[ axis ] = neurons[ i ].second[ axis ];
+          point.gid = neurons[ i ].first;
+        }
+      });
+
+    while((( count - 1 ) >> _depth ) + 1 > LEAF_SIZE )
+      ++_depth;
+    _nodes.resize(( size_t( 2 ) << _depth ) - 1 );
+
+    const auto bounds = [ this ]( size_t begin, size_t end )
+    {
+      Node node;
+      std::fill( node.min, node.min + 3, std::numeric_limits< float >::max( ));
+      std::fill( node.max, node.max + 3,
+                 std::numeric_limits< float >::lowest( ));
+      for( size_t i = begin; i < end; ++i )
+        for( int axis = 0; axis < 3; ++axis )
+        {
+          node.min[ axis ] = std::min( node.min[ axis ],
+                                       _points[ i ].position[ axis ]);
+          node.max[ axis ] = std::max( node.max[ axis ],
+                                       _points[ i ].position[ axis ]);
+        }
+      return node;
+    };
+
+    // Each level splits every node at its median along its widest axis.
+    // Nodes of a level cover disjoint ranges, so they split in parallel.
+    for( unsigned int depth = 0; depth < _depth; ++depth )
+    {
+      const size_t nodes = size_t( 1 ) << depth;
+      parallel::forRanges( nodes,
+        static_cast< unsigned int >( std::min< size_t >( threads, nodes )),
+        [ & ]( unsigned int, size_t first, size_t last )
+        {
+          for( size_t node = first; node < last; ++node )
+          {
+            const size_t begin = rangeBegin( depth, node );
+            const size_t end = rangeBegin( depth, node + 1 );
+            const Node box = bounds( begin, end );
+
+            int axis = 0;
+            for( int i = 1; i < 3; ++i )
+              if( box.max[ i ] - box.min[ i ] >
+                  box.max[ axis ] - box.min[ axis ])
+                axis = i;
+
+            std::nth_element( _points.begin( ) + begin,
+              _points.begin( ) + rangeBegin( depth + 1, 2 * node + 1 ),
+              _points.begin( ) + end,
+              [ axis ]( const Point& a, const Point& b )
+              {
+                return a.position[ axis ] < b.position[ axis ];
+              });
+          }
+        });
+    }
+
+    const size_t leaves = size_t( 1 ) << _depth;
+    const size_t firstLeaf = leaves - 1;
+    parallel::forRanges( leaves, threads,
+      [ & ]( unsigned int, size_t first, size_t last )
+      {
+        for( size_t leaf = first; leaf < last; ++leaf )
+          _nodes[ firstLeaf + leaf ] = bounds( rangeBegin( _depth, leaf ),
+                                               rangeBegin( _depth, leaf + 1 ));
+      });
+
+    for( size_t node = firstLeaf; node-- > 0; )
+    {
+      const Node& left = _nodes[ 2 * node + 1 ];
+      const Node& right = _nodes[ 2 * node + 2 ];
+      for( int axis = 0; axis < 3; ++axis )
+      {
+        _nodes[ node ].min[ axis ] = std::min( left.min[ axis ],
+                                               right.min[ axis ]);
+        _nodes[ node ].max[ axis ] = std::max( left.max[ axis ],
+                                               right.max[ axis ]);
+      }
+    }
+  }
+
+  template< typename Relation, typename Inside >
+  GIDSet SpatialIndex::query( Relation relation, Inside inside ) const
+  {
+    GIDVec gids;
+    if( _points.empty( ))
+      return GIDSet( );
+
+    std::vector< std::pair< unsigned int, size_t >> stack;
+    stack.emplace_back( 0, 0 );
+    while( !stack.empty( ))
+    {
+      const unsigned int depth = stack.back( ).first;
+      const size_t node = stack.back( ).second;
+      stack.pop_back( );
+
+      const Overlap overlap =
+        relation( _nodes[( size_t( 1 ) << depth ) - 1 + node ]);
+      if( overlap == NONE )
+        continue;
+
+      const size_t begin = rangeBegin( depth, node );
+      const size_t end = rangeBegin( depth, node + 1 );
+      if( overlap == FULL )
+      {
+        for( size_t i = begin; i < end; ++i )
+          gids.push_back( _points[ i ].gid );
+      }
+      else if( depth == _depth )
+      {
+        for( size_t i = begin; i < end; ++i )
+          if( inside( _points[ i ].position ))
+            gids.push_back( _points[ i ].gid );
+      }
+      else
+      {
+        stack.emplace_back( depth + 1, 2 * node );
+        stack.emplace_back( depth + 1, 2 * node + 1 );
+      }
+    }
+
+    return GIDSet( gids.begin( ), gids.end( ));
+  }
+
+  GIDSet SpatialIndex::insideBox( const vmml::Vector3f& min,
+                                  const vmml::Vector3f& max ) const
+  {
+    const float low[ 3 ] = { min[ 0 ], min[ 1 ], min[ 2 ]};
+    const float high[ 3 ] = { max[ 0 ], max[ 1 ], max[ 2 ]};
+
+    return query(
+      [ & ]( const Node& node )
+      {
+        bool full = true;
+        for( int axis = 0; axis < 3; ++axis )
+        {
+          if( node.max[ axis ] < low[ axis ] || node.min[ axis ] > high[ axis ])
+            return NONE;
+          full = full && node.min[ axis ] >= low[ axis ] &&
+                 node.max[ axis ] <= high[ axis ];
+        }
+        return full ? FULL : PARTIAL;
+      },
+      [ & ]( const float* position )
+      {
+        for( int axis = 0; axis < 3; ++axis )
+          if( position[ axis ] < low[ axis ] || position[ axis ] > high[ axis ])
+            return false;
+        return true;
+      });
+  }
+
+  GIDSet SpatialIndex::insideSphere( const vmml::Vector3f& center,
+                                     float radius ) const
+  {
+    const float point[ 3 ] = { center[ 0 ], center[ 1 ], center[ 2 ]};
+    const float radius2 = radius * radius;
+
+    return query(
+      [ & ]( const Node& node )
+      {
+        if( boxDistance( node, point ) > radius2 )
+          return NONE;
+        return farthestDistance( node, point ) <= radius2 ? FULL : PARTIAL;
+      },
+      [ & ]( const float* position )
+      {
+        return pointDistance( position, point ) <= radius2;
+      });
+  }
+
+  GIDSet SpatialIndex::nearest( const vmml::Vector3f& point, size_t k ) const
+  {
+    k = std::min( k, _points.size( ));
+    if( k == 0 )
+      return GIDSet( );
+
+    const float query_[ 3 ] = { point[ 0 ], point[ 1 ], point[ 2 ]};
+
+    struct Candidate
+    {
+      float distance;
+      unsigned int depth;
+      size_t node;
+
+      bool operator>( const Candidate& other ) const
+      {
+        return distance > other.distance;
+      }
+    };
+
+    // Nodes are visited closest first, keeping the k best points found.
+    std::priority_queue< Candidate, std::vector< Candidate >,
+                         std::greater< Candidate >> candidates;
+    std::priority_queue< std::pair< float, uint32_t >> best;
+    candidates.push({ boxDistance( _nodes[ 0 ], query_ ), 0, 0 });
+
+    while( !candidates.empty( ))
+    {
+      const Candidate candidate = candidates.top( );
+      if( best.size( ) == k && candidate.distance > best.top( ).first )
+        break;
+      candidates.pop( );
+
+      if( candidate.depth == _depth )
+      {
+        const size_t end = rangeBegin( _depth, candidate.node + 1 );
+        for( size_t i = rangeBegin( _depth, candidate.node ); i < end; ++i )
+        {
+          const float distance = pointDistance( _points[ i ].position, query_ );
+          if( best.size( ) < k )
+            best.emplace( distance, _points[ i ].gid );
+          else if( distance < best.top( ).first )
+          {
+            best.pop( );
+            best.emplace( distance, _points[ i ].gid );
+          }
+        }
+        continue;
+      }
+
+      const unsigned int depth = candidate.depth + 1;
+      for( size_t child = 2 * candidate.node; child < 2 * candidate.node + 2;
+           ++child )
+        candidates.push({ boxDistance(
+          _nodes[( size_t( 1 ) << depth ) - 1 + child ], query_ ),
+          depth, child });
+    }
+
+    GIDVec gids;
+    gids.reserve( best.size( ));
+    for( ; !best.empty( ); best.pop( ))
+      gids.push_back( best.top( ).second );
+
+    return GIDSet( gids.begin( ), gids.end( ));
+  }
+}
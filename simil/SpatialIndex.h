@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef __SIMIL_SPATIALINDEX_H__
+#define __SIMIL_SPATIALINDEX_H__
+
+#include "types.h"
+#include <simil/api.h>
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace simil
+{
+  /** \class SpatialIndex
+   * \brief Balanced kd-tree over neuron positions for region queries.
+   *
+   * Points are reordered so that every node covers a contiguous range and
+   * nodes are laid out as an implicit binary heap, so the tree only stores
+   * one bounding box per node. All the leaves are at the same depth and
+   * hold at most LEAF_SIZE points. Levels are built in parallel.
+   *
+   */
+  class SIMIL_API SpatialIndex
+  {
+  public:
+
+    enum : size_t
+    {
+      LEAF_SIZE = 32
+    };
+
+    /** Gid of a neuron and its position. */
+    typedef std::pair< uint32_t, vmml::Vector3f > Neuron;
+
+    /** \brief SpatialIndex class constructor.
+     * \param[in] neurons Gid and position of every neuron.
+     *
+     */
+    explicit SpatialIndex( const std::vector< Neuron >& neurons );
+
+    /** \brief Returns the gids inside the axis aligned box, borders
+     * included.
+     * \param[in] min Minimum corner of the box.
+     * \param[in] max Maximum corner of the box.
+     *
+     */
+    GIDSet insideBox( const vmml::Vector3f& min,
+                      const vmml::Vector3f& max ) const;
+
+    /** \brief Returns the gids inside the sphere, border included.
+     * \param[in] center Center of the sphere.
+     * \param[in] radius Radius of the sphere.
+     *
+     */
+    GIDSet insideSphere( const vmml::Vector3f& center, float radius ) const;
+
+    /** \brief Returns the gids of the k neurons closest to the point.
+     * \param[in] point Query point.
+     * \param[in] k Number of neurons.
+     *
+     */
+    GIDSet nearest( const vmml::Vector3f& point, size_t k ) const;
+
+    /** \brief Returns the number of indexed neurons.
+     *
+     */
+    size_t size( void ) const
+    {
+      return _points.size( );
+    }
+
+  private:
+    struct Point
+    {
+      float position[ 3 ];
+      uint32_t gid;
+    };
+
+    struct Node
+    {
+      float min[ 3 ];
+      float max[ 3 ];
+    };
+
+    size_t rangeBegin( unsigned int depth, size_t node ) const
+    {
+      return static_cast< size_t >(( uint64_t( _points.size( )) * node )
+                                   >> depth );
+    }
+
+    template< typename Relation, typename Inside >
+    GIDSet query( Relation relation, Inside inside ) const;
+
+    std::vector< Point > _points;
+    std::vector< Node > _nodes;
+    unsigned int _depth;
+  };
+}
+
+#endif /* __SIMIL_SPATIALINDEX_H__ */
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "SpikeClock.h"
+
+#include <algorithm>
+
+namespace simil
+{
+  SpikeClock::SpikeClock( void )
+  : SpikeClock( 0.0f, 0.0f )
+  { }
+
+  SpikeClock::SpikeClock( float startTime, float endTime )
+  : _startTime( startTime )
+  , _endTime( endTime )
+  , _time( startTime )
+  { }
+
+  void SpikeClock::setRange( float startTime, float endTime )
+  {
+    _startTime = startTime;
+    _endTime = endTime;
+    seek( _time );
+  }
+
+  bool SpikeClock::finished( void ) const
+  {
+    return _endTime > _startTime && _time >= _endTime;
+  }
+
+  size_t SpikeClock::add( const SpikeCursor& cursor )
+  {
+    _cursors.push_back( cursor );
+    _cursors.back( ).seek( _time );
+    return _cursors.size( ) - 1;
+  }
+
+  void SpikeClock::clear( void )
+  {
+    _cursors.clear( );
+  }
+
+  void SpikeClock::seek( float time )
+  {
+    _time = clamp( time );
+    for( auto& cursor : _cursors )
+      cursor.seek( _time );
+  }
+
+  void SpikeClock::advance( float deltaTime )
+  {
+    _time = clamp( _time + deltaTime );
+    for( auto& cursor : _cursors )
+      cursor.advance( _time );
+  }
+
+  float SpikeClock::clamp( float time ) const
+  {
+    if( _endTime > _startTime )
+      return std::max( _startTime, std::min( time, _endTime ));
+
+    return time;
+  }
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef __SIMIL_SPIKECLOCK_H__
+#define __SIMIL_SPIKECLOCK_H__
+
+#include "SpikeCursor.h"
+
+#include <simil/api.h>
+
+#include <vector>
+
+namespace simil
+{
+  /** \class SpikeClock
+   * \brief Time shared by several spike cursors, so that synchronized views
+   * of one simulation move together.
+   *
+   * The cursors are stored contiguously and addressed by the handle
+   * returned when they are added.
+   *
+   */
+  class SIMIL_API SpikeClock
+  {
+  public:
+
+    SpikeClock( void );
+
+    /** \brief SpikeClock class constructor.
+     * \param[in] startTime Start of the playback range.
+     * \param[in] endTime End of the playback range.
+     *
+     */
+    SpikeClock( float startTime, float endTime );
+
+    /** \brief Sets the playback range. Time is clamped to it unless the
+     * range is empty.
+     * \param[in] startTime Start of the playback range.
+     * \param[in] endTime End of the playback range.
+     *
+     */
+    void setRange( float startTime, float endTime );
+
+    float startTime( void ) const
+    {
+      return _startTime;
+    }
+
+    float endTime( void ) const
+    {
+      return _endTime;
+    }
+
+    float time( void ) const
+    {
+      return _time;
+    }
+
+    /** \brief Returns true once the clock has reached the end of its range.
+     *
+     */
+    bool finished( void ) const;
+
+    /** \brief Adds a cursor, seeked to the current time.
+     * \param[in] cursor Cursor to add.
+     * \return Handle of the cursor.
+     *
+     */
+    size_t add( const SpikeCursor& cursor );
+
+    SpikeCursor& cursor( size_t handle )
+    {
+      return _cursors[ handle ];
+    }
+
+    const SpikeCursor& cursor( size_t handle ) const
+    {
+      return _cursors[ handle ];
+    }
+
+    size_t size( void ) const
+    {
+      return _cursors.size( );
+    }
+
+    /** \brief Removes every cursor.
+     *
+     */
+    void clear( void );
+
+    /** \brief Moves the clock and its cursors to any time.
+     * \param[in] time New time.
+     *
+     */
+    void seek( float time );
+
+    /** \brief Moves the clock and its cursors forward.
+     * \param[in] deltaTime Time to move.
+     *
+     */
+    void advance( float deltaTime );
+
+  protected:
+
+    float clamp( float time ) const;
+
+    float _startTime;
+    float _endTime;
+    float _time;
+
+    std::vector< SpikeCursor > _cursors;
+  };
+}
+
+#endif /* __SIMIL_SPIKECLOCK_H__ */
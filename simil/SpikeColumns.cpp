@@ -0,0 +1,726 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "SpikeColumns.h"
+#include "SpikeKernels.h"
+#include "PackedSpikes.h"
+#include "SpikeSort.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+  using simil::PackedSpikes;
+
+  /** Decoded pack of a compressed chunk. */
+  struct DecodedPack
+  {
+    uint64_t key;
+    size_t size;
+    float times[ PackedSpikes::PACK_SIZE ];
+    uint32_t gids[ PackedSpikes::PACK_SIZE ];
+  };
+
+  /** Direct mapped cache of decoded packs, one per thread so readers never
+   * wait for each other. Keys combine the chunk serial and the pack. */
+  struct DecodeCache
+  {
+    enum { ENTRIES = 64 };
+    DecodedPack entries[ ENTRIES ];
+
+    DecodeCache( void )
+    {
+      for( auto& entry : entries )
+        entry.key = ~uint64_t( 0 );
+    }
+  };
+
+  const uint64_t PACKS_PER_CHUNK =
+    simil::SpikeColumns::CHUNK_SIZE / PackedSpikes::PACK_SIZE;
+
+  std::atomic< uint64_t > nextSerial( 0 );
+
+  const DecodedPack& decodePack( const PackedSpikes& packed, uint64_t serial,
+                                 size_t pack )
+  {
+    thread_local std::unique_ptr< DecodeCache > cache;
+    if( !cache )
+      cache.reset( new DecodeCache );
+
+    const uint64_t key = serial * PACKS_PER_CHUNK + pack;
+    DecodedPack& entry = cache->entries[ key % DecodeCache::ENTRIES ];
+    if( entry.key != key )
+    {
+      entry.size = packed.decode( pack, entry.times, entry.gids );
+      entry.key = key;
+    }
+
+    return entry;
+  }
+}
+
+namespace simil
+{
+  SpikeColumns::Chunk::Chunk( void )
+  : times( nullptr )
+  , gids( nullptr )
+  , serial( 0 )
+  { }
+
+  SpikeColumns::Chunk::~Chunk( void )
+  { }
+
+  SpikeColumns::ReadGuard::ReadGuard( const SpikeColumns& columns )
+  {
+    // The epoch may advance between reading it and registering, in which
+    // case the writer may not have seen this reader and it starts again.
+    while( true )
+    {
+      const uint64_t epoch = columns._epoch.load( );
+      _readers = &columns._readers[ epoch & 1 ];
+      _readers->fetch_add( 1 );
+      if( columns._epoch.load( ) == epoch )
+        return;
+      _readers->fetch_sub( 1 );
+    }
+  }
+
+  SpikeColumns::ReadGuard::~ReadGuard( void )
+  {
+    _readers->fetch_sub( 1 );
+  }
+
+  SpikeColumns::SpikeColumns( void )
+  : _blocks( new std::atomic< ChunkBlock* >[ MAX_BLOCKS ]( ))
+  , _size( 0 )
+  , _epoch( 0 )
+  , _compression( false )
+  , _compacted( 0 )
+  {
+    _readers[ 0 ].store( 0 );
+    _readers[ 1 ].store( 0 );
+  }
+
+  SpikeColumns::SpikeColumns( const TSpikes& spikes )
+  : SpikeColumns( )
+  {
+    append( spikes );
+  }
+
+  SpikeColumns::SpikeColumns( const SpikeColumns& other )
+  : SpikeColumns( )
+  {
+    *this = other;
+  }
+
+  SpikeColumns::SpikeColumns( SpikeColumns&& other )
+  : SpikeColumns( )
+  {
+    *this = std::move( other );
+  }
+
+  SpikeColumns::~SpikeColumns( void )
+  {
+    clear( );
+  }
+
+  SpikeColumns& SpikeColumns::operator=( const SpikeColumns& other )
+  {
+    if( this == &other )
+      return *this;
+
+    clear( );
+
+    const size_t count = other.size( );
+    reserve( count );
+    for( size_t position = 0; position < count; )
+    {
+      const auto source = other.run( position, count );
+      const size_t index = position >> CHUNK_BITS;
+      const size_t offset = position & ( CHUNK_SIZE - 1 );
+
+      Chunk* target = writableChunk( index );
+      for( size_t i = 0; i < source.size; ++i )
+        write( target, offset + i, source.times[ i ], source.gids[ i ]);
+      if( offset == 0 )
+        _blocks[ index >> BLOCK_BITS ].load( std::memory_order_relaxed )
+          ->firstTimes[ index & ( BLOCK_SIZE - 1 )].store(
+            source.times[ 0 ], std::memory_order_relaxed );
+
+      position += source.size;
+    }
+    _size.store( count, std::memory_order_release );
+
+    _compression = other._compression;
+    if( _compression )
+      compact( );
+
+    return *this;
+  }
+
+  SpikeColumns& SpikeColumns::operator=( SpikeColumns&& other )
+  {
+    if( this == &other )
+      return *this;
+
+    clear( );
+    std::swap( _blocks, other._blocks );
+    std::swap( _retired, other._retired );
+    std::swap( _reusable, other._reusable );
+    _epoch.store( std::max( _epoch.load( ), other._epoch.load( )));
+    std::swap( _compression, other._compression );
+    std::swap( _compacted, other._compacted );
+    std::swap( _external, other._external );
+    _size.store( other._size.load( std::memory_order_acquire ),
+                 std::memory_order_release );
+    other._size.store( 0, std::memory_order_release );
+
+    return *this;
+  }
+
+  SpikeColumns::Segment SpikeColumns::run( size_t position, size_t size ) const
+  {
+    const Chunk* chunk_ = chunk( position >> CHUNK_BITS );
+    const size_t offset = position & ( CHUNK_SIZE - 1 );
+
+    if( chunk_->times )
+      return Segment{ chunk_->times + offset, chunk_->gids + offset,
+        std::min( size - position, CHUNK_SIZE - offset )};
+
+    const size_t pack = offset / PackedSpikes::PACK_SIZE;
+    const size_t packOffset = offset % PackedSpikes::PACK_SIZE;
+    const auto& decoded = decodePack( *chunk_->packed, chunk_->serial, pack );
+
+    return Segment{ decoded.times + packOffset, decoded.gids + packOffset,
+      std::min( size - position, decoded.size - packOffset )};
+  }
+
+  Spike SpikeColumns::packedSpike( const Chunk* chunk_, size_t offset )
+  {
+    const auto& decoded = decodePack( *chunk_->packed, chunk_->serial,
+                                      offset / PackedSpikes::PACK_SIZE );
+    const size_t packOffset = offset % PackedSpikes::PACK_SIZE;
+    return Spike( decoded.times[ packOffset ], decoded.gids[ packOffset ]);
+  }
+
+  void SpikeColumns::setCompression( bool compression_ )
+  {
+    _compression = compression_;
+    if( _compression )
+      compact( );
+  }
+
+  void SpikeColumns::compact( void )
+  {
+    const size_t fullChunks = _size.load( std::memory_order_relaxed ) >> CHUNK_BITS;
+
+    for( size_t index = _compacted; index < fullChunks; ++index )
+    {
+      const Chunk* source = chunk( index );
+      if( !source->times )
+        continue;
+
+      Chunk* target = new Chunk;
+      target->packed.reset(
+        new PackedSpikes( source->times, source->gids, CHUNK_SIZE ));
+      target->serial = nextSerial++;
+      std::copy( source->fences, source->fences + CHUNK_SIZE / FENCE_STRIDE,
+                 target->fences );
+
+      publishChunk( index, target );
+    }
+
+    _compacted = std::max( _compacted, fullChunks );
+    reclaim( );
+  }
+
+  size_t SpikeColumns::memoryUsage( void ) const
+  {
+    ReadGuard guard( *this );
+
+    size_t bytes = 0;
+    for( size_t b = 0; b < MAX_BLOCKS; ++b )
+    {
+      const ChunkBlock* block = _blocks[ b ].load( std::memory_order_acquire );
+      if( !block )
+        continue;
+
+      bytes += sizeof( ChunkBlock );
+      for( const auto& slot : block->chunks )
+      {
+        const Chunk* chunk_ = slot.load( std::memory_order_acquire );
+        if( !chunk_ )
+          continue;
+
+        bytes += sizeof( Chunk );
+        if( chunk_->timeStorage )
+          bytes += CHUNK_SIZE * ( sizeof( float ) + sizeof( uint32_t ));
+        if( chunk_->packed )
+          bytes += chunk_->packed->bytes( );
+      }
+    }
+
+    return bytes;
+  }
+
+  void SpikeColumns::adopt( const float* times, const uint32_t* gids,
+                            const float* fences, size_t count,
+                            std::shared_ptr< const void > owner )
+  {
+    clear( );
+
+    const size_t fullChunks = count >> CHUNK_BITS;
+    const size_t chunkFences = CHUNK_SIZE / FENCE_STRIDE;
+    for( size_t index = 0; index < fullChunks; ++index )
+    {
+      Chunk* chunk_ = new Chunk;
+      chunk_->times = const_cast< float* >( times + ( index << CHUNK_BITS ));
+      chunk_->gids = const_cast< uint32_t* >( gids + ( index << CHUNK_BITS ));
+      std::copy( fences + index * chunkFences,
+                 fences + ( index + 1 ) * chunkFences, chunk_->fences );
+      publishChunk( index, chunk_ );
+    }
+
+    const size_t first = fullChunks << CHUNK_BITS;
+    if( first < count )
+    {
+      Chunk* chunk_ = writableChunk( fullChunks );
+      for( size_t i = first; i < count; ++i )
+        write( chunk_, i - first, times[ i ], gids[ i ]);
+      _blocks[ fullChunks >> BLOCK_BITS ].load( std::memory_order_relaxed )
+        ->firstTimes[ fullChunks & ( BLOCK_SIZE - 1 )].store(
+          times[ first ], std::memory_order_relaxed );
+    }
+
+    _external = std::move( owner );
+    _size.store( count, std::memory_order_release );
+
+    if( _compression )
+      compact( );
+  }
+
+  void SpikeColumns::reserve( size_t count )
+  {
+    for( size_t c = 0; c < chunkCount( count ); ++c )
+      writableChunk( c );
+  }
+
+  void SpikeColumns::clear( void )
+  {
+    _size.store( 0, std::memory_order_release );
+    _compacted = 0;
+
+    if( !_blocks )
+      return;
+
+    for( size_t b = 0; b < MAX_BLOCKS; ++b )
+    {
+      ChunkBlock* block = _blocks[ b ].exchange( nullptr );
+      if( !block )
+        continue;
+
+      for( auto& chunk_ : block->chunks )
+        delete chunk_.load( std::memory_order_relaxed );
+
+      delete block;
+    }
+
+    for( const auto& retired : _retired )
+      delete retired.second;
+    _retired.clear( );
+
+    for( auto chunk_ : _reusable )
+      delete chunk_;
+    _reusable.clear( );
+
+    _external.reset( );
+  }
+
+  SpikeColumns::ChunkBlock* SpikeColumns::writableBlock( size_t index )
+  {
+    const size_t blockIndex = index >> BLOCK_BITS;
+    if( blockIndex >= MAX_BLOCKS )
+      throw std::runtime_error( "SpikeColumns: spike capacity exceeded." );
+
+    ChunkBlock* block = _blocks[ blockIndex ].load( std::memory_order_relaxed );
+    if( !block )
+    {
+      block = new ChunkBlock( );
+      _blocks[ blockIndex ].store( block, std::memory_order_release );
+    }
+
+    return block;
+  }
+
+  SpikeColumns::Chunk* SpikeColumns::writableChunk( size_t index )
+  {
+    auto& slot = writableBlock( index )->chunks[ index & ( BLOCK_SIZE - 1 )];
+    Chunk* chunk_ = slot.load( std::memory_order_relaxed );
+    if( !chunk_ )
+    {
+      chunk_ = freshChunk( );
+      slot.store( chunk_, std::memory_order_release );
+    }
+
+    return chunk_;
+  }
+
+  SpikeColumns::Chunk* SpikeColumns::freshChunk( void )
+  {
+    if( _reusable.empty( ))
+      reclaim( );
+
+    if( !_reusable.empty( ))
+    {
+      Chunk* chunk_ = _reusable.back( );
+      _reusable.pop_back( );
+      return chunk_;
+    }
+
+    Chunk* chunk_ = new Chunk;
+    chunk_->timeStorage.reset( new float[ CHUNK_SIZE ]);
+    chunk_->gidStorage.reset( new uint32_t[ CHUNK_SIZE ]);
+    chunk_->times = chunk_->timeStorage.get( );
+    chunk_->gids = chunk_->gidStorage.get( );
+    return chunk_;
+  }
+
+  void SpikeColumns::publishChunk( size_t index, Chunk* chunk_ )
+  {
+    ChunkBlock* block = writableBlock( index );
+    auto& slot = block->chunks[ index & ( BLOCK_SIZE - 1 )];
+
+    Chunk* replaced = slot.load( std::memory_order_relaxed );
+    block->firstTimes[ index & ( BLOCK_SIZE - 1 )].store(
+      chunk_->fences[ 0 ], std::memory_order_relaxed );
+    slot.store( chunk_, std::memory_order_release );
+
+    if( replaced )
+      _retired.emplace_back( _epoch.load( ), replaced );
+  }
+
+  void SpikeColumns::reclaim( void )
+  {
+    if( _retired.empty( ))
+      return;
+
+    // Two advances make everything retired so far reclaimable, each one
+    // possible once no reader of the epoch before the current is left.
+    uint64_t epoch = _epoch.load( );
+    for( int step = 0; step < 2 && _retired.back( ).first + 2 > epoch; ++step )
+    {
+      if( _readers[( epoch + 1 ) & 1 ].load( ) != 0 )
+        break;
+      _epoch.store( ++epoch );
+    }
+
+    while( !_retired.empty( ) && _retired.front( ).first + 2 <= epoch )
+    {
+      Chunk* chunk_ = _retired.front( ).second;
+      _retired.pop_front( );
+
+      // Compressed and adopted chunks have no columns to reuse.
+      if( chunk_->timeStorage )
+        _reusable.push_back( chunk_ );
+      else
+        delete chunk_;
+    }
+  }
+
+  void SpikeColumns::push_back( float time_, uint32_t gid_ )
+  {
+    const size_t position = _size.load( std::memory_order_relaxed );
+    const size_t index = position >> CHUNK_BITS;
+    const size_t offset = position & ( CHUNK_SIZE - 1 );
+
+    Chunk* chunk_ = writableChunk( index );
+    write( chunk_, offset, time_, gid_ );
+    if( offset == 0 )
+      _blocks[ index >> BLOCK_BITS ].load( std::memory_order_relaxed )
+        ->firstTimes[ index & ( BLOCK_SIZE - 1 )].store(
+          time_, std::memory_order_relaxed );
+
+    _size.store( position + 1, std::memory_order_release );
+  }
+
+  void SpikeColumns::append( const TSpikes& spikes )
+  {
+    if( spikes.empty( ))
+      return;
+
+    const auto byTime = []( const Spike& a, const Spike& b )
+    {
+      return a.first < b.first;
+    };
+
+    const size_t count = _size.load( std::memory_order_relaxed );
+
+    // Streams deliver sorted batches almost always, so this is the only
+    // check made on the common path.
+    if( std::is_sorted( spikes.cbegin( ), spikes.cend( ), byTime ))
+    {
+      if( count == 0 || spikes.front( ).first >= time( count - 1 ))
+        appendSorted( spikes.cbegin( ), spikes.cend( ));
+      else
+        mergeSorted( spikes.cbegin( ), spikes.cend( ));
+      return;
+    }
+
+    TSpikes sorted( spikes );
+    sortSpikes( sorted );
+
+    if( count == 0 || sorted.front( ).first >= time( count - 1 ))
+      appendSorted( sorted.cbegin( ), sorted.cend( ));
+    else
+      mergeSorted( sorted.cbegin( ), sorted.cend( ));
+  }
+
+  void SpikeColumns::appendSorted( TSpikes::const_iterator first,
+                                   TSpikes::const_iterator last )
+  {
+    size_t position = _size.load( std::memory_order_relaxed );
+
+    while( first != last )
+    {
+      const size_t index = position >> CHUNK_BITS;
+      const size_t offset = position & ( CHUNK_SIZE - 1 );
+      const size_t count = std::min(
+        static_cast< size_t >( CHUNK_SIZE ) - offset,
+        static_cast< size_t >( last - first ));
+
+      Chunk* chunk_ = writableChunk( index );
+      for( size_t i = 0; i < count; ++i, ++first )
+        write( chunk_, offset + i, first->first, first->second );
+      if( offset == 0 )
+        _blocks[ index >> BLOCK_BITS ].load( std::memory_order_relaxed )
+          ->firstTimes[ index & ( BLOCK_SIZE - 1 )].store(
+            chunk_->times[ 0 ], std::memory_order_relaxed );
+
+      position += count;
+    }
+
+    _size.store( position, std::memory_order_release );
+
+    if( _compression )
+      compact( );
+  }
+
+  void SpikeColumns::mergeSorted( TSpikes::const_iterator first,
+                                  TSpikes::const_iterator last )
+  {
+    const size_t count = _size.load( std::memory_order_relaxed );
+
+    // Stored spikes with the same time as a merged one keep going first.
+    const size_t position = upperBound( first->first );
+    const size_t firstChunk = position >> CHUNK_BITS;
+
+    std::vector< Chunk* > replacements;
+    size_t output = firstChunk << CHUNK_BITS;
+    const auto emit = [ & ]( float time_, uint32_t gid_ )
+    {
+      const size_t offset = output & ( CHUNK_SIZE - 1 );
+      if( offset == 0 )
+        replacements.push_back( freshChunk( ));
+      write( replacements.back( ), offset, time_, gid_ );
+      ++output;
+    };
+
+    // The untouched head of the first chunk is copied as is.
+    while( output < position )
+    {
+      const auto source = run( output, position );
+      const size_t offset = output & ( CHUNK_SIZE - 1 );
+      if( offset == 0 )
+        replacements.push_back( freshChunk( ));
+
+      Chunk* target = replacements.back( );
+      std::copy( source.times, source.times + source.size,
+                 target->times + offset );
+      std::copy( source.gids, source.gids + source.size,
+                 target->gids + offset );
+      for( size_t i = ( offset + FENCE_STRIDE - 1 ) / FENCE_STRIDE * FENCE_STRIDE;
+           i < offset + source.size; i += FENCE_STRIDE )
+        target->fences[ i / FENCE_STRIDE ] = target->times[ i ];
+
+      output += source.size;
+    }
+
+    size_t stored = position;
+    while( stored < count && first != last )
+    {
+      if( first->first < time( stored ))
+      {
+        emit( first->first, first->second );
+        ++first;
+      }
+      else
+      {
+        emit( time( stored ), gid( stored ));
+        ++stored;
+      }
+    }
+    for( ; stored < count; ++stored )
+      emit( time( stored ), gid( stored ));
+    for( ; first != last; ++first )
+      emit( first->first, first->second );
+
+    for( size_t i = 0; i < replacements.size( ); ++i )
+      publishChunk( firstChunk + i, replacements[ i ]);
+
+    _size.store( output, std::memory_order_release );
+
+    _compacted = std::min( _compacted, firstChunk );
+    if( _compression )
+      compact( );
+    else
+      reclaim( );
+  }
+
+  template< bool inclusive >
+  size_t SpikeColumns::bound( float time_, size_t first ) const
+  {
+    ReadGuard guard( *this );
+
+    const size_t count = size( );
+    if( first >= count )
+      return count;
+
+    // Chunks whose first spike already satisfies the bound are skipped by
+    // a binary search over the first time of every chunk.
+    size_t low = ( first >> CHUNK_BITS ) + 1;
+    size_t high = chunkCount( count );
+    while( low < high )
+    {
+      const size_t middle = low + ( high - low ) / 2;
+      const float fence = firstTime( middle );
+      if( inclusive ? fence <= time_ : fence < time_ )
+        low = middle + 1;
+      else
+        high = middle;
+    }
+
+    const size_t index = low - 1;
+    const size_t chunkStart = index << CHUNK_BITS;
+    const Chunk* chunk_ = chunk( index );
+    const size_t chunkSize = std::min( count - chunkStart,
+                                       static_cast< size_t >( CHUNK_SIZE ));
+    const size_t numFences = ( chunkSize + FENCE_STRIDE - 1 ) / FENCE_STRIDE;
+
+    const auto search = []( const float* values, size_t size_, float value )
+    {
+      return inclusive ? kernels::upperBound( values, size_, value )
+                       : kernels::lowerBound( values, size_, value );
+    };
+
+    // Spikes up to the previous fence satisfy the bound, and the spike at
+    // the next fence, if any, does not.
+    const size_t fence = search( chunk_->fences, numFences, time_ );
+    const size_t windowFirst = fence > 0 ? ( fence - 1 ) * FENCE_STRIDE + 1 : 0;
+    const size_t windowLast = std::min( fence * FENCE_STRIDE + 1, chunkSize );
+
+    // The window may span two runs of a compressed chunk.
+    size_t result = chunkStart + windowFirst;
+    const size_t end = chunkStart + windowLast;
+    while( result < end )
+    {
+      const auto window = run( result, end );
+      const size_t found = search( window.times, window.size, time_ );
+      result += found;
+      if( found < window.size )
+        break;
+    }
+
+    // On sorted data the bound from first is the global bound clamped.
+    return std::max( result, first );
+  }
+
+  size_t SpikeColumns::lowerBound( float time_, size_t first ) const
+  {
+    return bound< false >( time_, first );
+  }
+
+  size_t SpikeColumns::upperBound( float time_, size_t first ) const
+  {
+    return bound< true >( time_, first );
+  }
+
+  size_t SpikeColumns::countBetween( float startTime, float endTime ) const
+  {
+    if( endTime <= startTime )
+      return 0;
+
+    const size_t first = lowerBound( startTime );
+    return lowerBound( endTime, first ) - first;
+  }
+
+  void SpikeColumns::gidsBetween( float startTime, float endTime,
+                                  std::vector< uint32_t >& result ) const
+  {
+    if( endTime <= startTime )
+    {
+      result.clear( );
+      return;
+    }
+
+    const size_t first = lowerBound( startTime );
+    gidsRange( first, lowerBound( endTime, first ), result );
+  }
+
+  void SpikeColumns::gidsRange( size_t first, size_t last,
+                                std::vector< uint32_t >& result ) const
+  {
+    result.clear( );
+    last = std::min( last, size( ));
+    if( last <= first )
+      return;
+
+    ReadGuard guard( *this );
+
+    result.reserve( last - first );
+    while( first < last )
+    {
+      const auto run_ = run( first, last );
+      result.insert( result.end( ), run_.gids, run_.gids + run_.size );
+      first += run_.size;
+    }
+  }
+
+  TSpikes SpikeColumns::toPairs( void ) const
+  {
+    ReadGuard guard( *this );
+
+    const size_t count = size( );
+
+    TSpikes result;
+    result.reserve( count );
+    for( size_t position = 0; position < count; )
+    {
+      const auto run_ = run( position, count );
+      for( size_t i = 0; i < run_.size; ++i )
+        result.emplace_back( run_.times[ i ], run_.gids[ i ]);
+      position += run_.size;
+    }
+
+    return result;
+  }
+}
@@ -0,0 +1,425 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef __SIMIL_SPIKECOLUMNS_H__
+#define __SIMIL_SPIKECOLUMNS_H__
+
+#include "types.h"
+#include <simil/api.h>
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace simil
+{
+  class PackedSpikes;
+
+  /** \class SpikeColumns
+   * \brief Time sorted spikes stored as two parallel columns, one with the
+   * times and another one with the gids, so time scans only touch the
+   * times and can be vectorized.
+   *
+   * Columns are split in fixed size chunks that are never reallocated, and
+   * the number of spikes is published atomically once the appended values
+   * are in place. One writer thread can append while any number of reader
+   * threads access the spikes below size() without locking. Positions stay
+   * valid while the container grows. Clearing, copying or assigning the
+   * container requires that no reader is active.
+   *
+   * Spikes older than the last stored one are merged into place by
+   * rewriting only the affected tail chunks into new ones. Positions after
+   * the merge point shift by the number of merged spikes.
+   *
+   * Full chunks can be compressed (see PackedSpikes), either on demand with
+   * compact() or as they fill up after setCompression( true ). Compressed
+   * spikes are decoded one pack at a time into a small per thread cache.
+   *
+   * Chunks replaced by merges and compression are retired and only reused
+   * or freed once every reader that could still hold them has finished,
+   * tracked with two reader epochs. The searches and range copies below
+   * protect themselves. Element accessors, iterators and run() do not:
+   * readers using them while the writer merges or compacts must hold a
+   * ReadGuard for as long as they use what they read.
+   *
+   */
+  class SIMIL_API SpikeColumns
+  {
+  public:
+
+    enum : size_t
+    {
+      CHUNK_BITS = 16,
+      CHUNK_SIZE = size_t( 1 ) << CHUNK_BITS,
+      BLOCK_BITS = 10,
+      BLOCK_SIZE = size_t( 1 ) << BLOCK_BITS,
+      MAX_BLOCKS = 1024,
+      FENCE_STRIDE = 32
+    };
+
+    /** \class ReadGuard
+     * \brief Keeps the chunks seen by the calling thread alive while it
+     * exists. Guards can be nested and should be short lived, as retired
+     * chunks are not reclaimed while a guard taken before their
+     * replacement exists.
+     *
+     */
+    class SIMIL_API ReadGuard
+    {
+    public:
+
+      explicit ReadGuard( const SpikeColumns& columns );
+      ~ReadGuard( void );
+
+      ReadGuard( const ReadGuard& ) = delete;
+      ReadGuard& operator=( const ReadGuard& ) = delete;
+
+    private:
+
+      std::atomic< size_t >* _readers;
+    };
+
+    /** \brief Contiguous run of spikes. Runs of compressed chunks point to
+     * the decode cache of the calling thread and are only valid until its
+     * next access to compressed spikes.
+     *
+     */
+    struct Segment
+    {
+      const float* times;
+      const uint32_t* gids;
+      size_t size;
+    };
+
+    SpikeColumns( void );
+
+    /** \brief SpikeColumns class constructor.
+     * \param[in] spikes Time sorted spikes.
+     *
+     */
+    explicit SpikeColumns( const TSpikes& spikes );
+
+    SpikeColumns( const SpikeColumns& other );
+    SpikeColumns( SpikeColumns&& other );
+    SpikeColumns& operator=( const SpikeColumns& other );
+    SpikeColumns& operator=( SpikeColumns&& other );
+    ~SpikeColumns( void );
+
+    /** \brief Returns the number of published spikes.
+     *
+     */
+    size_t size( void ) const
+    {
+      return _size.load( std::memory_order_acquire );
+    }
+
+    bool empty( void ) const
+    {
+      return size( ) == 0;
+    }
+
+    float time( size_t i ) const
+    {
+      const Chunk* chunk_ = chunk( i >> CHUNK_BITS );
+      return chunk_->times ? chunk_->times[ i & ( CHUNK_SIZE - 1 )] :
+        packedSpike( chunk_, i & ( CHUNK_SIZE - 1 )).first;
+    }
+
+    uint32_t gid( size_t i ) const
+    {
+      const Chunk* chunk_ = chunk( i >> CHUNK_BITS );
+      return chunk_->gids ? chunk_->gids[ i & ( CHUNK_SIZE - 1 )] :
+        packedSpike( chunk_, i & ( CHUNK_SIZE - 1 )).second;
+    }
+
+    Spike spike( size_t i ) const
+    {
+      const Chunk* chunk_ = chunk( i >> CHUNK_BITS );
+      const size_t offset = i & ( CHUNK_SIZE - 1 );
+      return chunk_->times ?
+        Spike( chunk_->times[ offset ], chunk_->gids[ offset ]) :
+        packedSpike( chunk_, offset );
+    }
+
+    /** \brief Returns the number of chunks holding the first size spikes.
+     * \param[in] size Number of spikes, usually a snapshot of size().
+     *
+     */
+    static size_t chunkCount( size_t size )
+    {
+      return ( size + CHUNK_SIZE - 1 ) >> CHUNK_BITS;
+    }
+
+    /** \brief Returns the longest contiguous run of spikes that starts at
+     * the given position and ends before the given size.
+     * \param[in] position Position of the first spike of the run.
+     * \param[in] size Number of spikes, usually a snapshot of size().
+     *
+     */
+    Segment run( size_t position, size_t size ) const;
+
+    /** \brief Enables or disables compressing chunks as they fill up.
+     * Enabling it compresses the full chunks already stored. Writer thread
+     * only.
+     *
+     */
+    void setCompression( bool compression );
+
+    bool compression( void ) const
+    {
+      return _compression;
+    }
+
+    /** \brief Compresses every full chunk that is not compressed yet.
+     * Replaced chunks are retired like merged ones. Writer thread only.
+     *
+     */
+    void compact( void );
+
+    /** \brief Returns the bytes used by the stored chunks.
+     *
+     */
+    size_t memoryUsage( void ) const;
+
+    /** \brief Replaces the contents with external time sorted columns,
+     * without copying them. Only the last, partial, chunk is copied so that
+     * spikes can still be appended. Writer thread only.
+     * \param[in] times Time column.
+     * \param[in] gids Gid column.
+     * \param[in] fences Time of every FENCE_STRIDE-th spike.
+     * \param[in] count Number of spikes.
+     * \param[in] owner Keeps the columns alive while they are referenced.
+     *
+     */
+    void adopt( const float* times, const uint32_t* gids, const float* fences,
+                size_t count, std::shared_ptr< const void > owner );
+
+    /** \brief Preallocates the chunks needed to hold count spikes. Writer
+     * thread only.
+     *
+     */
+    void reserve( size_t count );
+
+    /** \brief Removes all the spikes and releases the chunks. Must not be
+     * called while there are active readers.
+     *
+     */
+    void clear( void );
+
+    /** \brief Appends a spike. The caller must keep the time order. Writer
+     * thread only.
+     *
+     */
+    void push_back( float time, uint32_t gid );
+
+    /** \brief Adds the given spikes and publishes them at once. Batches in
+     * time order that start after the last stored spike are appended
+     * directly; otherwise the batch is sorted and merged with the stored
+     * tail. Writer thread only.
+     * \param[in] spikes Spikes to add, in any order.
+     *
+     */
+    void append( const TSpikes& spikes );
+
+    /** \brief Returns the index of the first spike whose time is not less
+     * than the given time, or size() if there is none.
+     * \param[in] time Time to look for.
+     * \param[in] first Index where the search starts.
+     *
+     */
+    size_t lowerBound( float time, size_t first = 0 ) const;
+
+    /** \brief Returns the index of the first spike whose time is greater
+     * than the given time, or size() if there is none.
+     * \param[in] time Time to look for.
+     * \param[in] first Index where the search starts.
+     *
+     */
+    size_t upperBound( float time, size_t first = 0 ) const;
+
+    /** \brief Returns the number of spikes in the [startTime, endTime)
+     * window.
+     *
+     */
+    size_t countBetween( float startTime, float endTime ) const;
+
+    /** \brief Fills the given vector with the gids of the spikes in the
+     * [startTime, endTime) window.
+     *
+     */
+    void gidsBetween( float startTime, float endTime,
+                      std::vector< uint32_t >& result ) const;
+
+    /** \brief Fills the given vector with the gids of the spikes in the
+     * [first, last) positions.
+     *
+     */
+    void gidsRange( size_t first, size_t last,
+                    std::vector< uint32_t >& result ) const;
+
+    /** \brief Returns a copy of the spikes as time-gid pairs.
+     *
+     */
+    TSpikes toPairs( void ) const;
+
+  protected:
+
+    /** Each chunk samples one time every FENCE_STRIDE spikes, so searches
+     * inside a chunk touch a small fence array and a single short window.
+     * Plain chunks point to their columns, either owned or adopted, and
+     * compressed ones have null column pointers and a packed copy,
+     * identified in decode caches by serial. Adopted columns are read only,
+     * writes only reach owned chunks. */
+    struct Chunk
+    {
+      Chunk( void );
+      ~Chunk( void );
+
+      float* times;
+      uint32_t* gids;
+      std::unique_ptr< float[] > timeStorage;
+      std::unique_ptr< uint32_t[] > gidStorage;
+
+      std::unique_ptr< PackedSpikes > packed;
+      uint64_t serial;
+
+      float fences[ CHUNK_SIZE / FENCE_STRIDE ];
+    };
+
+    struct ChunkBlock
+    {
+      std::atomic< Chunk* > chunks[ BLOCK_SIZE ];
+
+      // Time of the first spike of each chunk, written before the spike
+      // is published. Merges may rewrite it for a published chunk.
+      std::atomic< float > firstTimes[ BLOCK_SIZE ];
+    };
+
+    const Chunk* chunk( size_t index ) const
+    {
+      return _blocks[ index >> BLOCK_BITS ].load( std::memory_order_acquire )
+        ->chunks[ index & ( BLOCK_SIZE - 1 )].load( std::memory_order_acquire );
+    }
+
+    float firstTime( size_t index ) const
+    {
+      return _blocks[ index >> BLOCK_BITS ].load( std::memory_order_acquire )
+        ->firstTimes[ index & ( BLOCK_SIZE - 1 )].load(
+          std::memory_order_relaxed );
+    }
+
+    /** \brief Returns the chunk with the given index, allocating it and its
+     * block if needed. Writer thread only.
+     *
+     */
+    Chunk* writableChunk( size_t index );
+
+    /** \brief Returns the directory block holding the given chunk,
+     * allocating it if needed. Writer thread only.
+     *
+     */
+    ChunkBlock* writableBlock( size_t index );
+
+    /** \brief Returns an unpublished chunk, reusing reclaimed chunks when
+     * there are. Writer thread only.
+     *
+     */
+    Chunk* freshChunk( void );
+
+    /** \brief Replaces a published chunk, retiring the previous one.
+     * Writer thread only.
+     *
+     */
+    void publishChunk( size_t index, Chunk* chunk );
+
+    /** \brief Advances the reader epoch when the readers of the previous
+     * one have finished, and reclaims the retired chunks no reader can
+     * hold anymore. Owned columns are kept for reuse and the rest of the
+     * chunks are freed. Writer thread only.
+     *
+     */
+    void reclaim( void );
+
+    /** \brief Returns a spike of a compressed chunk.
+     *
+     */
+    static Spike packedSpike( const Chunk* chunk, size_t offset );
+
+    /** \brief Appends a time sorted range whose first spike is not older
+     * than the last stored one. Writer thread only.
+     *
+     */
+    void appendSorted( TSpikes::const_iterator first,
+                       TSpikes::const_iterator last );
+
+    /** \brief Merges a time sorted range with the stored spikes, replacing
+     * the chunks from the first affected one. Writer thread only.
+     *
+     */
+    void mergeSorted( TSpikes::const_iterator first,
+                      TSpikes::const_iterator last );
+
+    /** \brief Writes a spike in a chunk, together with its fence if it
+     * starts a fence window. Writer thread only.
+     *
+     */
+    void write( Chunk* chunk, size_t offset, float time, uint32_t gid )
+    {
+      chunk->times[ offset ] = time;
+      chunk->gids[ offset ] = gid;
+      if( offset % FENCE_STRIDE == 0 )
+        chunk->fences[ offset / FENCE_STRIDE ] = time;
+    }
+
+    template< bool inclusive >
+    size_t bound( float time, size_t first ) const;
+
+    std::unique_ptr< std::atomic< ChunkBlock* >[] > _blocks;
+    std::atomic< size_t > _size;
+
+    // Chunks replaced by merges and compression, oldest first, with the
+    // reader epoch in which they were replaced.
+    std::deque< std::pair< uint64_t, Chunk* >> _retired;
+
+    // Reclaimed chunks with owned columns, ready to be reused.
+    std::vector< Chunk* > _reusable;
+
+    // Readers register in the counter of the epoch they start in. A
+    // chunk retired in epoch e is reclaimed from epoch e + 2 on, as the
+    // epoch only advances once the readers of the one before are gone.
+    std::atomic< uint64_t > _epoch;
+    mutable std::atomic< size_t > _readers[ 2 ];
+
+    bool _compression;
+
+    // Chunks below this one are compressed when compression is enabled.
+    size_t _compacted;
+
+    // Owner of the adopted columns.
+    std::shared_ptr< const void > _external;
+  };
+}
+
+#endif /* __SIMIL_SPIKECOLUMNS_H__ */
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "SpikeCursor.h"
+
+#include <utility>
+
+namespace simil
+{
+  SpikeCursor::SpikeCursor( void )
+  : _spikes( nullptr )
+  , _time( 0.0f )
+  , _window( 0.0f )
+  , _first( 0 )
+  , _last( 0 )
+  { }
+
+  SpikeCursor::SpikeCursor( std::shared_ptr< const SpikeData > data,
+                            float window )
+  : _data( std::move( data ))
+  , _spikes( _data ? &_data->spikes( ) : nullptr )
+  , _time( 0.0f )
+  , _window( window > 0.0f ? window : 0.0f )
+  , _first( 0 )
+  , _last( 0 )
+  {
+    seek( _time );
+  }
+
+  void SpikeCursor::setWindow( float window )
+  {
+    _window = window > 0.0f ? window : 0.0f;
+    seek( _time );
+  }
+
+  void SpikeCursor::seek( float time )
+  {
+    _time = time;
+    if( !_spikes )
+      return;
+
+    if( _window > 0.0f )
+    {
+      _first = _spikes->lowerBound( time - _window );
+      _last = _spikes->lowerBound( time, _first );
+    }
+    else
+    {
+      _last = _spikes->lowerBound( time );
+      _first = _last;
+    }
+  }
+
+  void SpikeCursor::advance( float time )
+  {
+    if( !_spikes || time < _time || _last > _spikes->size( ))
+    {
+      seek( time );
+      return;
+    }
+
+    const size_t previous = _last;
+    _last = _spikes->lowerBound( time, _last );
+    _first = _window > 0.0f ?
+      _spikes->lowerBound( time - _window, _first ) : previous;
+    _time = time;
+  }
+
+  void SpikeCursor::gids( std::vector< uint32_t >& result ) const
+  {
+    if( !_spikes )
+    {
+      result.clear( );
+      return;
+    }
+
+    _spikes->gidsRange( _first, _last, result );
+  }
+}
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef __SIMIL_SPIKECURSOR_H__
+#define __SIMIL_SPIKECURSOR_H__
+
+#include "SpikeData.h"
+
+#include <simil/api.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace simil
+{
+  /** \class SpikeCursor
+   * \brief Read position over the spikes of a SpikeData, for views that
+   * play the same data without a player of their own.
+   *
+   * A cursor holds the range of spikes of its time window and a shared
+   * reference to the data, so copying it is cheap and never copies spikes.
+   * With a window the range is [time - window, time). Without one it is the
+   * spikes between the previous time and the current one, as a player
+   * frame.
+   *
+   * Positions stay valid when spikes are appended at the end. If spikes are
+   * inserted before them or replaced, the cursor must be seeked again.
+   *
+   */
+  class SIMIL_API SpikeCursor
+  {
+  public:
+
+    SpikeCursor( void );
+
+    /** \brief SpikeCursor class constructor. The cursor starts at time 0.
+     * \param[in] data Spike data to read.
+     * \param[in] window Length of the time window, zero to follow frames.
+     *
+     */
+    explicit SpikeCursor( std::shared_ptr< const SpikeData > data,
+                          float window = 0.0f );
+
+    /** \brief Sets the length of the time window and seeks again.
+     * \param[in] window Length of the time window, zero to follow frames.
+     *
+     */
+    void setWindow( float window );
+
+    float window( void ) const
+    {
+      return _window;
+    }
+
+    /** \brief Moves the cursor to any time. Without a window the range is
+     * left empty.
+     * \param[in] time New time.
+     *
+     */
+    void seek( float time );
+
+    /** \brief Moves the cursor forward, searching only from its current
+     * positions. Moving backwards seeks instead.
+     * \param[in] time New time.
+     *
+     */
+    void advance( float time );
+
+    float time( void ) const
+    {
+      return _time;
+    }
+
+    bool valid( void ) const
+    {
+      return _spikes != nullptr;
+    }
+
+    const std::shared_ptr< const SpikeData >& data( void ) const
+    {
+      return _data;
+    }
+
+    const Spikes& spikes( void ) const
+    {
+      return *_spikes;
+    }
+
+    /** \brief Returns the position of the first spike of the range.
+     *
+     */
+    size_t first( void ) const
+    {
+      return _first;
+    }
+
+    /** \brief Returns the position after the last spike of the range.
+     *
+     */
+    size_t last( void ) const
+    {
+      return _last;
+    }
+
+    size_t size( void ) const
+    {
+      return _last - _first;
+    }
+
+    bool empty( void ) const
+    {
+      return _last == _first;
+    }
+
+    /** \brief Returns an iterator to the first spike of the range. While
+     * spikes are merged or compressed, dereference the iterators under a
+     * Spikes::ReadGuard.
+     *
+     */
+    Spikes::const_iterator begin( void ) const
+    {
+      return Spikes::const_iterator( _spikes, _first );
+    }
+
+    Spikes::const_iterator end( void ) const
+    {
+      return Spikes::const_iterator( _spikes, _last );
+    }
+
+    /** \brief Returns the gids of the spikes of the range.
+     * \param[out] result Gids, in time order.
+     *
+     */
+    void gids( std::vector< uint32_t >& result ) const;
+
+  protected:
+
+    std::shared_ptr< const SpikeData > _data;
+    const Spikes* _spikes;
+
+    float _time;
+    float _window;
+
+    size_t _first;
+    size_t _last;
+  };
+}
+
+#endif /* __SIMIL_SPIKECURSOR_H__ */
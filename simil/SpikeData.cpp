@@ -20,13 +20,17 @@
  *
  */
 #include "SpikeData.h"
+#include "GIDFilter.h"
 
 #include "loaders/auxiliar/H5Activity.h"
 
+#include <algorithm>
+
 namespace simil
 {
 SpikeData::SpikeData()
 : SimulationData()
+, _modifiedFrom( std::numeric_limits< float >::infinity( ))
 {
     _simulationType = simil::TSimSpikes;
 }
@@ -45,6 +49,7 @@ SpikeData::SpikeData()
     SpikeData::SpikeData( const std::string& filePath_, TDataType dataType,
                         const std::string& report )
     : SimulationData( filePath_, dataType, report )
+    , _modifiedFrom( std::numeric_limits< float >::infinity( ))
   {
     _simulationType = simil::TSimSpikes;
 
@@ -104,6 +109,16 @@ SpikeData::SpikeData()
 
         break;
       }
+      case TBINARY:
+      {
+        // The spikes reference the mapped file, nothing is parsed.
+        _spikes = _binaryContainer->spikes( );
+
+        _startTime = _binaryContainer->startTime( );
+        _endTime = _binaryContainer->endTime( );
+
+        break;
+      }
       default:
         break;
     }
@@ -112,32 +127,44 @@ SpikeData::SpikeData()
   void SpikeData::setSpikes( Spikes spikes )
   {
     _isDirty=true;
-    _spikes = spikes;
+    _modifiedFrom = -std::numeric_limits< float >::infinity( );
+    _spikes = std::move( spikes );
+    resetSpikeTrains( );
+    resetActivityPyramids( );
+    resetRateEngines( );
   }
 
   void SpikeData::clear()
   {
     _isDirty = true;
+    _modifiedFrom = -std::numeric_limits< float >::infinity( );
     _spikes.clear();
+    resetSpikeTrains( );
+    resetActivityPyramids( );
+    resetRateEngines( );
     _startTime = _endTime = 0;
   }
 
   void SpikeData::reduceDataToGIDS( void )
   {
     _isDirty = true;
+    _modifiedFrom = -std::numeric_limits< float >::infinity( );
     const auto before = _spikes.size();
     std::cout << "Reduce - Before: " << before;
-    TSpikes aux;
-    aux.reserve( _spikes.size( ) );
-    for ( auto spike : _spikes )
-      if ( _gids.find( spike.second ) != _gids.end( ) )
-        aux.push_back( spike );
+    const GIDFilter filter( _gids );
+    Spikes aux;
+    for ( size_t i = 0; i < _spikes.size( ); ++i )
+      if ( filter.contains( _spikes.gid( i )))
+        aux.push_back( _spikes.time( i ), _spikes.gid( i ) );
 
-    aux.shrink_to_fit( );
+    _spikes = std::move( aux );
+    resetSpikeTrains( );
+    resetActivityPyramids( );
+    resetRateEngines( );
 
-    _spikes = Spikes( aux );
-
-    std::cout << " After: " << _spikes.size( ) << ". Used " << (100*before)/_spikes.size() << "%" << std::endl;
+    std::cout << " After: " << _spikes.size( ) << ". Used "
+              << ( before ? ( 100 * _spikes.size( )) / before : 0 ) << "%"
+              << std::endl;
   }
 
   const Spikes& SpikeData::spikes( void ) const
@@ -148,8 +175,143 @@ SpikeData::SpikeData()
   void SpikeData::addSpikes(TSpikes & spikes)
   {
     _isDirty = true;
-    _spikes.insert(_spikes.end(),spikes.begin(),spikes.end());
-    _spikes.rebuildIndex(_spikes.size());
+    for ( const auto& spike : spikes )
+      _modifiedFrom = std::min( _modifiedFrom, spike.first );
+
+    // Appending under the locks keeps a pyramid or rate engine built from
+    // the stored spikes from counting the new ones twice.
+    std::lock_guard< std::mutex > lock( _pyramidsMutex );
+    std::lock_guard< std::mutex > ratesLock( _ratesMutex );
+    _spikes.append(spikes);
+    for ( auto& pyramid : _pyramids )
+      pyramid.second.add( spikes );
+    for ( auto& rates : _rates )
+      rates.second.add( spikes );
+  }
+
+  void SpikeData::cleanDirty( void )
+  {
+    SimulationData::cleanDirty( );
+    _modifiedFrom = std::numeric_limits< float >::infinity( );
+  }
+
+  std::shared_ptr< const SpikeTrains > SpikeData::spikeTrains( void ) const
+  {
+    std::lock_guard< std::mutex > lock( _trainsMutex );
+
+    // Spikes only grow between resets, so a size change means new data.
+    if ( !_trains || _trains->size( ) != _spikes.size( ))
+      _trains = std::make_shared< SpikeTrains >( _spikes );
+
+    return _trains;
+  }
+
+  TSpikeTrain SpikeData::spikeTrain( uint32_t gid ) const
+  {
+    const auto train = spikeTrains( )->train( gid );
+    return TSpikeTrain( train.begin( ), train.end( ));
+  }
+
+  size_t SpikeData::spikeCount( uint32_t gid, float startTime,
+                                float endTime ) const
+  {
+    return spikeTrains( )->count( gid, startTime, endTime );
+  }
+
+  TSpikeTrainMap SpikeData::subsetSpikeTrains( const std::string& subset ) const
+  {
+    const auto trains = spikeTrains( );
+
+    TSpikeTrainMap result;
+    for ( const auto gid : _subsetEventManager.subsetGIDs( subset ))
+    {
+      const auto train = trains->train( gid );
+      if ( train.size > 0 )
+        result.emplace( gid, TSpikeTrain( train.begin( ), train.end( )));
+    }
+
+    return result;
+  }
+
+  void SpikeData::resetSpikeTrains( void )
+  {
+    std::lock_guard< std::mutex > lock( _trainsMutex );
+    _trains.reset( );
+  }
+
+  std::vector< float > SpikeData::activityHistogram( float startTime_,
+                                                    float endTime_,
+                                                    size_t bins,
+                                                    const std::string& subset ) const
+  {
+    std::lock_guard< std::mutex > lock( _pyramidsMutex );
+    const auto pyramid = activityPyramid( subset );
+    if ( !pyramid )
+      return std::vector< float >( bins, 0.0f );
+
+    return pyramid->histogram( startTime_, endTime_, bins );
+  }
+
+  void SpikeData::buildActivityPyramids( void ) const
+  {
+    std::lock_guard< std::mutex > lock( _pyramidsMutex );
+    activityPyramid( "" );
+    for ( const auto& name : _subsetEventManager.subsetNames( ))
+      activityPyramid( name );
+  }
+
+  std::vector< float > SpikeData::subsetRates( float binSize ) const
+  {
+    std::lock_guard< std::mutex > lock( _ratesMutex );
+    auto it = _rates.find( binSize );
+    if ( it == _rates.end( ))
+      it = _rates.emplace( binSize, RateEngine( *this, binSize )).first;
+
+    return it->second.rateMatrix( );
+  }
+
+  void SpikeData::setCompressed( bool compressed_ )
+  {
+    _spikes.setCompression( compressed_ );
+  }
+
+  bool SpikeData::compressed( void ) const
+  {
+    return _spikes.compression( );
+  }
+
+  const ActivityPyramid*
+  SpikeData::activityPyramid( const std::string& subset ) const
+  {
+    auto it = _pyramids.find( subset );
+    if ( it != _pyramids.end( ))
+      return &it->second;
+
+    std::shared_ptr< const GIDFilter > gids;
+    if ( !subset.empty( ))
+    {
+      // Unknown or empty subsets have no activity to count.
+      const auto subsetGids = _subsetEventManager.subsetGIDs( subset );
+      if ( subsetGids.empty( ))
+        return nullptr;
+
+      gids = std::make_shared< GIDFilter >( subsetGids );
+    }
+
+    return &_pyramids.emplace( subset, ActivityPyramid(
+      _spikes, _startTime, _endTime, gids )).first->second;
+  }
+
+  void SpikeData::resetActivityPyramids( void )
+  {
+    std::lock_guard< std::mutex > lock( _pyramidsMutex );
+    _pyramids.clear( );
+  }
+
+  void SpikeData::resetRateEngines( void )
+  {
+    std::lock_guard< std::mutex > lock( _ratesMutex );
+    _rates.clear( );
   }
 
   SpikeData* SpikeData::get( void )
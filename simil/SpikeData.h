@@ -32,9 +32,16 @@
 #include "SimulationData.h"
 
 #include "Spikes.hpp"
+#include "SpikeTrains.h"
+#include "ActivityPyramid.h"
+#include "RateEngine.h"
 #include "loaders/auxiliar/CSVActivity.h"
 #include <simil/api.h>
 
+#include <limits>
+#include <memory>
+#include <mutex>
+
 namespace simil
 {
   class SIMIL_API SpikeData : public SimulationData
@@ -52,8 +59,115 @@ namespace simil
 
     void reduceDataToGIDS( void );
 
+    /** \brief Returns the spikes grouped by neuron. The index is built on
+     * first use, and again after spikes are added or replaced.
+     *
+     */
+    std::shared_ptr< const SpikeTrains > spikeTrains( void ) const;
+
+    /** \brief Returns the spike times of the given neuron.
+     * \param[in] gid Neuron gid.
+     *
+     */
+    TSpikeTrain spikeTrain( uint32_t gid ) const;
+
+    /** \brief Returns the number of spikes of the given neuron in the
+     * [startTime, endTime) window.
+     * \param[in] gid Neuron gid.
+     * \param[in] startTime Window start time.
+     * \param[in] endTime Window end time.
+     *
+     */
+    size_t spikeCount( uint32_t gid, float startTime, float endTime ) const;
+
+    /** \brief Returns the spike times of the neurons of the given subset
+     * that have spikes.
+     * \param[in] subset Subset name in the subset event manager.
+     *
+     */
+    TSpikeTrainMap subsetSpikeTrains( const std::string& subset ) const;
+
+    /** \brief Returns the number of spikes in each of the given number of
+     * equal bins of the [startTime, endTime) window, computed from the
+     * activity pyramid. The pyramid is built on first use and updated as
+     * spikes are added.
+     * \param[in] startTime Window start time.
+     * \param[in] endTime Window end time.
+     * \param[in] bins Number of bins.
+     * \param[in] subset Subset name, empty for all the spikes.
+     *
+     */
+    std::vector< float > activityHistogram( float startTime, float endTime,
+                                            size_t bins,
+                                            const std::string& subset = "" ) const;
+
+    /** \brief Builds the activity pyramids of all the spikes and of every
+     * subset, so that later histograms do not wait for them.
+     *
+     */
+    void buildActivityPyramids( void ) const;
+
+    /** \brief Returns the firing rate of every subset in bins of the given
+     * size, as a row major subsets x bins matrix in subset name order (see
+     * RateEngine). The engine of each bin size is built on first use and
+     * updated as spikes are added.
+     * \param[in] binSize Bin width, in simulation time units.
+     *
+     */
+    std::vector< float > subsetRates( float binSize ) const;
+
+    /** \brief Enables or disables the compression of the full spike chunks.
+     * Compressed spikes take less than half of the memory and are decoded on
+     * access.
+     * \param[in] compressed True to compress the spikes.
+     *
+     */
+    void setCompressed( bool compressed );
+
+    /** \brief Returns true if the spikes are kept compressed.
+     *
+     */
+    bool compressed( void ) const;
+
+    /** \brief Returns the time of the earliest spike added since the data
+     * was last cleaned, minus infinity if the spikes were replaced and
+     * infinity if they did not change. Results that only depend on earlier
+     * spikes are still valid.
+     *
+     */
+    float modifiedFrom( void ) const
+    {
+      return _modifiedFrom;
+    }
+
+    void cleanDirty( void ) override;
+
   protected:
+    void resetSpikeTrains( void );
+    void resetActivityPyramids( void );
+    void resetRateEngines( void );
+
+    /** \brief Returns the pyramid of the given subset, building it if
+     * needed, or nullptr if the subset has no gids. Requires _pyramidsMutex
+     * to be locked.
+     *
+     */
+    const ActivityPyramid* activityPyramid( const std::string& subset ) const;
+
     Spikes _spikes;
+
+    float _modifiedFrom;
+
+    mutable std::mutex _trainsMutex;
+    mutable std::shared_ptr< const SpikeTrains > _trains;
+
+    // Activity pyramids by subset name, the empty name for all the spikes.
+    mutable std::mutex _pyramidsMutex;
+    mutable std::map< std::string, ActivityPyramid > _pyramids;
+
+    // Rate engines by bin size. Appends lock _pyramidsMutex first.
+    mutable std::mutex _ratesMutex;
+    mutable std::map< float, RateEngine > _rates;
   };
 
 
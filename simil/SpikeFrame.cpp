@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "SpikeFrame.h"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace simil
+{
+  SpikeFrame::SpikeFrame( void )
+  : _size( 0 )
+  { }
+
+  void SpikeFrame::clear( void )
+  {
+    _size = 0;
+    _guard.reset( );
+    _segments.clear( );
+    _indices.clear( );
+    _positions.clear( );
+  }
+
+  void SpikeFrame::assign( const SpikeColumns& spikes, size_t first,
+                           size_t last, const NeuronIndex& index,
+                           const TPosVect& positions )
+  {
+    if( !positions.empty( ) && positions.size( ) != index.size( ))
+    {
+      const std::string errorText = "SpikeFrame: " +
+        std::to_string( positions.size( )) + " positions for " +
+        std::to_string( index.size( )) + " indexed neurons.";
+      std::cerr << "EXCEPTION: " << errorText << " -> " << __FILE__ << ":"
+                << __LINE__ << std::endl;
+      throw std::runtime_error( errorText );
+    }
+
+    clear( );
+    _guard.reset( new SpikeColumns::ReadGuard( spikes ));
+    last = std::min( last, spikes.size( ));
+    if( first >= last )
+    {
+      _guard.reset( );
+      return;
+    }
+
+    _size = last - first;
+
+    // Runs of compressed chunks live in a per thread cache that the next
+    // run overwrites, so those spikes are decoded into the frame.
+    if( spikes.compression( ))
+    {
+      _times.resize( _size );
+      _gids.resize( _size );
+      for( size_t position = first; position < last; )
+      {
+        const auto run = spikes.run( position, last );
+        std::copy_n( run.times, run.size, _times.begin( ) + position - first );
+        std::copy_n( run.gids, run.size, _gids.begin( ) + position - first );
+        position += run.size;
+      }
+      _segments.push_back({ _times.data( ), _gids.data( ), _size });
+    }
+    else
+    {
+      for( size_t position = first; position < last; )
+      {
+        const auto run = spikes.run( position, last );
+        _segments.push_back( run );
+        position += run.size;
+      }
+    }
+
+    _indices.resize( _size );
+    size_t offset = 0;
+    for( const auto& segment : _segments )
+    {
+      index.toIndices( segment.gids, _indices.data( ) + offset, segment.size );
+      offset += segment.size;
+    }
+
+    if( positions.empty( ))
+      return;
+
+    _positions.resize( _size );
+    for( size_t i = 0; i < _size; ++i )
+      _positions[ i ] = _indices[ i ] < positions.size( ) ?
+        positions[ _indices[ i ]] : vmml::Vector3f( 0.0f, 0.0f, 0.0f );
+  }
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef __SIMIL_SPIKEFRAME_H__
+#define __SIMIL_SPIKEFRAME_H__
+
+#include "types.h"
+#include "NeuronIndex.h"
+#include "SpikeColumns.h"
+#include <simil/api.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace simil
+{
+  /** \class SpikeFrame
+   * \brief Spikes of one playback frame, ready to be uploaded as they are.
+   *
+   * The spikes are handed out as runs that point into the spike columns,
+   * so their times and gids are never copied. Only compressed spikes are
+   * decoded, into a buffer owned by the frame. The dense index and the
+   * position of the neuron of each spike are gathered into buffers that
+   * keep their memory from one frame to the next.
+   *
+   * The frame holds a read guard on the columns until it is cleared or
+   * assigned again, so its runs stay valid while the writer merges or
+   * compresses in the meantime. It must still be cleared before the
+   * columns are destroyed or replaced.
+   *
+   */
+  class SIMIL_API SpikeFrame
+  {
+  public:
+
+    SpikeFrame( void );
+
+    /** \brief Replaces the frame with the spikes in [first, last).
+     * \param[in] spikes Spike columns.
+     * \param[in] first Position of the first spike of the frame.
+     * \param[in] last Position after the last spike of the frame.
+     * \param[in] index Dense index of the neurons.
+     * \param[in] positions Neuron positions in index order, one per indexed
+     * neuron, or empty. Other sizes throw std::runtime_error.
+     *
+     */
+    void assign( const SpikeColumns& spikes, size_t first, size_t last,
+                 const NeuronIndex& index, const TPosVect& positions );
+
+    /** \brief Empties the frame, keeping its memory.
+     *
+     */
+    void clear( void );
+
+    /** \brief Returns the number of spikes of the frame.
+     *
+     */
+    size_t size( void ) const
+    {
+      return _size;
+    }
+
+    bool empty( void ) const
+    {
+      return _size == 0;
+    }
+
+    /** \brief Returns the runs of spikes of the frame, in time order.
+     *
+     */
+    const std::vector< SpikeColumns::Segment >& segments( void ) const
+    {
+      return _segments;
+    }
+
+    /** \brief Returns the dense index of the neuron of each spike, in time
+     * order, so entry i is the i-th spike of the segments. Spikes of neurons
+     * outside the index get NeuronIndex::INVALID.
+     *
+     */
+    const std::vector< uint32_t >& indices( void ) const
+    {
+      return _indices;
+    }
+
+    /** \brief Returns the position of the neuron of each spike, paired
+     * with indices( ), or nothing if there are no positions. Spikes of
+     * neurons outside the index are placed at the origin.
+     *
+     */
+    const TPosVect& positions( void ) const
+    {
+      return _positions;
+    }
+
+  protected:
+
+    size_t _size;
+
+    // Keeps the chunks the segments point to alive.
+    std::unique_ptr< SpikeColumns::ReadGuard > _guard;
+
+    std::vector< SpikeColumns::Segment > _segments;
+    std::vector< uint32_t > _indices;
+    TPosVect _positions;
+
+    // Decoded spikes when the columns are compressed.
+    std::vector< float > _times;
+    std::vector< uint32_t > _gids;
+  };
+}
+
+#endif /* __SIMIL_SPIKEFRAME_H__ */
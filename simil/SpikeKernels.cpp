@@ -0,0 +1,333 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "SpikeKernels.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined( __AVX2__ ) || defined( __F16C__ )
+#include <immintrin.h>
+#endif
+
+#if !defined( __AVX2__ ) && ( defined( __SSE2__ ) || defined( _M_X64 ))
+#include <emmintrin.h>
+#define SIMIL_SPIKEKERNELS_SSE2
+#endif
+
+namespace
+{
+  // Below this many elements the search finishes with a linear SIMD count.
+  constexpr size_t LINEAR_WINDOW = 64;
+
+  inline unsigned int popcount( unsigned int mask )
+  {
+    unsigned int count = 0;
+    for( ; mask; mask &= mask - 1 )
+      ++count;
+    return count;
+  }
+
+  /** Counts the elements less than value (or less or equal if inclusive).
+   * On sorted data this is the position of the bound. */
+  template< bool inclusive >
+  size_t countBelow( const float* times, size_t size, float value )
+  {
+    size_t i = 0;
+    size_t count = 0;
+
+#if defined( __AVX2__ )
+    const __m256 pivot = _mm256_set1_ps( value );
+    for( ; i + 8 <= size; i += 8 )
+    {
+      const __m256 block = _mm256_loadu_ps( times + i );
+      const __m256 mask = inclusive ? _mm256_cmp_ps( block, pivot, _CMP_LE_OQ )
+                                    : _mm256_cmp_ps( block, pivot, _CMP_LT_OQ );
+      count += popcount( _mm256_movemask_ps( mask ));
+    }
+#elif defined( SIMIL_SPIKEKERNELS_SSE2 )
+    const __m128 pivot = _mm_set1_ps( value );
+    for( ; i + 4 <= size; i += 4 )
+    {
+      const __m128 block = _mm_loadu_ps( times + i );
+      const __m128 mask = inclusive ? _mm_cmple_ps( block, pivot )
+                                    : _mm_cmplt_ps( block, pivot );
+      count += popcount( _mm_movemask_ps( mask ));
+    }
+#endif
+
+    for( ; i < size; ++i )
+      count += inclusive ? times[ i ] <= value : times[ i ] < value;
+
+    return count;
+  }
+
+  template< bool inclusive >
+  size_t bound( const float* times, size_t size, float value )
+  {
+    size_t first = 0;
+    size_t length = size;
+
+    while( length > LINEAR_WINDOW )
+    {
+      const size_t half = length / 2;
+      const float probe = times[ first + half ];
+      if( inclusive ? probe <= value : probe < value )
+      {
+        first += half + 1;
+        length -= half + 1;
+      }
+      else
+        length = half;
+    }
+
+    return first + countBelow< inclusive >( times + first, length, value );
+  }
+
+  uint16_t floatToHalf( float value )
+  {
+    uint32_t bits;
+    std::memcpy( &bits, &value, sizeof( bits ));
+
+    const uint32_t sign = ( bits >> 16 ) & 0x8000u;
+    const uint32_t exponent = ( bits >> 23 ) & 0xFFu;
+    uint32_t mantissa = bits & 0x7FFFFFu;
+
+    // Infinity and NaN, keeping NaN quiet.
+    if( exponent == 0xFFu )
+      return static_cast< uint16_t >( sign | 0x7C00u |
+                                      ( mantissa ? 0x200u : 0u ));
+
+    const int halfExponent = static_cast< int >( exponent ) - 127 + 15;
+    if( halfExponent >= 31 )
+      return static_cast< uint16_t >( sign | 0x7C00u );
+
+    if( halfExponent <= 0 )
+    {
+      // Subnormal or zero.
+      if( halfExponent < -10 )
+        return static_cast< uint16_t >( sign );
+
+      mantissa |= 0x800000u;
+      const unsigned shift = static_cast< unsigned >( 14 - halfExponent );
+      uint32_t half = mantissa >> shift;
+      const uint32_t rest = mantissa & (( 1u << shift ) - 1 );
+      const uint32_t halfway = 1u << ( shift - 1 );
+      if( rest > halfway || ( rest == halfway && ( half & 1u )))
+        ++half;
+      return static_cast< uint16_t >( sign | half );
+    }
+
+    uint32_t half = ( static_cast< uint32_t >( halfExponent ) << 10 ) |
+                    ( mantissa >> 13 );
+    const uint32_t rest = mantissa & 0x1FFFu;
+    // Rounding may carry into the exponent, up to infinity.
+    if( rest > 0x1000u || ( rest == 0x1000u && ( half & 1u )))
+      ++half;
+    return static_cast< uint16_t >( sign | half );
+  }
+
+  float halfToFloat( uint16_t value )
+  {
+    const uint32_t sign = static_cast< uint32_t >( value & 0x8000u ) << 16;
+    uint32_t exponent = ( value >> 10 ) & 0x1Fu;
+    uint32_t mantissa = value & 0x3FFu;
+
+    uint32_t bits;
+    if( exponent == 0x1Fu )
+      bits = sign | 0x7F800000u | ( mantissa << 13 );
+    else if( exponent != 0 )
+      bits = sign | (( exponent + 127 - 15 ) << 23 ) | ( mantissa << 13 );
+    else if( mantissa == 0 )
+      bits = sign;
+    else
+    {
+      // Subnormal, normalized for single precision.
+      exponent = 127 - 15 + 1;
+      while(( mantissa & 0x400u ) == 0 )
+      {
+        mantissa <<= 1;
+        --exponent;
+      }
+      bits = sign | ( exponent << 23 ) | (( mantissa & 0x3FFu ) << 13 );
+    }
+
+    float result;
+    std::memcpy( &result, &bits, sizeof( result ));
+    return result;
+  }
+}
+
+namespace simil
+{
+  namespace kernels
+  {
+    size_t lowerBound( const float* times, size_t size, float value )
+    {
+      return bound< false >( times, size, value );
+    }
+
+    size_t upperBound( const float* times, size_t size, float value )
+    {
+      return bound< true >( times, size, value );
+    }
+
+    size_t countBetween( const float* times, size_t size,
+                         float start, float end )
+    {
+      if( end <= start )
+        return 0;
+
+      const size_t first = lowerBound( times, size, start );
+      return lowerBound( times + first, size - first, end );
+    }
+
+    size_t gatherGids( const float* times, const uint32_t* gids,
+                       size_t size, float start, float end,
+                       std::vector< uint32_t >& result )
+    {
+      result.clear( );
+      if( end <= start )
+        return 0;
+
+      // Sorted times make the window contiguous in the gids column.
+      const size_t first = lowerBound( times, size, start );
+      const size_t count = lowerBound( times + first, size - first, end );
+
+      result.assign( gids + first, gids + first + count );
+      return count;
+    }
+
+    void scaleValues( float* values, size_t size, float factor,
+                      float threshold )
+    {
+      size_t i = 0;
+
+#if defined( __AVX2__ )
+      const __m256 scale = _mm256_set1_ps( factor );
+      const __m256 minimum = _mm256_set1_ps( threshold );
+      for( ; i + 8 <= size; i += 8 )
+      {
+        const __m256 block = _mm256_mul_ps( _mm256_loadu_ps( values + i ),
+                                            scale );
+        _mm256_storeu_ps( values + i, _mm256_and_ps( block,
+          _mm256_cmp_ps( block, minimum, _CMP_GE_OQ )));
+      }
+#elif defined( SIMIL_SPIKEKERNELS_SSE2 )
+      const __m128 scale = _mm_set1_ps( factor );
+      const __m128 minimum = _mm_set1_ps( threshold );
+      for( ; i + 4 <= size; i += 4 )
+      {
+        const __m128 block = _mm_mul_ps( _mm_loadu_ps( values + i ), scale );
+        _mm_storeu_ps( values + i,
+                       _mm_and_ps( block, _mm_cmpge_ps( block, minimum )));
+      }
+#endif
+
+      for( ; i < size; ++i )
+      {
+        const float value = values[ i ] * factor;
+        values[ i ] = value >= threshold ? value : 0.0f;
+      }
+    }
+
+    void subtractValues( float* values, size_t size, float step )
+    {
+      size_t i = 0;
+
+#if defined( __AVX2__ )
+      const __m256 amount = _mm256_set1_ps( step );
+      const __m256 zero = _mm256_setzero_ps( );
+      for( ; i + 8 <= size; i += 8 )
+        _mm256_storeu_ps( values + i, _mm256_max_ps(
+          _mm256_sub_ps( _mm256_loadu_ps( values + i ), amount ), zero ));
+#elif defined( SIMIL_SPIKEKERNELS_SSE2 )
+      const __m128 amount = _mm_set1_ps( step );
+      const __m128 zero = _mm_setzero_ps( );
+      for( ; i + 4 <= size; i += 4 )
+        _mm_storeu_ps( values + i, _mm_max_ps(
+          _mm_sub_ps( _mm_loadu_ps( values + i ), amount ), zero ));
+#endif
+
+      for( ; i < size; ++i )
+        values[ i ] = std::max( values[ i ] - step, 0.0f );
+    }
+
+    void interpolateValues( float* values, const float* next, size_t size,
+                            float weight )
+    {
+      size_t i = 0;
+
+#if defined( __AVX2__ )
+      const __m256 factor = _mm256_set1_ps( weight );
+      for( ; i + 8 <= size; i += 8 )
+      {
+        const __m256 block = _mm256_loadu_ps( values + i );
+        const __m256 delta = _mm256_sub_ps( _mm256_loadu_ps( next + i ), block );
+        _mm256_storeu_ps( values + i,
+                          _mm256_add_ps( block, _mm256_mul_ps( delta, factor )));
+      }
+#elif defined( SIMIL_SPIKEKERNELS_SSE2 )
+      const __m128 factor = _mm_set1_ps( weight );
+      for( ; i + 4 <= size; i += 4 )
+      {
+        const __m128 block = _mm_loadu_ps( values + i );
+        const __m128 delta = _mm_sub_ps( _mm_loadu_ps( next + i ), block );
+        _mm_storeu_ps( values + i,
+                       _mm_add_ps( block, _mm_mul_ps( delta, factor )));
+      }
+#endif
+
+      for( ; i < size; ++i )
+        values[ i ] += ( next[ i ] - values[ i ] ) * weight;
+    }
+
+    void floatsToHalves( const float* values, size_t size, uint16_t* result )
+    {
+      size_t i = 0;
+
+#if defined( __F16C__ )
+      for( ; i + 8 <= size; i += 8 )
+        _mm_storeu_si128( reinterpret_cast< __m128i* >( result + i ),
+                          _mm256_cvtps_ph( _mm256_loadu_ps( values + i ),
+                                           _MM_FROUND_TO_NEAREST_INT ));
+#endif
+
+      for( ; i < size; ++i )
+        result[ i ] = floatToHalf( values[ i ]);
+    }
+
+    void halvesToFloats( const uint16_t* values, size_t size, float* result )
+    {
+      size_t i = 0;
+
+#if defined( __F16C__ )
+      for( ; i + 8 <= size; i += 8 )
+        _mm256_storeu_ps( result + i, _mm256_cvtph_ps( _mm_loadu_si128(
+          reinterpret_cast< const __m128i* >( values + i ))));
+#endif
+
+      for( ; i < size; ++i )
+        result[ i ] = halfToFloat( values[ i ]);
+    }
+  }
+}
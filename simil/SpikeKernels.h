@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef __SIMIL_SPIKEKERNELS_H__
+#define __SIMIL_SPIKEKERNELS_H__
+
+#include <simil/api.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace simil
+{
+  /** \brief Scan kernels over a contiguous and time sorted column of spike
+   * times, and sweeps over per neuron value columns. AVX2 versions are used
+   * when the library is built with SIMIL_WITH_AVX2, SSE2 versions on any
+   * other x86-64 build and plain C++ elsewhere.
+   *
+   */
+  namespace kernels
+  {
+    /** \brief Returns the index of the first time not less than value.
+     * \param[in] times Sorted times column.
+     * \param[in] size Number of elements in the column.
+     * \param[in] value Time to look for.
+     *
+     */
+    SIMIL_API size_t lowerBound( const float* times, size_t size, float value );
+
+    /** \brief Returns the index of the first time greater than value.
+     * \param[in] times Sorted times column.
+     * \param[in] size Number of elements in the column.
+     * \param[in] value Time to look for.
+     *
+     */
+    SIMIL_API size_t upperBound( const float* times, size_t size, float value );
+
+    /** \brief Returns the number of times in the [start, end) window.
+     * \param[in] times Sorted times column.
+     * \param[in] size Number of elements in the column.
+     * \param[in] start Window start time.
+     * \param[in] end Window end time.
+     *
+     */
+    SIMIL_API size_t countBetween( const float* times, size_t size,
+                                   float start, float end );
+
+    /** \brief Copies the gids of the spikes in the [start, end) window to
+     * the given vector, replacing its contents. Returns the number of gids.
+     * \param[in] times Sorted times column.
+     * \param[in] gids Gids column, same size as times.
+     * \param[in] size Number of elements in the columns.
+     * \param[in] start Window start time.
+     * \param[in] end Window end time.
+     * \param[out] result Gids of the spikes in the window.
+     *
+     */
+    SIMIL_API size_t gatherGids( const float* times, const uint32_t* gids,
+                                 size_t size, float start, float end,
+                                 std::vector< uint32_t >& result );
+
+    /** \brief Multiplies every value by factor and sets to zero the ones
+     * that end up below threshold.
+     * \param[in,out] values Values column.
+     * \param[in] size Number of elements in the column.
+     * \param[in] factor Scale factor.
+     * \param[in] threshold Smallest value kept.
+     *
+     */
+    SIMIL_API void scaleValues( float* values, size_t size, float factor,
+                                float threshold );
+
+    /** \brief Subtracts step from every value, clamping them at zero.
+     * \param[in,out] values Values column.
+     * \param[in] size Number of elements in the column.
+     * \param[in] step Amount to subtract.
+     *
+     */
+    SIMIL_API void subtractValues( float* values, size_t size, float step );
+
+    /** \brief Moves every value towards the matching next one, as a linear
+     * interpolation between two samples.
+     * \param[in,out] values Values of the first sample.
+     * \param[in] next Values of the second sample.
+     * \param[in] size Number of elements in the columns.
+     * \param[in] weight Position between both samples, from 0 to 1.
+     *
+     */
+    SIMIL_API void interpolateValues( float* values, const float* next,
+                                      size_t size, float weight );
+
+    /** \brief Converts values to IEEE half precision, rounding to nearest.
+     * \param[in] values Values column.
+     * \param[in] size Number of elements in the column.
+     * \param[out] result Half precision values.
+     *
+     */
+    SIMIL_API void floatsToHalves( const float* values, size_t size,
+                                   uint16_t* result );
+
+    /** \brief Converts IEEE half precision values to single precision.
+     * \param[in] values Half precision values column.
+     * \param[in] size Number of elements in the column.
+     * \param[out] result Single precision values.
+     *
+     */
+    SIMIL_API void halvesToFloats( const uint16_t* values, size_t size,
+                                   float* result );
+  }
+}
+
+#endif /* __SIMIL_SPIKEKERNELS_H__ */
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "SpikeMerge.h"
+#include "SpikeSort.h"
+
+#include <algorithm>
+
+namespace
+{
+  /** Sorted range of a run taking part in the merge. */
+  struct Source
+  {
+    const float* times;
+    const uint32_t* gids;
+    size_t size;
+  };
+}
+
+namespace simil
+{
+  TSpikes mergeSpikeRuns( std::vector< SpikeRun >& runs )
+  {
+    std::vector< Source > sources;
+    size_t total = 0;
+
+    for( auto& run : runs )
+    {
+      const size_t size = std::min( run.times.size( ), run.gids.size( ));
+      if( size == 0 )
+        continue;
+      total += size;
+
+      run.times.resize( size );
+      run.gids.resize( size );
+      sortSpikes( run.times, run.gids );
+      sources.push_back( Source{ run.times.data( ), run.gids.data( ), size });
+    }
+
+    TSpikes result( total );
+    const size_t k = sources.size( );
+    if( k == 0 )
+      return result;
+
+    // Each source competes with the key of its next spike: the time,
+    // mapped to an integer of the same order, with the source index below
+    // to break ties. Exhausted sources lose against everything.
+    std::vector< size_t > positions( k, 0 );
+    std::vector< uint64_t > keys( k );
+    const auto updateKey = [ & ]( size_t s )
+    {
+      keys[ s ] = positions[ s ] < sources[ s ].size ?
+        ( uint64_t( spikeTimeKey( sources[ s ].times[ positions[ s ]])) << 32 ) | s :
+        ~uint64_t( 0 );
+    };
+    for( size_t s = 0; s < k; ++s )
+      updateKey( s );
+
+    // Leaf i is node k + i. Internal nodes keep the loser of their match
+    // and node 0 the overall winner.
+    std::vector< size_t > losers( k );
+    {
+      std::vector< size_t > winners( 2 * k );
+      for( size_t i = 0; i < k; ++i )
+        winners[ k + i ] = i;
+
+      for( size_t node = k - 1; node > 0; --node )
+      {
+        const size_t a = winners[ 2 * node ];
+        const size_t b = winners[ 2 * node + 1 ];
+        const bool first = keys[ a ] < keys[ b ];
+        winners[ node ] = first ? a : b;
+        losers[ node ] = first ? b : a;
+      }
+      losers[ 0 ] = winners[ 1 ];
+    }
+
+    for( auto& spike : result )
+    {
+      size_t winner = losers[ 0 ];
+      const Source& source = sources[ winner ];
+      spike = Spike( source.times[ positions[ winner ]],
+                     source.gids[ positions[ winner ]]);
+      ++positions[ winner ];
+      updateKey( winner );
+
+      for( size_t node = ( k + winner ) / 2; node > 0; node /= 2 )
+        if( keys[ losers[ node ]] < keys[ winner ])
+          std::swap( losers[ node ], winner );
+      losers[ 0 ] = winner;
+    }
+
+    runs.clear( );
+    return result;
+  }
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef __SIMIL_SPIKEMERGE_H__
+#define __SIMIL_SPIKEMERGE_H__
+
+#include "types.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace simil
+{
+  /** \brief Spikes of one loaded dataset, in two columns.
+   *
+   */
+  struct SpikeRun
+  {
+    std::vector< float > times;
+    std::vector< uint32_t > gids;
+  };
+
+  /** \brief Merges the given runs into a single time sorted vector with a
+   * loser tree, so each output spike costs log2( runs ) comparisons.
+   * Unsorted runs are first radix sorted in place. Spikes with equal times
+   * keep the order of their runs and of their positions in them. The runs
+   * are released. Internal header.
+   * \param[in,out] runs Runs to merge, empty on return.
+   *
+   */
+  TSpikes mergeSpikeRuns( std::vector< SpikeRun >& runs );
+}
+
+#endif /* __SIMIL_SPIKEMERGE_H__ */
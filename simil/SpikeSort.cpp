@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "SpikeSort.h"
+#include "Parallel.h"
+
+#include <algorithm>
+
+namespace
+{
+  enum : size_t
+  {
+    DIGIT_BITS = 11,
+    DIGITS = size_t( 1 ) << DIGIT_BITS
+  };
+
+  /** Sorts items by their upper 32 bits, the time key, keeping the order
+   * of equal keys. The gid payload rides in the lower bits. */
+  void radixSort( std::vector< uint64_t >& items )
+  {
+    const size_t size = items.size( );
+    const unsigned int threads = simil::parallel::threadCount( size );
+
+    std::vector< uint64_t > buffer( size );
+    std::vector< std::vector< size_t >> counts( threads,
+      std::vector< size_t >( DIGITS ));
+
+    uint64_t* source = items.data( );
+    uint64_t* target = buffer.data( );
+
+    for( unsigned int shift = 32; shift < 64; shift += DIGIT_BITS )
+    {
+      simil::parallel::forRanges( size, threads,
+        [ & ]( unsigned int t, size_t begin, size_t end )
+        {
+          auto& count = counts[ t ];
+          std::fill( count.begin( ), count.end( ), 0 );
+          for( size_t i = begin; i < end; ++i )
+            ++count[( source[ i ] >> shift ) & ( DIGITS - 1 )];
+        });
+
+      // Each thread writes its range after the same digit of the ranges
+      // before it, which keeps the sort stable. Passes where every item
+      // has the same digit are skipped.
+      size_t offset = 0;
+      bool trivial = false;
+      for( size_t digit = 0; digit < DIGITS && !trivial; ++digit )
+      {
+        size_t total = 0;
+        for( unsigned int t = 0; t < threads; ++t )
+        {
+          const size_t count = counts[ t ][ digit ];
+          counts[ t ][ digit ] = offset + total;
+          total += count;
+        }
+        trivial = total == size;
+        offset += total;
+      }
+      if( trivial )
+        continue;
+
+      simil::parallel::forRanges( size, threads,
+        [ & ]( unsigned int t, size_t begin, size_t end )
+        {
+          auto& position = counts[ t ];
+          for( size_t i = begin; i < end; ++i )
+            target[ position[( source[ i ] >> shift ) & ( DIGITS - 1 )]++ ] =
+              source[ i ];
+        });
+
+      std::swap( source, target );
+    }
+
+    if( source != items.data( ))
+      items.swap( buffer );
+  }
+
+  uint64_t packSpike( float time, uint32_t gid )
+  {
+    return ( uint64_t( simil::spikeTimeKey( time )) << 32 ) | gid;
+  }
+}
+
+namespace simil
+{
+  void sortSpikes( TSpikes& spikes )
+  {
+    if( std::is_sorted( spikes.begin( ), spikes.end( ),
+          []( const Spike& a, const Spike& b ){ return a.first < b.first; }))
+      return;
+
+    const size_t size = spikes.size( );
+    const unsigned int threads = parallel::threadCount( size );
+
+    std::vector< uint64_t > items( size );
+    parallel::forRanges( size, threads,
+      [ & ]( unsigned int, size_t begin, size_t end )
+      {
+        for( size_t i = begin; i < end; ++i )
+          items[ i ] = packSpike( spikes[ i ].first, spikes[ i ].second );
+      });
+
+    radixSort( items );
+
+    parallel::forRanges( size, threads,
+      [ & ]( unsigned int, size_t begin, size_t end )
+      {
+        for( size_t i = begin; i < end; ++i )
+          spikes[ i ] = Spike( spikeKeyTime( uint32_t( items[ i ] >> 32 )),
+                               uint32_t( items[ i ]));
+      });
+  }
+
+  void sortSpikes( std::vector< float >& times, std::vector< uint32_t >& gids )
+  {
+    if( std::is_sorted( times.begin( ), times.end( )))
+      return;
+
+    const size_t size = std::min( times.size( ), gids.size( ));
+    const unsigned int threads = parallel::threadCount( size );
+
+    std::vector< uint64_t > items( size );
+    parallel::forRanges( size, threads,
+      [ & ]( unsigned int, size_t begin, size_t end )
+      {
+        for( size_t i = begin; i < end; ++i )
+          items[ i ] = packSpike( times[ i ], gids[ i ]);
+      });
+
+    radixSort( items );
+
+    parallel::forRanges( size, threads,
+      [ & ]( unsigned int, size_t begin, size_t end )
+      {
+        for( size_t i = begin; i < end; ++i )
+        {
+          times[ i ] = spikeKeyTime( uint32_t( items[ i ] >> 32 ));
+          gids[ i ] = uint32_t( items[ i ]);
+        }
+      });
+  }
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef __SIMIL_SPIKESORT_H__
+#define __SIMIL_SPIKESORT_H__
+
+#include "types.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace simil
+{
+  /** \brief Maps a spike time to an unsigned integer with the same order,
+   * so times can be compared and sorted as integers. -0 maps like +0, as
+   * they compare equal. Internal header.
+   *
+   */
+  inline uint32_t spikeTimeKey( float time )
+  {
+    time += 0.0f;
+    uint32_t bits;
+    std::memcpy( &bits, &time, sizeof( bits ));
+    return ( bits & 0x80000000u ) ? ~bits : ( bits | 0x80000000u );
+  }
+
+  /** \brief Inverse of spikeTimeKey.
+   *
+   */
+  inline float spikeKeyTime( uint32_t key )
+  {
+    const uint32_t bits =
+      key ^ ((( key >> 31 ) - 1u ) | 0x80000000u );
+    float time;
+    std::memcpy( &time, &bits, sizeof( time ));
+    return time;
+  }
+
+  /** \brief Sorts spikes by time with a parallel LSD radix sort. Spikes
+   * with equal times keep their order. Input that is already sorted is
+   * detected and left untouched.
+   * \param[in,out] spikes Spikes to sort.
+   *
+   */
+  void sortSpikes( TSpikes& spikes );
+
+  /** \brief Sorts spikes given as time and gid columns of the same size.
+   * \param[in,out] times Spike times.
+   * \param[in,out] gids Gids of the spikes.
+   *
+   */
+  void sortSpikes( std::vector< float >& times, std::vector< uint32_t >& gids );
+}
+
+#endif /* __SIMIL_SPIKESORT_H__ */
@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "SpikeTrains.h"
+#include "SpikeKernels.h"
+#include "Parallel.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+  /** Calls func( time, gid ) for the spikes in [begin, end). */
+  template< typename Func >
+  void forEachSpike( const simil::SpikeColumns& spikes,
+                     size_t begin, size_t end, Func func )
+  {
+    while( begin < end )
+    {
+      const auto run = spikes.run( begin, end );
+      for( size_t i = 0; i < run.size; ++i )
+        func( run.times[ i ], run.gids[ i ]);
+
+      begin += run.size;
+    }
+  }
+
+  inline unsigned int popcount( uint64_t word )
+  {
+#if defined( __GNUC__ )
+    return static_cast< unsigned int >( __builtin_popcountll( word ));
+#else
+    unsigned int count = 0;
+    for( ; word; word &= word - 1 )
+      ++count;
+    return count;
+#endif
+  }
+}
+
+namespace simil
+{
+  SpikeTrains::SpikeTrains( void )
+  : _offsets( 1, 0 )
+  , _minGid( 0 )
+  { }
+
+  SpikeTrains::SpikeTrains( const SpikeColumns& spikes )
+  : _offsets( 1, 0 )
+  , _minGid( 0 )
+  {
+    // One guard covers the worker threads, which finish before it ends.
+    const SpikeColumns::ReadGuard guard( spikes );
+
+    const size_t size = spikes.size( );
+    if( size == 0 )
+      return;
+
+    unsigned int threads = parallel::threadCount( size );
+
+    // Gid range.
+    std::vector< uint32_t > minGids( threads,
+      std::numeric_limits< uint32_t >::max( ));
+    std::vector< uint32_t > maxGids( threads, 0 );
+    parallel::forRanges( size, threads,
+      [ & ]( unsigned int t, size_t begin, size_t end )
+      {
+        forEachSpike( spikes, begin, end, [ & ]( float, uint32_t gid )
+        {
+          minGids[ t ] = std::min( minGids[ t ], gid );
+          maxGids[ t ] = std::max( maxGids[ t ], gid );
+        });
+      });
+
+    _minGid = *std::min_element( minGids.begin( ), minGids.end( ));
+    const uint64_t range = static_cast< uint64_t >(
+      *std::max_element( maxGids.begin( ), maxGids.end( ))) - _minGid + 1;
+    const size_t words = static_cast< size_t >(( range + 63 ) / 64 );
+
+    // Gids with spikes. A bitmap is used while it is not larger than the
+    // times copy, otherwise each thread sorts its own gids.
+    if( words * sizeof( uint64_t ) * threads <= size * sizeof( float ))
+    {
+      std::vector< std::vector< uint64_t >> bitmaps( threads );
+      parallel::forRanges( size, threads,
+        [ & ]( unsigned int t, size_t begin, size_t end )
+        {
+          auto& bitmap = bitmaps[ t ];
+          bitmap.assign( words, 0 );
+          forEachSpike( spikes, begin, end, [ & ]( float, uint32_t gid )
+          {
+            const uint32_t bit = gid - _minGid;
+            bitmap[ bit / 64 ] |= uint64_t( 1 ) << ( bit % 64 );
+          });
+        });
+
+      _bitmap.swap( bitmaps[ 0 ]);
+      for( unsigned int t = 1; t < threads; ++t )
+        for( size_t w = 0; w < words; ++w )
+          _bitmap[ w ] |= bitmaps[ t ][ w ];
+
+      _ranks.resize( words );
+      uint32_t rank = 0;
+      for( size_t w = 0; w < words; ++w )
+      {
+        _ranks[ w ] = rank;
+        for( uint64_t word = _bitmap[ w ]; word; word &= word - 1 )
+        {
+          const unsigned int bit = popcount(( word & ( ~word + 1 )) - 1 );
+          _gids.push_back( _minGid + static_cast< uint32_t >( w * 64 + bit ));
+          ++rank;
+        }
+      }
+    }
+    else
+    {
+      std::vector< std::vector< uint32_t >> partial( threads );
+      parallel::forRanges( size, threads,
+        [ & ]( unsigned int t, size_t begin, size_t end )
+        {
+          auto& gids_ = partial[ t ];
+          forEachSpike( spikes, begin, end, [ & ]( float, uint32_t gid )
+          {
+            gids_.push_back( gid );
+          });
+          std::sort( gids_.begin( ), gids_.end( ));
+          gids_.erase( std::unique( gids_.begin( ), gids_.end( )),
+                       gids_.end( ));
+        });
+
+      for( const auto& gids_ : partial )
+      {
+        std::vector< uint32_t > merged;
+        merged.reserve( _gids.size( ) + gids_.size( ));
+        std::set_union( _gids.begin( ), _gids.end( ),
+                        gids_.begin( ), gids_.end( ),
+                        std::back_inserter( merged ));
+        _gids.swap( merged );
+      }
+    }
+
+    const size_t rows = _gids.size( );
+
+    // Per thread counts cost rows integers each, so fewer threads are used
+    // when most neurons only fire a few times.
+    threads = std::max( 1u, std::min( threads,
+      static_cast< unsigned int >( std::max< size_t >( 1, size / rows ))));
+
+    std::vector< std::vector< size_t >> cursors( threads );
+    parallel::forRanges( size, threads,
+      [ & ]( unsigned int t, size_t begin, size_t end )
+      {
+        auto& counts = cursors[ t ];
+        counts.assign( rows, 0 );
+        forEachSpike( spikes, begin, end, [ & ]( float, uint32_t gid )
+        {
+          ++counts[ row( gid )];
+        });
+      });
+
+    // Rows are laid out in gid order and, inside a row, each thread writes
+    // after the previous ones, which keeps every train in time order.
+    _offsets.resize( rows + 1 );
+    size_t offset = 0;
+    for( size_t r = 0; r < rows; ++r )
+    {
+      _offsets[ r ] = offset;
+      for( unsigned int t = 0; t < threads; ++t )
+      {
+        const size_t count_ = cursors[ t ][ r ];
+        cursors[ t ][ r ] = offset;
+        offset += count_;
+      }
+    }
+    _offsets[ rows ] = offset;
+
+    _times.resize( size );
+    parallel::forRanges( size, threads,
+      [ & ]( unsigned int t, size_t begin, size_t end )
+      {
+        auto& cursor = cursors[ t ];
+        forEachSpike( spikes, begin, end,
+          [ & ]( float time, uint32_t gid )
+          {
+            _times[ cursor[ row( gid )]++ ] = time;
+          });
+      });
+  }
+
+  size_t SpikeTrains::row( uint32_t gid ) const
+  {
+    if( !_bitmap.empty( ))
+    {
+      if( gid < _minGid )
+        return npos;
+
+      const uint64_t bit = gid - _minGid;
+      const size_t word = static_cast< size_t >( bit / 64 );
+      if( word >= _bitmap.size( ))
+        return npos;
+
+      const uint64_t mask = uint64_t( 1 ) << ( bit % 64 );
+      if( !( _bitmap[ word ] & mask ))
+        return npos;
+
+      return _ranks[ word ] + popcount( _bitmap[ word ] & ( mask - 1 ));
+    }
+
+    const auto it = std::lower_bound( _gids.begin( ), _gids.end( ), gid );
+    if( it == _gids.end( ) || *it != gid )
+      return npos;
+
+    return it - _gids.begin( );
+  }
+
+  SpikeTrains::Train SpikeTrains::train( uint32_t gid ) const
+  {
+    const size_t r = row( gid );
+    if( r == npos )
+      return Train{ nullptr, 0 };
+
+    return Train{ _times.data( ) + _offsets[ r ],
+                  _offsets[ r + 1 ] - _offsets[ r ]};
+  }
+
+  size_t SpikeTrains::count( uint32_t gid, float startTime,
+                             float endTime ) const
+  {
+    if( endTime <= startTime )
+      return 0;
+
+    const auto train_ = train( gid );
+    return kernels::countBetween( train_.times, train_.size,
+                                  startTime, endTime );
+  }
+}
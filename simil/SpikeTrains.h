@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef __SIMIL_SPIKETRAINS_H__
+#define __SIMIL_SPIKETRAINS_H__
+
+#include "types.h"
+#include "SpikeColumns.h"
+#include <simil/api.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace simil
+{
+  /** \class SpikeTrains
+   * \brief Spikes grouped by gid (compressed sparse rows): the times of each
+   * neuron are stored together and in time order, and an offsets array
+   * marks where each neuron starts.
+   *
+   * The index is a snapshot of the spikes present when it was built.
+   *
+   */
+  class SIMIL_API SpikeTrains
+  {
+  public:
+
+    /** \brief Spike times of one neuron.
+     *
+     */
+    struct Train
+    {
+      const float* times;
+      size_t size;
+
+      const float* begin( void ) const { return times; }
+      const float* end( void ) const { return times + size; }
+    };
+
+    SpikeTrains( void );
+
+    /** \brief Builds the index from the given spikes using several threads.
+     * \param[in] spikes Time sorted spikes.
+     *
+     */
+    explicit SpikeTrains( const SpikeColumns& spikes );
+
+    /** \brief Returns the number of indexed spikes.
+     *
+     */
+    size_t size( void ) const
+    {
+      return _times.size( );
+    }
+
+    /** \brief Returns the sorted gids that have at least one spike.
+     *
+     */
+    const std::vector< uint32_t >& gids( void ) const
+    {
+      return _gids;
+    }
+
+    /** \brief Returns the spike times of the given neuron.
+     * \param[in] gid Neuron gid.
+     *
+     */
+    Train train( uint32_t gid ) const;
+
+    /** \brief Returns the number of spikes of the given neuron.
+     * \param[in] gid Neuron gid.
+     *
+     */
+    size_t count( uint32_t gid ) const
+    {
+      return train( gid ).size;
+    }
+
+    /** \brief Returns the number of spikes of the given neuron in the
+     * [startTime, endTime) window.
+     * \param[in] gid Neuron gid.
+     * \param[in] startTime Window start time.
+     * \param[in] endTime Window end time.
+     *
+     */
+    size_t count( uint32_t gid, float startTime, float endTime ) const;
+
+  protected:
+
+    static const size_t npos = ~size_t( 0 );
+
+    /** \brief Returns the row of the given gid, or npos if it has no spikes.
+     *
+     */
+    size_t row( uint32_t gid ) const;
+
+    std::vector< uint32_t > _gids;
+    std::vector< size_t > _offsets;
+    std::vector< float > _times;
+
+    // Presence bitmap over [_minGid, _minGid + 64 * _bitmap.size()) with
+    // the number of set bits before each word, for dense gid ranges.
+    uint32_t _minGid;
+    std::vector< uint64_t > _bitmap;
+    std::vector< uint32_t > _ranks;
+  };
+}
+
+#endif /* __SIMIL_SPIKETRAINS_H__ */
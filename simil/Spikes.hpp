@@ -24,116 +24,155 @@
 #define __SIMIL_SPIKES_H_
 
 #include "types.h"
+#include "SpikeColumns.h"
 #include <simil/api.h>
 
+#include <cstddef>
+#include <iterator>
+
 namespace simil
 {
-  class SIMIL_API Spikes : public TSpikes
+  /** \class Spikes
+   * \brief Time sorted spikes container.
+   *
+   * Spikes are stored in chunked columns (see SpikeColumns) and exposed
+   * through random access iterators that yield time-gid pairs, so code
+   * written for TSpikes keeps working. Iterators only hold a position, so
+   * they remain valid while a writer appends spikes. Dereferencing them
+   * while the writer merges or compresses needs a ReadGuard.
+   */
+  class SIMIL_API Spikes : public SpikeColumns
   {
   public:
-    Spikes( )
-    : TSpikes( )
-    , _indexSize( 10000 )
-    , _invTime( 0.0f )
-    , _delta( 1.0f )
-    , _startTime( 0.0f )
-    , _endTime( 0.0f )
-    { }
-
-    Spikes( const TSpikes& other )
-    : TSpikes( other )
-    , _indexSize( 1000 )
-    , _invTime( 0.0f )
-    , _delta( 1.0f )
-    , _startTime( 0.0f )
-    , _endTime( 0.0f )
-    {
-      buildIndex( );
-    }
 
-    TSpikes::const_iterator elementAt( float time ) const
+    /** \brief Random access iterator over the spikes. Dereferencing returns
+     * the spike by value, as the time and gid live in different arrays.
+     *
+     */
+    class const_iterator
     {
-      if( _references.empty( ))
-        return end( );
-
-      TSpikes::const_iterator result = begin( );
-
-      const float perc =
-          std::max( 0.0f, std::min( 1.0f, ( time - _startTime ) * _invTime ));
-
-      unsigned int index = perc * (_indexSize-1);
-
-      TSpikes::const_iterator ref = cbegin() + _references[index];
-
-      TSpikes::const_iterator it = ref;
-      while( it->first < time && it != end())
+    public:
+      class SpikeProxy
+      {
+      public:
+        explicit SpikeProxy( const Spike& spike ) : _spike( spike ) { }
+        const Spike* operator->( void ) const { return &_spike; }
+      private:
+        Spike _spike;
+      };
+
+      typedef std::random_access_iterator_tag iterator_category;
+      typedef Spike value_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef SpikeProxy pointer;
+      typedef Spike reference;
+
+      const_iterator( void )
+      : _columns( nullptr )
+      , _pos( 0 )
+      { }
+
+      const_iterator( const SpikeColumns* columns, size_t pos )
+      : _columns( columns )
+      , _pos( pos )
+      { }
+
+      /** \brief Returns the position of the iterator in the container.
+       *
+       */
+      size_t index( void ) const { return _pos; }
+
+      float time( void ) const { return _columns->time( _pos ); }
+      uint32_t gid( void ) const { return _columns->gid( _pos ); }
+
+      reference operator*( void ) const { return _columns->spike( _pos ); }
+      pointer operator->( void ) const { return pointer( **this ); }
+      reference operator[]( difference_type n ) const
       {
-        result = it;
-        ++it;
+        return _columns->spike( _pos + n );
       }
 
-      return result;
-    }
-
-    const std::vector< int >& refData( void ) const
-    {
-      return _references;
-    }
+      const_iterator& operator++( void ) { ++_pos; return *this; }
+      const_iterator& operator--( void ) { --_pos; return *this; }
+      const_iterator operator++( int ) { auto it = *this; ++_pos; return it; }
+      const_iterator operator--( int ) { auto it = *this; --_pos; return it; }
 
-    void rebuildIndex( unsigned int newSize )
-    {
-      _indexSize = newSize;
-
-      buildIndex( );
-    }
+      const_iterator& operator+=( difference_type n ) { _pos += n; return *this; }
+      const_iterator& operator-=( difference_type n ) { _pos -= n; return *this; }
 
-  protected:
-
-    void buildIndex( void )
-    {
-        _startTime = _endTime = 0;
+      const_iterator operator+( difference_type n ) const
+      {
+        return const_iterator( _columns, _pos + n );
+      }
+      const_iterator operator-( difference_type n ) const
+      {
+        return const_iterator( _columns, _pos - n );
+      }
+      difference_type operator-( const const_iterator& other ) const
+      {
+        return static_cast< difference_type >( _pos ) -
+               static_cast< difference_type >( other._pos );
+      }
 
-        _references.clear();
-        _references.resize(_indexSize);
+      bool operator==( const const_iterator& o ) const { return _pos == o._pos; }
+      bool operator!=( const const_iterator& o ) const { return _pos != o._pos; }
+      bool operator<( const const_iterator& o ) const { return _pos < o._pos; }
+      bool operator>( const const_iterator& o ) const { return _pos > o._pos; }
+      bool operator<=( const const_iterator& o ) const { return _pos <= o._pos; }
+      bool operator>=( const const_iterator& o ) const { return _pos >= o._pos; }
 
-        if (empty())
-            return;
+    private:
+      const SpikeColumns* _columns;
+      size_t _pos;
+    };
 
-        _endTime = back().first;
-        _invTime = 1.0f / (_endTime - _startTime);
-        _delta = (_endTime - _startTime) / _indexSize;
+    typedef const_iterator iterator;
+    typedef Spike value_type;
 
-        float acc = 0.0f;
-        std::vector<float> limits(_indexSize, 0.0f);
+    Spikes( )
+    : SpikeColumns( )
+    { }
 
-        for (auto& limit : limits) {
-            limit = acc;
-            acc += _delta;
-        }
+    Spikes( const TSpikes& other )
+    : SpikeColumns( other )
+    { }
 
-      TSpikes::iterator spikeIt = begin( );
-      TSpikes::iterator last = spikeIt;
-      auto limitIt = limits.cbegin( );
-      for (size_t i = 0; i < _references.size(); ++i) {
-          while (spikeIt->first <= *limitIt && spikeIt != end()) {
-              last = spikeIt;
-              ++spikeIt;
-          }
+    const_iterator begin( void ) const { return const_iterator( this, 0 ); }
+    const_iterator end( void ) const { return const_iterator( this, size( )); }
+    const_iterator cbegin( void ) const { return begin( ); }
+    const_iterator cend( void ) const { return end( ); }
 
-          _references[i] = std::distance(begin(), last);
+    Spike operator[]( size_t i ) const { return spike( i ); }
+    Spike front( void ) const { return spike( 0 ); }
+    Spike back( void ) const { return spike( size( ) - 1 ); }
 
-          ++limitIt;
-      }
+    /** \brief Returns the spikes as a vector of time-gid pairs.
+     *
+     */
+    TSpikes pairs( void ) const
+    {
+      return toPairs( );
     }
 
-    std::vector< int > _references;
-
-    unsigned int _indexSize;
-    float _invTime;
-    float _delta;
+    /** \brief Returns an iterator to the first spike whose time is not
+     * less than the given time, or end() if there is none.
+     * \param[in] time Time to look for.
+     *
+     */
+    const_iterator elementAt( float time ) const
+    {
+      return const_iterator( this, indexAt( time ));
+    }
 
-    float _startTime;
-    float _endTime;
+    /** \brief Returns the index of the first spike whose time is not less
+     * than the given time, or size() if there is none.
+     * \param[in] time Time to look for.
+     *
+     */
+    size_t indexAt( float time ) const
+    {
+      return lowerBound( time );
+    }
   };
 }
 
@@ -24,16 +24,20 @@
 #include "SimulationData.h"
 #include "SpikeData.h"
 #include "log.h"
+#include <algorithm>
 #include <exception>
 #include <assert.h>
 #include <memory>
 #include <iostream> // std::cout, std::ostream, std::ios
 #include <fstream>  // std::filebuf
+#include <limits>
 
 namespace simil
 {
   SpikesPlayer::SpikesPlayer( void )
     : SimulationPlayer( )
+    , _trackActivity( false )
+    , _activityNeurons( 0 )
   {
     _simulationType = TSimSpikes;
   }
@@ -55,19 +59,18 @@ namespace simil
     }
 
     _simData = data_;
+    _spikeData = std::dynamic_pointer_cast< SpikeData >( _simData );
 
     std::cout << "GID Set size: " << gids( ).size( ) << std::endl;
 
-    auto spikeData = std::dynamic_pointer_cast< SpikeData >( _simData );
-
-    std::cout << "Loaded " << spikeData->spikes( ).size( ) << " spikes."
+    std::cout << "Loaded " << _spikeData->spikes( ).size( ) << " spikes."
               << std::endl;
 
-    _currentSpike = spikeData->spikes( ).begin( );
+    _currentSpike = _spikeData->spikes( ).begin( );
     _previousSpike = _currentSpike;
 
-    _startTime = spikeData->startTime( );
-    _endTime = spikeData->endTime( );
+    _startTime = _spikeData->startTime( );
+    _endTime = _spikeData->endTime( );
 
     _currentTime = _startTime;
 
@@ -85,20 +88,19 @@ namespace simil
     Clear( );
 
     _simData = data_;
+    _spikeData = std::dynamic_pointer_cast< SpikeData >( _simData );
     _network = net_;
 
     std::cout << "GID Set size: " << gids( ).size( ) << std::endl;
 
-    auto spikeData = std::dynamic_pointer_cast< SpikeData >( _simData );
-
-    std::cout << "Loaded " << spikeData->spikes( ).size( ) << " spikes."
+    std::cout << "Loaded " << _spikeData->spikes( ).size( ) << " spikes."
               << std::endl;
 
-    _currentSpike = spikeData->spikes( ).begin( );
+    _currentSpike = _spikeData->spikes( ).begin( );
     _previousSpike = _currentSpike;
 
-    _startTime = spikeData->startTime( );
-    _endTime = spikeData->endTime( );
+    _startTime = _spikeData->startTime( );
+    _endTime = _spikeData->endTime( );
 
     _currentTime = _startTime;
 
@@ -122,6 +124,11 @@ namespace simil
   {
     SimulationPlayer::Clear( );
     _simData = nullptr;
+    _spikeData = nullptr;
+    _checkpoints.clear( );
+    _frame.clear( );
+    _dataIndex.clear( );
+    _activity.clear( );
   }
 
   void SpikesPlayer::Stop( )
@@ -130,6 +137,7 @@ namespace simil
     SimulationPlayer::Stop( );
     _currentSpike = spikes( ).begin( );
     _previousSpike = _currentSpike;
+    updateActivity( true );
   }
 
   void SpikesPlayer::PlayAtTime( float timePos )
@@ -139,10 +147,9 @@ namespace simil
 
     const Spikes& spikes_ = spikes( );
 
-    _currentSpike = spikes_.begin( );
-    _previousSpike = _currentSpike;
-
+    _previousSpike = spikes_.elementAt( _previousTime );
     _currentSpike = spikes_.elementAt( _currentTime );
+    updateActivity( true );
   }
 
   void SpikesPlayer::PlayAtPercentage( float percentage )
@@ -152,10 +159,9 @@ namespace simil
 
     const Spikes& spikes_ = spikes( );
 
-    _currentSpike = spikes_.begin( );
-    _previousSpike = _currentSpike;
-
+    _previousSpike = spikes_.elementAt( _previousTime );
     _currentSpike = spikes_.elementAt( _currentTime );
+    updateActivity( true );
   }
 
   void SpikesPlayer::FrameProcess( )
@@ -166,36 +172,35 @@ namespace simil
     if ( _endTime - _startTime < std::numeric_limits< float >::epsilon( ))
       return;
 
-    const TSpikes& spikes_ = spikes( );
-    auto spike = _currentSpike;
-    while (( *spike ).first < _currentTime )
+    const Spikes& spikes_ = spikes( );
+    const auto spike = spikes_.begin( ) +
+      spikes_.lowerBound( _currentTime , _currentSpike.index( ));
+
+    if ( spike == spikes_.end( ))
     {
-      if ( spike == spikes_.end( ))
-      {
-        _finished = true;
-        Finished( );
-        return;
-      }
-      spike++;
+      _finished = true;
+      updateActivity( false );
+      Finished( );
+      return;
     }
     _currentSpike = spike;
+    updateActivity( false );
   }
 
   const Spikes& SpikesPlayer::spikes( )
   {
-    return std::dynamic_pointer_cast< SpikeData >( _simData )->spikes( );
+    return _spikeData->spikes( );
   }
 
   unsigned int SpikesPlayer::spikesSize( ) const
   {
-    return std::dynamic_pointer_cast< SpikeData >(
-      _simData )->spikes( ).size( );
+    return _spikeData->spikes( ).size( );
   }
 
 
   std::shared_ptr< SpikeData > SpikesPlayer::spikeReport( ) const
   {
-    return std::dynamic_pointer_cast< SpikeData >( _simData );
+    return _spikeData;
   }
 
   SpikesCRange
@@ -207,25 +212,36 @@ namespace simil
   SpikesCRange SpikesPlayer::spikesBetween( float startTime_ , float endTime_ )
   {
     _checkSimData( );
-    assert( endTime_ > startTime_ );
+    assert( endTime_ >= startTime_ );
 
     const Spikes& spikes_ = spikes( );
 
-    auto begin = spikes_.end( );
-    auto end = spikes_.end( );
+    const auto begin = spikes_.elementAt( startTime_ );
+    const auto end = spikes_.elementAt( endTime_ );
 
-    begin = spikes_.elementAt( startTime_ );
-    auto spike = begin;
-    unsigned int spikesSize = spikes_.size( );
-    while ( spike->first < endTime_ && spike - spikes_.begin( ) < spikesSize )
-      ++spike;
+    return std::make_pair( begin , end );
+  }
 
-    if ( spike - spikes_.begin( ) >= spikesSize )
-      spike = begin = spikes_.end( );
+  void SpikesPlayer::spikesBetween( float startTime_ , float endTime_ ,
+                                    const GIDSet& gids , TSpikes& result )
+  {
+    _checkSimData( );
+    result.clear( );
+    if ( gids.empty( ))
+      return;
 
-    end = spike;
+    const Spikes& spikes_ = spikes( );
+    const Spikes::ReadGuard guard( spikes_ );
 
-    return std::make_pair( begin , end );
+    const size_t last = spikes_.lowerBound( endTime_ );
+    for ( size_t position = spikes_.lowerBound( startTime_ ); position < last; )
+    {
+      const auto segment = spikes_.run( position , last );
+      for ( size_t i = 0; i < segment.size; ++i )
+        if ( gids.contains( segment.gids[ i ] ))
+          result.emplace_back( segment.times[ i ] , segment.gids[ i ] );
+      position += segment.size;
+    }
   }
 
   SpikesCRange SpikesPlayer::spikesNow( )
@@ -236,13 +252,83 @@ namespace simil
   void SpikesPlayer::spikesNowVect( std::vector< uint32_t >& gidsv )
   {
     _checkSimData( );
-    auto spikes_ = this->spikesNow( );
-    gidsv.resize( std::distance( spikes_.first , spikes_.second ));
-    auto resultIt = gidsv.begin( );
-    for ( auto& it = spikes_.first; it != spikes_.second; ++it , ++resultIt )
-    {
-      *resultIt = it->second;
-    }
+    const Spikes& spikes_ = spikes( );
+    spikes_.gidsRange( _previousSpike.index( ) , _currentSpike.index( ) ,
+                       gidsv );
+  }
+
+  const SpikeFrame& SpikesPlayer::frame( void )
+  {
+    _checkSimData( );
+    _frame.assign( spikes( ) , _previousSpike.index( ) ,
+                   _currentSpike.index( ) , neuronIndex( ) , positions( ));
+    return _frame;
+  }
+
+  SpikeCursor SpikesPlayer::cursor( float window )
+  {
+    _checkSimData( );
+    SpikeCursor cursor_( _spikeData , window );
+    cursor_.seek( _currentTime );
+    return cursor_;
+  }
+
+  void SpikesPlayer::setActivityDecay( TDecayModel model , float duration )
+  {
+    _checkpoints.clear( );
+    _activity.setModel( model , duration );
+    _trackActivity = true;
+  }
+
+  void SpikesPlayer::setCheckpointInterval( float interval )
+  {
+    _checkpoints.setInterval( interval );
+  }
+
+  void SpikesPlayer::buildCheckpoints( void )
+  {
+    _checkSimData( );
+    _trackActivity = true;
+    _checkpoints.buildAsync( _activity , _startTime , _endTime , spikes( ) ,
+                             neuronIndex( ));
+  }
+
+  const std::vector< float >& SpikesPlayer::activity( void )
+  {
+    _checkSimData( );
+    _trackActivity = true;
+
+    const auto& index = neuronIndex( );
+    if ( !_activity.valid( ) || _activity.time( ) != _currentTime ||
+         _activity.values( ).size( ) != index.size( ))
+      _activity.rebuild( _currentTime , spikes( ) , index );
+
+    return _activity.values( );
+  }
+
+  void SpikesPlayer::updateActivity( bool seek )
+  {
+    if ( !_trackActivity )
+      return;
+
+    if ( seek )
+      _checkpoints.seek( _activity , _currentTime , spikes( ) ,
+                         neuronIndex( ));
+    else
+      _activity.advance( _currentTime , spikes( ) , _previousSpike.index( ) ,
+                         _currentSpike.index( ) , neuronIndex( ));
+  }
+
+  const NeuronIndex& SpikesPlayer::neuronIndex( void )
+  {
+    if ( _network )
+      return _network->neuronIndex( );
+
+    const auto& gids_ = _simData->gids( );
+    if ( _dataIndex.size( ) != gids_.size( ))
+      _dataIndex.assign( GIDVec( gids_.begin( ) , gids_.end( )));
+
+    return _dataIndex;
   }
 
   bool SpikesPlayer::saveSpikesAsCSV(const std::string &filename)
@@ -259,16 +345,16 @@ namespace simil
       std::ostream csvFile(&csvBuffer);
       csvFile << "time, gid\n";
 
-      auto spikeData = std::dynamic_pointer_cast<SpikeData>(_simData);
-      if(!spikeData)
+      if(!_spikeData)
       {
         std::cerr << "saveSpikesAsCSV - data are not spikes." << std::endl;
         return false;
       }
 
-      const auto spikes = spikeData->spikes();
-      for (auto it = spikes.begin(); it != spikes.end(); ++it)
-        csvFile << (*it).first << ", " << (*it).second << '\n';
+      const auto &spikes = _spikeData->spikes();
+      const Spikes::ReadGuard guard(spikes);
+      for (size_t i = 0; i < spikes.size(); ++i)
+        csvFile << spikes.time(i) << ", " << spikes.gid(i) << '\n';
         
       csvBuffer.close();
     }
@@ -281,18 +367,31 @@ namespace simil
     return true;
   }
 
+  bool SpikesPlayer::saveSpikesAsBinary(const std::string &filename)
+  {
+    if(!_spikeData)
+    {
+      std::cerr << "saveSpikesAsBinary - data are not spikes." << std::endl;
+      return false;
+    }
+
+    return BinaryContainer::save(filename, *_spikeData);
+  }
+
   void SpikesPlayer::_checkSimData()
   {
-    auto spikeData = std::dynamic_pointer_cast< SpikeData >( _simData );
-    if ( spikeData->isDirty( ))
+    if ( _spikeData->isDirty( ))
     {
-      std::cout << "Loaded " << spikeData->spikes( ).size( ) << " spikes."
+      std::cout << "Loaded " << _spikeData->spikes( ).size( ) << " spikes."
                 << std::endl;
 
-      _currentSpike = spikeData->spikes( ).begin( );
+      // Cursors are positions, so they stay valid when spikes are appended.
+      // Seek them again in case the data was replaced.
+      _currentSpike = _spikeData->spikes( ).elementAt( _currentTime );
+      _previousSpike = _currentSpike;
 
-      _startTime = spikeData->startTime( );
-      _endTime = spikeData->endTime( );
+      _startTime = _spikeData->startTime( );
+      _endTime = _spikeData->endTime( );
 
       if (( _simData->endTime( ) - _simData->startTime( )) > 0 )
         _invTimeRange = 1.0f / ( _simData->endTime( ) - _simData->startTime( ));
@@ -301,7 +400,32 @@ namespace simil
 
       _relativeTime = ( _currentTime - _startTime ) * _invTimeRange;
 
-      spikeData->cleanDirty( );
+      // Appended spikes only invalidate what covers their times.
+      const float modified = _spikeData->modifiedFrom( );
+      if ( modified == -std::numeric_limits< float >::infinity( ))
+      {
+        _checkpoints.clear( );
+        _dataIndex.clear( );
+        _activity.clear( );
+      }
+      else if ( modified < std::numeric_limits< float >::infinity( ))
+      {
+        if ( _checkpoints.invalidate( modified ))
+          _checkpoints.buildAsync( _activity , _startTime , _endTime ,
+                                   spikes( ) , neuronIndex( ));
+        if ( _activity.valid( ) && modified < _activity.time( ))
+          _activity.clear( );
+      }
+
+      _spikeData->cleanDirty( );
+    }
+
+    const size_t neurons = neuronIndex( ).size( );
+    if ( neurons != _activityNeurons )
+    {
+      _checkpoints.clear( );
+      _activity.clear( );
+      _activityNeurons = neurons;
     }
   }
 }
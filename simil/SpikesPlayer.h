@@ -42,13 +42,17 @@
 #include "SpikeData.h"
 #include "DataSet.h"
 #include "SimulationPlayer.h"
+#include "SpikeFrame.h"
+#include "SpikeCursor.h"
+#include "NeuronActivity.h"
+#include "ActivityCheckpoints.h"
 
 #include <simil/api.h>
 
 namespace simil
 {
-  typedef TSpikes::iterator SpikesIter;
-  typedef TSpikes::const_iterator SpikesCIter;
+  typedef Spikes::iterator SpikesIter;
+  typedef Spikes::const_iterator SpikesCIter;
 
   typedef std::pair< SpikesIter , SpikesIter > SpikesRange;
   typedef std::pair< SpikesCIter , SpikesCIter > SpikesCRange;
@@ -90,20 +94,110 @@ namespace simil
 
     void spikesNowVect( std::vector< uint32_t >& );
 
+    /** \brief Returns the spikes of spikesNow( ) without copying them, with
+     * the dense index and the position of their neurons. Each call rebuilds
+     * the frame in the memory of the previous one.
+     *
+     */
+    const SpikeFrame& frame( void );
+
+    /** \brief Returns a cursor over the spikes of the player at its current
+     * time. Views that follow the player can keep cursors instead of
+     * players of their own, and move them with a SpikeClock.
+     * \param[in] window Length of the time window, zero to follow frames.
+     *
+     */
+    SpikeCursor cursor( float window = 0.0f );
+
+    /** \brief Sets how the neuron activity returned by activity( ) fades
+     * after each spike, and starts tracking it.
+     * \param[in] model Decay model.
+     * \param[in] duration Time constant of the exponential decay, or time
+     * to fade out of the linear one.
+     *
+     */
+    void setActivityDecay( TDecayModel model , float duration );
+
+    /** \brief Returns the activity of every neuron at the current time, in
+     * neuron index order. Once requested, the buffer is kept up to date on
+     * every frame and rebuilt when playback jumps.
+     *
+     */
+    const std::vector< float >& activity( void );
+
+    /** \brief Sets the time between the checkpoints of the activity buffer.
+     * Seeks restore the checkpoint before the new time and replay the
+     * spikes after it, instead of rebuilding the buffer.
+     * \param[in] interval Time between checkpoints, zero to disable them.
+     *
+     */
+    void setCheckpointInterval( float interval );
+
+    /** \brief Saves the activity checkpoints of the whole simulation in a
+     * background thread, so that first seeks are fast as well. Otherwise
+     * they are saved as seeks reach them.
+     *
+     */
+    void buildCheckpoints( void );
+
+    /** \brief Returns the spikes in the [startTime, endTime) window of the
+     * given neurons, such as the result of a SpatialIndex query.
+     * \param[in] startTime Start of the window.
+     * \param[in] endTime End of the window.
+     * \param[in] gids Neurons to keep.
+     * \param[out] result Spikes found, in time order.
+     *
+     */
+    void spikesBetween( float startTime , float endTime ,
+                        const GIDSet& gids , TSpikes& result );
+
     /** \brief Saves the spikes data in a CSV file.
      * \param[in] filename File name on disk of the CSV output file.
      * 
      */
     bool saveSpikesAsCSV(const std::string &filename);
 
+    /** \brief Saves the spikes, the network and the subsets in a native
+     * SimIL container, loaded back by memory mapping with TBINARY.
+     * \param[in] filename File name on disk of the container.
+     *
+     */
+    bool saveSpikesAsBinary(const std::string &filename);
+
   protected:
     void _checkSimData( ) override;
 
     void FrameProcess( ) override;
 
+    /** \brief Returns the index of the network neurons or, without network,
+     * of the simulation gids, built on first use.
+     *
+     */
+    const NeuronIndex& neuronIndex( void );
+
+    /** \brief Brings the activity buffer to the current time, if it is
+     * tracked.
+     * \param[in] seek True if playback jumped instead of moving one frame.
+     *
+     */
+    void updateActivity( bool seek );
+
+    // Resolved once on load, instead of casting _simData on every access.
+    std::shared_ptr< SpikeData > _spikeData;
+
     SpikesCIter _previousSpike;
     SpikesCIter _currentSpike;
 
+    SpikeFrame _frame;
+    NeuronIndex _dataIndex;
+
+    NeuronActivity _activity;
+    ActivityCheckpoints _checkpoints;
+    bool _trackActivity;
+
+    // Neurons of the index the activity and checkpoints were built for.
+    size_t _activityNeurons;
+
   };
 
 } // namespace simil
@@ -26,8 +26,8 @@
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/lexical_cast.hpp>
 
+#include <algorithm>
 #include <queue>
-#include <set>
 
 #include "loaders/auxiliar/H5SubsetEvents.h"
 
@@ -70,9 +70,9 @@ namespace simil
     return elems;
   }
 
-  std::set< uint32_t > parseGIDsJSON( const std::string& stringGIDs )
+  GIDSet parseGIDsJSON( const std::string& stringGIDs )
   {
-    std::set< uint32_t > result;
+    GIDSet result;
 
     std::vector< std::string > tokens = split( stringGIDs, ',', true );
 
@@ -93,8 +93,7 @@ namespace simil
 
           upperLimit = boost::lexical_cast< uint32_t >( range[ 1 ]);
 
-          for( unsigned int i = lowerLimit; i < upperLimit; i++ )
-            result.insert( i );
+          result.insertRange( lowerLimit, upperLimit );
         }
         catch(const std::exception& e)
         {
@@ -178,12 +177,8 @@ namespace simil
       {
         for( auto& child : subset.second )
         {
-          std::set< uint32_t > gidSet =
-            parseGIDsJSON( child.second.get_value< std::string >( ));
-
-          GIDVec gids( gidSet.begin( ), gidSet.end( ));
-
-          _subsets.insert( std::make_pair( child.first, gids ));
+          _subsets.insert( std::make_pair( child.first, parseGIDsJSON(
+            child.second.get_value< std::string >( ))));
         }
       }
 
@@ -197,6 +192,8 @@ namespace simil
           _events.insert( std::make_pair( child.first, timeFrame ));
         }
       }
+
+      _timeline = EventTimeline( _events );
     }
     catch( std::exception& e )
     {
@@ -220,6 +217,7 @@ namespace simil
       _events.insert(std::make_pair(tf.name, tf.timeFrames));
 
     _totalTime = reader.totalTime();
+    _timeline = EventTimeline( _events );
   }
 
   void SubsetEventManager::clear( void )
@@ -227,18 +225,22 @@ namespace simil
     _subsets.clear( );
     _events.clear( );
     _colors.clear();
+    _timeline = EventTimeline( );
   }
 
   std::vector< uint32_t >
   SubsetEventManager::getSubset( const std::string& name ) const
   {
-    std::vector<uint32_t> result;
+    const auto& gids = subsetGIDs( name );
+    return std::vector< uint32_t >( gids.begin( ), gids.end( ));
+  }
 
-    auto it = _subsets.find(name);
-    if (it != _subsets.end())
-      return it->second;
+  const GIDSet& SubsetEventManager::subsetGIDs( const std::string& name ) const
+  {
+    static const GIDSet empty;
 
-    return result;
+    auto it = _subsets.find( name );
+    return it != _subsets.end( ) ? it->second : empty;
   }
 
   vmml::Vector3f SubsetEventManager::getSubsetColor(const std::string &name) const
@@ -254,20 +256,75 @@ namespace simil
                                       const GIDVec& subset,
                                       const vmml::Vector3f& color)
   {
-    if (_subsets.count(name) > 0)
-    {
-      GIDVec &gidVecs = _subsets[name];
-      gidVecs.insert(gidVecs.end(), subset.begin(), subset.end());
+    addSubset( name, GIDSet( subset.begin( ), subset.end( )), color );
+  }
 
-      std::vector<uint32_t>::iterator ip;
-      ip = std::unique(gidVecs.begin(), gidVecs.end());
-      gidVecs.resize(std::distance(gidVecs.begin(), ip));
+  void SubsetEventManager::addSubset( const std::string& name,
+                                      const GIDSet& subset,
+                                      const vmml::Vector3f& color )
+  {
+    auto it = _subsets.find( name );
+    if( it != _subsets.end( ))
+    {
+      it->second |= subset;
     }
     else
     {
       _subsets.insert( std::make_pair( name, subset ));
-      _colors.insert(std::make_pair(name, color));
+      _colors.insert( std::make_pair( name, color ));
+    }
+  }
+
+  bool SubsetEventManager::isInSubset( const std::string& name,
+                                       uint32_t gid ) const
+  {
+    auto it = _subsets.find( name );
+    return it != _subsets.end( ) && it->second.contains( gid );
+  }
+
+  bool SubsetEventManager::hasSubset( const std::string& name ) const
+  {
+    return _subsets.count( name ) > 0;
+  }
+
+  std::vector< std::string > SubsetEventManager::subsetsOf( uint32_t gid ) const
+  {
+    std::vector< std::string > result;
+
+    for( const auto& subset : _subsets )
+      if( subset.second.contains( gid ))
+        result.push_back( subset.first );
+
+    return result;
+  }
+
+  GIDSet SubsetEventManager::subsetsUnion(
+    const std::vector< std::string >& names ) const
+  {
+    GIDSet result;
+
+    for( const auto& name : names )
+    {
+      auto it = _subsets.find( name );
+      if( it != _subsets.end( ))
+        result |= it->second;
     }
+
+    return result;
+  }
+
+  GIDSet SubsetEventManager::subsetsIntersection(
+    const std::vector< std::string >& names ) const
+  {
+    if( names.empty( ))
+      return GIDSet( );
+
+    GIDSet result = subsetGIDs( names.front( ));
+    for( auto name = names.begin( ) + 1;
+         name != names.end( ) && !result.empty( ); ++name )
+      result &= subsetGIDs( *name );
+
+    return result;
   }
 
   void SubsetEventManager::removeSubset( const std::string& name )
@@ -338,69 +395,48 @@ namespace simil
                                                          float deltaTime,
                                                          float totalTime ) const
   {
-    std::vector< bool > result;
-
-    EventVec eventVec = getEvent( name );
+    const auto& names = _timeline.names( );
+    const auto it = std::lower_bound( names.begin( ), names.end( ), name );
+    const auto event = _events.find( name );
 
-    if(eventVec.empty())
+    if( it == names.end( ) || *it != name || event->second.empty( ))
     {
       std::cout << "Warning: event " << name << " NOT found." << std::endl;
-      return result;
+      return std::vector< bool >( );
     }
 
-    // Calculate delta time inverse to avoid further division operations.
-    const double invDeltaTime = 1.0 / deltaTime;
-
-    // Threshold for considering an event active during bin time.
-    const float threshold = deltaTime * 0.5f;
-
-    // Calculate bins number.
-    const unsigned int binsNumber = std::ceil( totalTime * invDeltaTime );
-
-    result.resize( binsNumber, false );
-
-    std::vector< float > eventTime( binsNumber, 0.0f );
-
-    for( const auto& event : eventVec )
-    {
-      float acc = 0.0f;
-      unsigned int counter = 0;
-
-      unsigned int binStart = std::floor( event.first * invDeltaTime );
-      unsigned int binEnd = std::ceil( event.second * invDeltaTime );
-
-      if( binEnd > binsNumber )
-        binEnd = binsNumber;
-
-      if( binStart > binEnd )
-        continue;
-
-      acc = binStart * deltaTime;
-
-      for( auto binIt = eventTime.begin( ) + binStart;
-           binIt != eventTime.begin( ) + binEnd; ++binIt )
-      {
-
-        const auto lowerBound = (std::max)( acc, event.first );
-        const auto upperBound = (std::min)( acc + deltaTime, event.second );
+    return _timeline.activity( static_cast< uint32_t >( it - names.begin( )),
+                               deltaTime, totalTime );
+  }
 
-        *binIt += ( upperBound - lowerBound );
+  std::vector< std::vector< bool >>
+  SubsetEventManager::eventsActivity( float deltaTime, float totalTime ) const
+  {
+    return _timeline.activity( deltaTime, totalTime );
+  }
 
-        acc += deltaTime;
-        counter++;
-      }
+  std::vector< std::string >
+  SubsetEventManager::activeEvents( float time ) const
+  {
+    std::vector< std::string > result;
+    for( const auto event : _timeline.activeAt( time ))
+      result.push_back( _timeline.names( )[ event ]);
 
-      auto bin = result.begin( );
-      for( auto time : eventTime )
-      {
-        if( time >= threshold )
-          *bin = true;
+    return result;
+  }
 
-        ++bin;
-      }
-    }
+  std::vector< std::string >
+  SubsetEventManager::activeEvents( float startTime, float endTime ) const
+  {
+    std::vector< std::string > result;
+    for( const auto event : _timeline.activeBetween( startTime, endTime ))
+      result.push_back( _timeline.names( )[ event ]);
 
     return result;
   }
-}
 
+  const EventTimeline& SubsetEventManager::timeline( void ) const
+  {
+    return _timeline;
+  }
+}
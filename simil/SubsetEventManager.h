@@ -29,6 +29,7 @@
 #include <simil/api.h>
 
 #include "types.h"
+#include "EventTimeline.h"
 
 namespace simil
 {
@@ -47,9 +48,62 @@ namespace simil
 
     void addSubset( const std::string& name, const GIDVec& subset, const vmml::Vector3f &color = vmml::Vector3f{0,0,0} );
 
+    /** \brief Adds a subset, or merges the gids into the existing subset with
+     * the same name.
+     * \param[in] name Subset name.
+     * \param[in] subset Subset gids.
+     * \param[in] color Subset color, only used if the subset is new.
+     *
+     */
+    void addSubset( const std::string& name, const GIDSet& subset, const vmml::Vector3f &color = vmml::Vector3f{0,0,0} );
+
+    /** \brief Returns the sorted gids of the subset, empty if it doesn't
+     * exist.
+     * \param[in] name Subset name.
+     *
+     */
     std::vector< uint32_t > getSubset( const std::string& name ) const;
+
+    /** \brief Returns the gids of the subset without copying them, an empty
+     * set if it doesn't exist.
+     * \param[in] name Subset name.
+     *
+     */
+    const GIDSet& subsetGIDs( const std::string& name ) const;
+
     vmml::Vector3f getSubsetColor( const std::string& name) const;
 
+    /** \brief Returns true if the gid belongs to the subset.
+     * \param[in] name Subset name.
+     * \param[in] gid Gid to look for.
+     *
+     */
+    bool isInSubset( const std::string& name, uint32_t gid ) const;
+
+    /** \brief Returns true if there is a subset with the given name.
+     * \param[in] name Subset name.
+     *
+     */
+    bool hasSubset( const std::string& name ) const;
+
+    /** \brief Returns the names of the subsets the gid belongs to.
+     * \param[in] gid Gid to look for.
+     *
+     */
+    std::vector< std::string > subsetsOf( uint32_t gid ) const;
+
+    /** \brief Returns the gids that belong to any of the given subsets.
+     * \param[in] names Subset names, unknown ones are ignored.
+     *
+     */
+    GIDSet subsetsUnion( const std::vector< std::string >& names ) const;
+
+    /** \brief Returns the gids that belong to all the given subsets.
+     * \param[in] names Subset names, an unknown one gives an empty result.
+     *
+     */
+    GIDSet subsetsIntersection( const std::vector< std::string >& names ) const;
+
     void removeSubset( const std::string& name );
 
     std::vector< Event > getEvent( const std::string& name ) const;
@@ -70,12 +124,44 @@ namespace simil
     std::vector< bool > eventActivity( const std::string& name,
                                        float deltaTime,
                                        float totalTime ) const;
+
+    /** \brief Returns the activity bins of every event, in eventNames( )
+     * order, computed in a single pass over their time frames.
+     * \param[in] deltaTime Bin size.
+     * \param[in] totalTime Time covered by the bins.
+     *
+     */
+    std::vector< std::vector< bool >> eventsActivity( float deltaTime,
+                                                      float totalTime ) const;
+
+    /** \brief Returns the names of the events active at the given time.
+     * \param[in] time Time to query.
+     *
+     */
+    std::vector< std::string > activeEvents( float time ) const;
+
+    /** \brief Returns the names of the events active at some point of the
+     * [startTime, endTime) window.
+     * \param[in] startTime Start of the window.
+     * \param[in] endTime End of the window.
+     *
+     */
+    std::vector< std::string > activeEvents( float startTime,
+                                             float endTime ) const;
+
+    /** \brief Returns the index of the event time frames.
+     *
+     */
+    const EventTimeline& timeline( void ) const;
+
   protected:
 
-    std::map< std::string, std::vector< uint32_t >> _subsets;
+    SubsetMap _subsets;
     std::map< std::string, std::vector< std::pair< float, float >>> _events;
     std::map< std::string, vmml::Vector3f> _colors;
 
+    EventTimeline _timeline;
+
     float _totalTime;
   };
 
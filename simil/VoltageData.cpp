@@ -26,7 +26,9 @@
 
 // C++
 #include <vector>
+#include <algorithm>
 #include <cassert>
+#include <utility>
 #include "VoltageData.h"
 
 //----------------------------------------------------------------------------
@@ -50,14 +52,38 @@ simil::VoltageData::VoltageData(const std::string &, TDataType, const std::strin
 //----------------------------------------------------------------------------
 const simil::Voltages simil::VoltageData::voltagesAt(const float time) const
 {
-  Voltages result;
+  std::vector<float> values(m_groups.size());
+  voltagesAt(time, values.data(), values.size());
 
-  for(unsigned int i = 0; i < m_groupVoltages.size(); ++i)
-    result.emplace_back(time, voltageAt(i, time));
+  Voltages result;
+  result.reserve(values.size());
+  for(const auto value: values)
+    result.emplace_back(time, value);
 
   return result;
 }
 
+//----------------------------------------------------------------------------
+size_t simil::VoltageData::voltagesAt(const float time, float *values, const size_t size) const
+{
+  const size_t count = std::min(size, m_groups.size());
+
+  // Groups are stored matrix after matrix, in group order.
+  size_t first = 0;
+  for(auto it = m_matrices.cbegin(); it != m_matrices.cend() && first < count; ++it)
+  {
+    const size_t groups = std::min(it->groups(), count - first);
+    if(it->empty())
+      std::fill(values + first, values + first + groups, std::numeric_limits<float>::min());
+    else
+      it->interpolate(time, 0, groups, values + first);
+
+    first += groups;
+  }
+
+  return count;
+}
+
 //----------------------------------------------------------------------------
 void simil::VoltageData::setVoltages(const std::vector<std::string> groups,
                                      const simil::TVoltages &voltages )
@@ -66,52 +92,134 @@ void simil::VoltageData::setVoltages(const std::vector<std::string> groups,
   addVoltages(groups, voltages);
 }
 
+//----------------------------------------------------------------------------
+void simil::VoltageData::setVoltages(const std::vector<std::string> groups, VoltageMatrix matrix)
+{
+  clear();
+  addVoltages(groups, std::move(matrix));
+}
+
 //----------------------------------------------------------------------------
 void simil::VoltageData::addVoltages(const std::vector<std::string> groups,
                                      const simil::TVoltages &voltages )
 {
   // NOTE: doesn't take into cosideration repeated groups.
-  auto previous = m_groups.size();
-  m_groups.insert(m_groups.end(), groups.cbegin(), groups.cend());
-  m_groupRanges.resize(previous + groups.size(), {std::numeric_limits<float>::max(), std::numeric_limits<float>::min()});
-  m_groupVoltages.resize(previous + groups.size());
-
-  float minTime = previous > 0 ? startTime() : std::numeric_limits<float>::max();
-  float maxTime = previous > 0 ? endTime() : std::numeric_limits<float>::min();
-  auto insertValues = [&](const std::tuple<float, float, int> &t)
+  std::vector<Voltages> groupVoltages(groups.size());
+  auto insertValues = [&groupVoltages](const std::tuple<float, float, int> &t)
   {
-    const auto group = std::get<2>(t) + previous;
-    const auto value = std::get<1>(t);
-    const auto time = std::get<0>(t);
-    m_groupVoltages[group].emplace_back(time, value);
-    m_groupRanges[group] = { std::min(m_groupRanges[group].first, value),
-                            std::max(m_groupRanges[group].second, value) };
-
-    minTime = std::min(minTime, time);
-    maxTime = std::max(maxTime, time);
+    groupVoltages[std::get<2>(t)].emplace_back(std::get<0>(t), std::get<1>(t));
   };
   std::for_each(voltages.cbegin(), voltages.cend(), insertValues);
 
-  // Update timestep.
-  if (m_timeStep < 0.f)
-    m_timeStep = std::numeric_limits<float>::max();
+  auto isBefore = [](const std::pair<float, float> &a, const std::pair<float, float> &b){ return a.first < b.first; };
+  auto sameTime = [](const std::pair<float, float> &a, const std::pair<float, float> &b){ return a.first == b.first; };
+  bool sharedTimes = !groupVoltages.empty();
+  for(auto &groupVoltage: groupVoltages)
+  {
+    std::stable_sort(groupVoltage.begin(), groupVoltage.end(), isBefore);
+    sharedTimes &= !groupVoltage.empty() && groupVoltage.size() == groupVoltages.front().size() &&
+                   std::equal(groupVoltage.cbegin(), groupVoltage.cend(), groupVoltages.front().cbegin(), sameTime);
+  }
+
+  // Groups sampled at the same times share a matrix, the rest get one each.
+  std::vector<float> row;
+  if(sharedTimes)
+  {
+    const auto &times = groupVoltages.front();
+    VoltageMatrix matrix(groups.size());
+    matrix.reserve(times.size());
+    row.resize(groups.size());
+    for(size_t i = 0; i < times.size(); ++i)
+    {
+      for(size_t group = 0; group < groups.size(); ++group)
+        row[group] = groupVoltages[group][i].second;
+      matrix.appendRow(times[i].first, row.data());
+    }
+
+    addVoltages(groups, std::move(matrix));
+    return;
+  }
+
+  m_groups.insert(m_groups.end(), groups.cbegin(), groups.cend());
+  for(const auto &groupVoltage: groupVoltages)
+  {
+    VoltageMatrix matrix(1);
+    matrix.reserve(groupVoltage.size());
+    for(const auto &value: groupVoltage)
+      matrix.appendRow(value.first, &value.second);
+
+    addMatrix(std::move(matrix));
+  }
 
-  for (unsigned int i = 0; i < groups.size(); ++i)
-      m_timeStep = std::min(m_timeStep, simil::CSVVoltages::groupTimeStep(voltages, i));
+  insertFakeGidsAndPositions();
+}
 
-  // Update times.
-  assert(maxTime - minTime > 0);
-  setStartTime(minTime);
-  setEndTime(maxTime);
+//----------------------------------------------------------------------------
+void simil::VoltageData::addVoltages(const std::vector<std::string> groups, VoltageMatrix matrix)
+{
+  assert(groups.size() == matrix.groups());
+
+  m_groups.insert(m_groups.end(), groups.cbegin(), groups.cend());
+  addMatrix(std::move(matrix));
 
   insertFakeGidsAndPositions();
 }
 
+//----------------------------------------------------------------------------
+void simil::VoltageData::addMatrix(VoltageMatrix matrix)
+{
+  const bool first = m_matrices.empty();
+  const auto index = static_cast<unsigned int>(m_matrices.size());
+  for(unsigned int column = 0; column < matrix.groups(); ++column)
+  {
+    m_groupColumns.emplace_back(index, column);
+    m_groupRanges.push_back(matrix.range(column));
+  }
+
+  if(!matrix.empty())
+  {
+    // Update timestep.
+    if (m_timeStep < 0.f)
+      m_timeStep = std::numeric_limits<float>::max();
+
+    if(matrix.rows() > 1)
+      m_timeStep = std::min(m_timeStep, simil::CSVVoltages::timeStep(matrix.times()));
+
+    // Update times.
+    const float minTime = matrix.times().front();
+    const float maxTime = matrix.times().back();
+    const bool hasTimes = !first && endTime() > startTime();
+    setStartTime(hasTimes ? std::min(startTime(), minTime) : minTime);
+    setEndTime(hasTimes ? std::max(endTime(), maxTime) : maxTime);
+    assert(endTime() - startTime() > 0);
+  }
+
+  m_matrices.push_back(std::move(matrix));
+}
+
+//----------------------------------------------------------------------------
+void simil::VoltageData::setHalfPrecision(const bool halfPrecision)
+{
+  for(auto &matrix: m_matrices)
+    matrix.setHalfPrecision(halfPrecision);
+}
+
+//----------------------------------------------------------------------------
+size_t simil::VoltageData::memoryUsage() const
+{
+  size_t result = 0;
+  for(const auto &matrix: m_matrices)
+    result += matrix.memoryUsage();
+
+  return result;
+}
+
 //----------------------------------------------------------------------------
 void simil::VoltageData::clear()
 {
   m_groups.clear();
-  m_groupVoltages.clear();
+  m_matrices.clear();
+  m_groupColumns.clear();
   m_groupRanges.clear();
   m_timeStep = -1.f;
 }
@@ -123,18 +231,40 @@ simil::VoltageData* simil::VoltageData::get(void)
 }
 
 //----------------------------------------------------------------------------
-const simil::Voltages &simil::VoltageData::voltagesOf(const unsigned int groupIndex) const
+simil::Voltages simil::VoltageData::voltagesOf(const unsigned int groupIndex) const
+{
+  const auto &matrix = matrixOf(groupIndex);
+  const auto column = columnOf(groupIndex);
+
+  Voltages result;
+  result.reserve(matrix.rows());
+  for(size_t row = 0; row < matrix.rows(); ++row)
+    result.emplace_back(matrix.time(row), matrix.value(row, column));
+
+  return result;
+}
+
+//----------------------------------------------------------------------------
+const simil::VoltageMatrix &simil::VoltageData::matrixOf(const unsigned int groupIndex) const
 {
-  assert(groupIndex < m_groupVoltages.size());
+  assert(groupIndex < m_groupColumns.size());
 
-  return m_groupVoltages[groupIndex];
+  return m_matrices[m_groupColumns[groupIndex].first];
+}
+
+//----------------------------------------------------------------------------
+unsigned int simil::VoltageData::columnOf(const unsigned int groupIndex) const
+{
+  assert(groupIndex < m_groupColumns.size());
+
+  return m_groupColumns[groupIndex].second;
 }
 
 //----------------------------------------------------------------------------
 unsigned long long simil::VoltageData::sizeOfGroup(const unsigned int groupIndex) const
 {
-  if(groupIndex < m_groupVoltages.size())
-    return m_groupVoltages[groupIndex].size();
+  if(groupIndex < m_groupColumns.size())
+    return matrixOf(groupIndex).rows();
 
   return 0;
 }
@@ -144,7 +274,7 @@ void simil::VoltageData::insertFakeGidsAndPositions()
 {
   TGIDSet gids;
   TPosVect positions;
-  for (unsigned int i = 0; i < m_groupVoltages.size(); ++i)
+  for (unsigned int i = 0; i < m_groups.size(); ++i)
   {
     gids.emplace(i);
     positions.emplace_back(0, 0, 0);
@@ -159,27 +289,11 @@ float simil::VoltageData::voltageAt(const unsigned int group, const float time)
 {
   if(group >= m_groups.size()) return std::numeric_limits<float>::min();
 
-  const auto &groupVoltage = m_groupVoltages[group];
-  if(groupVoltage.empty()) return std::numeric_limits<float>::min();
-  assert(m_timeStep > 0.f);
-
-  auto firstVoltage = groupVoltage.front();
-  if(time <= firstVoltage.first)
-    return firstVoltage.second;
-
-  auto lastVoltage = groupVoltage.back();
-  if(time >= lastVoltage.first)
-    return lastVoltage.second;
-
-  // interpolation between values in an interval
-  auto findInterval = [&time](const std::pair<float, float> &p){ return p.first > time; };
-  auto it = std::find_if(groupVoltage.cbegin(), groupVoltage.cend(), findInterval);
-  assert(it != groupVoltage.cend());
-  auto valueA = (*(it-1));
-  auto valueB = (*it);
+  const auto &matrix = matrixOf(group);
+  if(matrix.empty()) return std::numeric_limits<float>::min();
 
-  const auto weightA = 1 - (std::abs(time - valueA.first)/m_timeStep);
-  const auto weightB = 1 - weightA;
+  float value;
+  matrix.interpolate(time, columnOf(group), 1, &value);
 
-  return (weightA * valueA.second) + (weightB * valueB.second);
+  return value;
 }
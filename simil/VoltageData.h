@@ -25,6 +25,7 @@
 
 // SimIL
 #include <simil/SimulationData.h>
+#include <simil/VoltageMatrix.h>
 
 namespace simil
 {
@@ -62,6 +63,17 @@ namespace simil
        */
       float voltageAt(const unsigned int group, const float time) const;
 
+      /** \brief Writes the voltage of every group at the given time into the
+       * given buffer, using linear interpolation. The groups of each matrix
+       * are interpolated together from two contiguous rows.
+       * \param[in] time Time.
+       * \param[out] values Buffer for one value per group, in group order.
+       * \param[in] size Size of the buffer.
+       * \return Number of values written.
+       *
+       */
+      size_t voltagesAt(const float time, float *values, const size_t size) const;
+
       /** \brief Sets the voltages data.
        * \param[in] groups Groups names.
        * \param[in] voltages TVoltages vector.
@@ -69,6 +81,13 @@ namespace simil
        */
       void setVoltages(const std::vector<std::string> groups, const simil::TVoltages &voltages );
 
+      /** \brief Sets the voltages data from a matrix, such as the one of a loader.
+       * \param[in] groups Groups names, one per matrix column.
+       * \param[in] matrix Voltages of the groups.
+       *
+       */
+      void setVoltages(const std::vector<std::string> groups, VoltageMatrix matrix);
+
       /** \brief Adds the given voltages to the class.
        * Warning: it's not a merge, groups are treated as different, its a concatenation.
        * \param[in] groups Groups names.
@@ -77,6 +96,25 @@ namespace simil
        */
       void addVoltages(const std::vector<std::string> groups, const simil::TVoltages &voltages );
 
+      /** \brief Adds the groups of the given matrix to the class, keeping their times.
+       * \param[in] groups Groups names, one per matrix column.
+       * \param[in] matrix Voltages of the groups.
+       *
+       */
+      void addVoltages(const std::vector<std::string> groups, VoltageMatrix matrix);
+
+      /** \brief Stores the voltages as half precision floats, or back as single
+       * precision ones.
+       * \param[in] halfPrecision True to store half precision values.
+       *
+       */
+      void setHalfPrecision(const bool halfPrecision);
+
+      /** \brief Returns the bytes used by the voltages.
+       *
+       */
+      size_t memoryUsage() const;
+
       /** \brief Returns the group ranges, ordered.
        *
        */
@@ -105,11 +143,23 @@ namespace simil
        */
       VoltageData* get();
 
-      /** \brief Returns the voltages of the given group. 
+      /** \brief Returns a copy of the voltages of the given group.
        * \param[in] groupIndex Group position in the vector. 
        * 
       */
-      const Voltages& voltagesOf(const unsigned int groupIndex) const;
+      Voltages voltagesOf(const unsigned int groupIndex) const;
+
+      /** \brief Returns the matrix holding the voltages of the given group.
+       * \param[in] groupIndex Group position in the vector.
+       *
+      */
+      const VoltageMatrix& matrixOf(const unsigned int groupIndex) const;
+
+      /** \brief Returns the column of the given group in its matrix.
+       * \param[in] groupIndex Group position in the vector.
+       *
+      */
+      unsigned int columnOf(const unsigned int groupIndex) const;
 
       /** \brief Returns the number of values in the given group.
        * \param[in] groupIndex Group position in the vector. 
@@ -119,11 +169,19 @@ namespace simil
 
     protected:
       std::vector<std::string>             m_groups;        /** groups names. */
-      std::vector<Voltages>                m_groupVoltages; /** groups voltages, separated */
+      std::vector<VoltageMatrix>           m_matrices;      /** voltages of groups sampled at the same times. */
+      std::vector<std::pair<unsigned int, unsigned int>> m_groupColumns; /** matrix and column of each group. */
       std::vector<std::pair<float, float>> m_groupRanges;   /** groups voltage ranges. */
       float                                m_timeStep;      /** voltages time step. */
 
     private:
+      /** \brief Appends the groups of the given matrix and updates the ranges
+       * and times.
+       * \param[in] matrix Voltages of the new groups.
+       *
+       */
+      void addMatrix(VoltageMatrix matrix);
+
       /** \brief Helper method to fill gids and positions for compatibiliy. 
        * 
       */
@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "VoltageMatrix.h"
+#include "SpikeKernels.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+namespace
+{
+  // Relative spread of the intervals between rows of uniformly sampled data.
+  constexpr float STEP_TOLERANCE = 1e-3f;
+
+  // Groups interpolated at once when values are decoded from half precision.
+  constexpr size_t BLOCK_SIZE = 256;
+}
+
+namespace simil
+{
+  VoltageMatrix::VoltageMatrix( void )
+  : VoltageMatrix( 0 )
+  { }
+
+  VoltageMatrix::VoltageMatrix( size_t groups, bool halfPrecision )
+  : _groups( groups )
+  , _halfPrecision( halfPrecision )
+  , _minStep( std::numeric_limits< float >::max( ))
+  , _maxStep( 0.0f )
+  { }
+
+  void VoltageMatrix::reset( size_t groups )
+  {
+    clear( );
+    _groups = groups;
+  }
+
+  void VoltageMatrix::clear( void )
+  {
+    _times.clear( );
+    _values.clear( );
+    _halves.clear( );
+    _minStep = std::numeric_limits< float >::max( );
+    _maxStep = 0.0f;
+  }
+
+  void VoltageMatrix::reserve( size_t rows )
+  {
+    _times.reserve( rows );
+    if( _halfPrecision )
+      _halves.reserve( rows * _groups );
+    else
+      _values.reserve( rows * _groups );
+  }
+
+  void VoltageMatrix::appendRow( float time, const float* values )
+  {
+    if( _times.empty( ) || _times.back( ) <= time )
+    {
+      if( !_times.empty( ))
+      {
+        const float interval = time - _times.back( );
+        _minStep = std::min( _minStep, interval );
+        _maxStep = std::max( _maxStep, interval );
+      }
+
+      _times.push_back( time );
+      if( _halfPrecision )
+      {
+        _halves.resize( _halves.size( ) + _groups );
+        kernels::floatsToHalves( values, _groups,
+                                 _halves.data( ) + _halves.size( ) - _groups );
+      }
+      else
+        _values.insert( _values.end( ), values, values + _groups );
+
+      return;
+    }
+
+    // Out of order: insert the row in its place.
+    const auto position = std::upper_bound( _times.begin( ), _times.end( ),
+                                            time );
+    const size_t row_ = std::distance( _times.begin( ), position );
+    _times.insert( position, time );
+    if( _halfPrecision )
+    {
+      std::vector< uint16_t > halves( _groups );
+      kernels::floatsToHalves( values, _groups, halves.data( ));
+      _halves.insert( _halves.begin( ) + row_ * _groups, halves.begin( ),
+                      halves.end( ));
+    }
+    else
+      _values.insert( _values.begin( ) + row_ * _groups, values,
+                      values + _groups );
+
+    updateSteps( );
+  }
+
+  void VoltageMatrix::appendRows( const std::vector< float >& times,
+                                  const std::vector< float >& values )
+  {
+    assert( values.size( ) == times.size( ) * _groups );
+
+    _times.reserve( _times.size( ) + times.size( ));
+    for( size_t i = 0; i < times.size( ); ++i )
+      appendRow( times[ i ], values.data( ) + i * _groups );
+  }
+
+  void VoltageMatrix::setHalfPrecision( bool halfPrecision )
+  {
+    if( halfPrecision == _halfPrecision )
+      return;
+
+    if( halfPrecision )
+    {
+      _halves.resize( _values.size( ));
+      kernels::floatsToHalves( _values.data( ), _values.size( ),
+                               _halves.data( ));
+      std::vector< float >( ).swap( _values );
+    }
+    else
+    {
+      _values.resize( _halves.size( ));
+      kernels::halvesToFloats( _halves.data( ), _halves.size( ),
+                               _values.data( ));
+      std::vector< uint16_t >( ).swap( _halves );
+    }
+
+    _halfPrecision = halfPrecision;
+  }
+
+  float VoltageMatrix::value( size_t row_, size_t group ) const
+  {
+    assert( row_ < rows( ) && group < _groups );
+
+    float result;
+    this->row( row_, group, 1, &result );
+    return result;
+  }
+
+  void VoltageMatrix::row( size_t row_, size_t first, size_t count,
+                           float* result ) const
+  {
+    assert( first + count <= _groups );
+
+    const size_t offset = row_ * _groups + first;
+    if( _halfPrecision )
+      kernels::halvesToFloats( _halves.data( ) + offset, count, result );
+    else
+      std::copy( _values.data( ) + offset, _values.data( ) + offset + count,
+                 result );
+  }
+
+  float VoltageMatrix::step( void ) const
+  {
+    if( _times.size( ) < 2 || !( _minStep > 0.0f ) ||
+        _maxStep - _minStep > _minStep * STEP_TOLERANCE )
+      return 0.0f;
+
+    return ( _times.back( ) - _times.front( )) / ( _times.size( ) - 1 );
+  }
+
+  VoltageMatrix::Interval VoltageMatrix::interval( float time_ ) const
+  {
+    if( _times.empty( ) || time_ <= _times.front( ))
+      return { 0, 0, 0.0f };
+
+    const size_t lastRow = _times.size( ) - 1;
+    if( time_ >= _times.back( ))
+      return { lastRow, lastRow, 0.0f };
+
+    size_t index;
+    const float step_ = step( );
+    if( step_ > 0.0f )
+    {
+      // The index is computed from the time, then nudged in case rounding
+      // in the stored times puts it one row off.
+      const float position = ( time_ - _times.front( )) / step_;
+      index = std::min( static_cast< size_t >( position ), lastRow - 1 );
+      while( index > 0 && _times[ index ] > time_ )
+        --index;
+      while( index + 1 < lastRow && _times[ index + 1 ] <= time_ )
+        ++index;
+    }
+    else
+      index = std::distance( _times.begin( ),
+        std::upper_bound( _times.begin( ), _times.end( ), time_ )) - 1;
+
+    const float length = _times[ index + 1 ] - _times[ index ];
+    const float weight = length > 0.0f ?
+      ( time_ - _times[ index ]) / length : 0.0f;
+
+    return { index, index + 1, weight };
+  }
+
+  void VoltageMatrix::interpolate( float time_, size_t first, size_t count,
+                                   float* result ) const
+  {
+    if( _times.empty( ))
+      return;
+
+    const auto interval_ = interval( time_ );
+    if( !_halfPrecision )
+    {
+      const float* rowA = _values.data( ) + interval_.first * _groups + first;
+      const float* rowB = _values.data( ) + interval_.second * _groups + first;
+      std::copy( rowA, rowA + count, result );
+      kernels::interpolateValues( result, rowB, count, interval_.weight );
+      return;
+    }
+
+    float next[ BLOCK_SIZE ];
+    for( size_t i = 0; i < count; i += BLOCK_SIZE )
+    {
+      const size_t blockSize = std::min( count - i, BLOCK_SIZE );
+      row( interval_.first, first + i, blockSize, result + i );
+      row( interval_.second, first + i, blockSize, next );
+      kernels::interpolateValues( result + i, next, blockSize,
+                                  interval_.weight );
+    }
+  }
+
+  std::pair< float, float > VoltageMatrix::range( size_t group ) const
+  {
+    auto result = std::make_pair( std::numeric_limits< float >::max( ),
+                                  std::numeric_limits< float >::lowest( ));
+    for( size_t row_ = 0; row_ < rows( ); ++row_ )
+    {
+      const float value_ = value( row_, group );
+      result.first = std::min( result.first, value_ );
+      result.second = std::max( result.second, value_ );
+    }
+
+    return result;
+  }
+
+  size_t VoltageMatrix::memoryUsage( void ) const
+  {
+    return _times.capacity( ) * sizeof( float ) +
+           _values.capacity( ) * sizeof( float ) +
+           _halves.capacity( ) * sizeof( uint16_t );
+  }
+
+  void VoltageMatrix::updateSteps( void )
+  {
+    _minStep = std::numeric_limits< float >::max( );
+    _maxStep = 0.0f;
+    for( size_t i = 1; i < _times.size( ); ++i )
+    {
+      const float interval_ = _times[ i ] - _times[ i - 1 ];
+      _minStep = std::min( _minStep, interval_ );
+      _maxStep = std::max( _maxStep, interval_ );
+    }
+  }
+}
@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef __SIMIL_VOLTAGEMATRIX_H__
+#define __SIMIL_VOLTAGEMATRIX_H__
+
+#include <simil/api.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace simil
+{
+  /** \class VoltageMatrix
+   * \brief Voltages of several groups sampled at the same times.
+   *
+   * The times are stored once, and the values in a row-major matrix with
+   * one row per time and one column per group, so reading every group at
+   * a time is a contiguous read. Values can be stored as half precision
+   * floats to halve the memory, at the cost of about three significant
+   * digits.
+   *
+   * Rows are kept in time order. Rows appended out of order are inserted
+   * in their place.
+   *
+   */
+  class SIMIL_API VoltageMatrix
+  {
+  public:
+
+    /** \brief Rows around a time and position between them. */
+    struct Interval
+    {
+      size_t first;
+      size_t second;
+      float weight;
+    };
+
+    VoltageMatrix( void );
+
+    /** \brief VoltageMatrix class constructor.
+     * \param[in] groups Number of groups, the columns of the matrix.
+     * \param[in] halfPrecision True to store half precision values.
+     *
+     */
+    explicit VoltageMatrix( size_t groups, bool halfPrecision = false );
+
+    /** \brief Removes every row and sets the number of groups.
+     * \param[in] groups Number of groups, the columns of the matrix.
+     *
+     */
+    void reset( size_t groups );
+
+    /** \brief Removes every row, keeping the groups.
+     *
+     */
+    void clear( void );
+
+    void reserve( size_t rows );
+
+    /** \brief Adds the values of every group at a time.
+     * \param[in] time Time of the values.
+     * \param[in] values One value per group, in group order.
+     *
+     */
+    void appendRow( float time, const float* values );
+
+    /** \brief Adds consecutive rows.
+     * \param[in] times Time of every row, in time order.
+     * \param[in] values Values of every row, one row after the other.
+     *
+     */
+    void appendRows( const std::vector< float >& times,
+                     const std::vector< float >& values );
+
+    /** \brief Converts the values between single and half precision.
+     * \param[in] halfPrecision True to store half precision values.
+     *
+     */
+    void setHalfPrecision( bool halfPrecision );
+
+    bool halfPrecision( void ) const
+    {
+      return _halfPrecision;
+    }
+
+    size_t rows( void ) const
+    {
+      return _times.size( );
+    }
+
+    size_t groups( void ) const
+    {
+      return _groups;
+    }
+
+    bool empty( void ) const
+    {
+      return _times.empty( );
+    }
+
+    const std::vector< float >& times( void ) const
+    {
+      return _times;
+    }
+
+    float time( size_t row ) const
+    {
+      return _times[ row ];
+    }
+
+    /** \brief Returns the value of a group at a row.
+     * \param[in] row Row index.
+     * \param[in] group Group index.
+     *
+     */
+    float value( size_t row, size_t group ) const;
+
+    /** \brief Copies the values of some groups at a row.
+     * \param[in] row Row index.
+     * \param[in] first First group to copy.
+     * \param[in] count Number of groups to copy.
+     * \param[out] result Values, in group order.
+     *
+     */
+    void row( size_t row, size_t first, size_t count, float* result ) const;
+
+    /** \brief Returns the time between rows if they are uniformly sampled,
+     * or zero otherwise.
+     *
+     */
+    float step( void ) const;
+
+    /** \brief Returns the rows around the given time, by direct index if the
+     * rows are uniformly sampled or by binary search. Times outside the
+     * matrix get the first or the last row.
+     * \param[in] time Time.
+     *
+     */
+    Interval interval( float time ) const;
+
+    /** \brief Interpolates some groups at the given time.
+     * \param[in] time Time.
+     * \param[in] first First group to interpolate.
+     * \param[in] count Number of groups to interpolate.
+     * \param[out] result Values, in group order.
+     *
+     */
+    void interpolate( float time, size_t first, size_t count,
+                      float* result ) const;
+
+    /** \brief Returns the smallest and largest value of a group.
+     * \param[in] group Group index.
+     *
+     */
+    std::pair< float, float > range( size_t group ) const;
+
+    /** \brief Returns the bytes used by the times and values.
+     *
+     */
+    size_t memoryUsage( void ) const;
+
+  protected:
+
+    /** \brief Recomputes the bounds of the intervals between rows.
+     *
+     */
+    void updateSteps( void );
+
+    size_t _groups;
+    bool _halfPrecision;
+
+    std::vector< float > _times;
+    std::vector< float > _values;
+    std::vector< uint16_t > _halves;
+
+    // Bounds of the intervals between rows, to detect uniform sampling.
+    float _minStep;
+    float _maxStep;
+  };
+}
+
+#endif /* __SIMIL_VOLTAGEMATRIX_H__ */
@@ -140,7 +140,7 @@ void simil::VoltagesPlayer::initIterators()
     return;
 
   for (unsigned int i = 0; i < voltagesData->groups().size(); ++i)
-    m_iterators.emplace_back(voltagesData->voltagesOf(i));
+    m_iterators.emplace_back(voltagesData->matrixOf(i), voltagesData->columnOf(i));
 
 #ifdef TEST
   const std::string name = "/home/felix/Desarrollo/Code/TFM/test_";
@@ -152,12 +152,17 @@ void simil::VoltagesPlayer::initIterators()
 }
 
 //----------------------------------------------------------------------------
-simil::VoltagesPlayer::VoltageIterator::VoltageIterator(const simil::Voltages &data)
-: m_data{data}
+simil::VoltagesPlayer::VoltageIterator::VoltageIterator(const simil::VoltageMatrix &matrix, const unsigned int column)
+: m_it0{0}
+, m_it1{1}
+, m_it2{2}
+, m_it3{3}
+, m_data{matrix}
+, m_column{column}
 {
   begin();
   m_type = InterpolationType::LINEAR;
-  assert(data.size() >= 4);
+  assert(matrix.rows() >= 4);
 #ifdef TEST
   m_requests = 0;
   m_failed = 0;
@@ -182,20 +187,20 @@ float simil::VoltagesPlayer::VoltageIterator::value(const float timePos)
   if (!isInTime(timePos))
   {
     // try to put the timePos between it1 and it2
-    while (!isAtEnd() && timePos > (*m_it2).first)
+    while (!isAtEnd() && timePos > timeOf(m_it2))
       this->operator++();
 
-    if (timePos > (*m_it3).first)
+    if (timePos > timeOf(m_it3))
       return 0;
 
-    while (!isAtBegin() && timePos < (*m_it1).first)
+    while (!isAtBegin() && timePos < timeOf(m_it1))
       this->operator--();
 
-    if (timePos < (*m_it0).first)
+    if (timePos < timeOf(m_it0))
       return 0;
   }
 
-  assert((*m_it0).first <= timePos && timePos <= (*m_it3).first);
+  assert(timeOf(m_it0) <= timePos && timePos <= timeOf(m_it3));
 
   switch (m_type)
   {
@@ -253,7 +258,7 @@ void simil::VoltagesPlayer::VoltageIterator::begin()
 {
   if (!isAtBegin())
   {
-    m_it0 = m_data.cbegin();
+    m_it0 = 0;
     m_it1 = m_it0 + 1;
     m_it2 = m_it0 + 2;
     m_it3 = m_it0 + 3;
@@ -266,7 +271,7 @@ void simil::VoltagesPlayer::VoltageIterator::end()
 {
   if (!isAtEnd())
   {
-    m_it3 = m_data.cend() - 1;
+    m_it3 = m_data.rows() - 1;
     m_it2 = m_it3 - 1;
     m_it1 = m_it3 - 2;
     m_it0 = m_it3 - 3;
@@ -277,13 +282,13 @@ void simil::VoltagesPlayer::VoltageIterator::end()
 //----------------------------------------------------------------------------
 bool simil::VoltagesPlayer::VoltageIterator::isAtEnd() const
 {
-  return m_it3 == m_data.cend() - 1;
+  return m_it3 == m_data.rows() - 1;
 }
 
 //----------------------------------------------------------------------------
 bool simil::VoltagesPlayer::VoltageIterator::isAtBegin() const
 {
-  return m_it0 == m_data.cbegin();
+  return m_it0 == 0;
 }
 
 //----------------------------------------------------------------------------
@@ -293,8 +298,8 @@ void simil::VoltagesPlayer::VoltageIterator::moveAtTime(const float time)
     return;
 
   // Assumes m_data is sorted by time.
-  const auto startTime = (*m_data.cbegin()).first;
-  const auto endTime = (*(m_data.cend() - 1)).first;
+  const auto startTime = timeOf(0);
+  const auto endTime = timeOf(m_data.rows() - 1);
   assert(time >= startTime && time <= endTime);
 
   moveAtPercentage((time - startTime) / (endTime - startTime));
@@ -305,8 +310,8 @@ void simil::VoltagesPlayer::VoltageIterator::moveAtPercentage(const float percen
 {
   // Assumes m_data is sorted by time.
   assert(percentage >= 0.f && percentage <= 1.f);
-  const auto startTime = (*m_data.cbegin()).first;
-  const auto endTime = (*(m_data.cend() - 1)).first;
+  const auto startTime = timeOf(0);
+  const auto endTime = timeOf(m_data.rows() - 1);
   const auto timePos = startTime + (percentage * (endTime - startTime));
   assert(timePos >= startTime && timePos <= endTime);
 
@@ -314,15 +319,15 @@ void simil::VoltagesPlayer::VoltageIterator::moveAtPercentage(const float percen
     return;
 
   // try to guess its position.
-  const unsigned int itPos = (m_data.size() - 1) * percentage;
+  const unsigned int itPos = (m_data.rows() - 1) * percentage;
 
   if (itPos < 4)
     begin();
-  else if (itPos > m_data.size() - 4)
+  else if (itPos > m_data.rows() - 4)
     end();
   else
   {
-    m_it0 = m_data.cbegin() + itPos;
+    m_it0 = itPos;
     m_it1 = m_it0 + 1;
     m_it2 = m_it0 + 2;
     m_it3 = m_it0 + 3;
@@ -330,8 +335,8 @@ void simil::VoltagesPlayer::VoltageIterator::moveAtPercentage(const float percen
   }
 
   // try to get the timePos in the it1 and it2 interval in catmull and it0 and it1 in linear.
-  const float endVal = m_type == InterpolationType::LINEAR ? (*m_it1).first : (*m_it2).first;
-  const float beginVal = m_type == InterpolationType::LINEAR ? (*m_it0).first : (*m_it1).first;
+  const float endVal = m_type == InterpolationType::LINEAR ? timeOf(m_it1) : timeOf(m_it2);
+  const float beginVal = m_type == InterpolationType::LINEAR ? timeOf(m_it0) : timeOf(m_it1);
   while (!isAtEnd() && timePos > endVal)
     this->operator++();
 
@@ -346,13 +351,13 @@ bool simil::VoltagesPlayer::VoltageIterator::isInTime(const float time) const
   {
     default:
     case InterpolationType::LINEAR:
-      return (*m_it0).first <= time && time <= (*m_it3).first;
+      return timeOf(m_it0) <= time && time <= timeOf(m_it3);
     case InterpolationType::SPLINE:
       if (isAtBegin())
-        return ((*m_it0).first <= time && time <= (*m_it2).first);
+        return (timeOf(m_it0) <= time && time <= timeOf(m_it2));
       if (isAtEnd())
-        return ((*m_it1).first <= time && time <= (*m_it3).first);
-      return ((*m_it1).first <= time && time <= (*m_it2).first);
+        return (timeOf(m_it1) <= time && time <= timeOf(m_it3));
+      return (timeOf(m_it1) <= time && time <= timeOf(m_it2));
   }
 
   throw std::runtime_error("Invalid isInTime execution.");
@@ -369,7 +374,7 @@ void simil::VoltagesPlayer::VoltageIterator::test(const std::string &csvFile, co
     file << "time, linear, catmull, diff\n";
     file << std::fixed << std::setprecision(4);
     // file << "time, catmull\n";
-    for (float i = m_data.front().first; i < m_data.back().first; i += increment)
+    for (float i = timeOf(0); i < timeOf(m_data.rows() - 1); i += increment)
     {
       moveAtTime(i);
       const float l = linearInterpolation(i);
@@ -386,12 +391,12 @@ void simil::VoltagesPlayer::VoltageIterator::test(const std::string &csvFile, co
 }
 
 //----------------------------------------------------------------------------
-float simil::VoltagesPlayer::VoltageIterator::linear(const Voltages::const_iterator &A, const Voltages::const_iterator &B, const float value) const
+float simil::VoltagesPlayer::VoltageIterator::linear(const size_t A, const size_t B, const float value) const
 {
-  const auto &x0 = (*A).first;
-  const auto &y0 = (*A).second;
-  const auto &x1 = (*B).first;
-  const auto &y1 = (*B).second;
+  const auto x0 = timeOf(A);
+  const auto y0 = valueOf(A);
+  const auto x1 = timeOf(B);
+  const auto y1 = valueOf(B);
 
   assert(value >= x0 && value <= x1);
 
@@ -401,10 +406,10 @@ float simil::VoltagesPlayer::VoltageIterator::linear(const Voltages::const_itera
 //----------------------------------------------------------------------------
 float simil::VoltagesPlayer::VoltageIterator::linearInterpolation(const float value) const
 {
-  if ((*m_it1).first >= value)
+  if (timeOf(m_it1) >= value)
     return linear(m_it0, m_it1, value);
 
-  if ((*m_it2).first >= value)
+  if (timeOf(m_it2) >= value)
     return linear(m_it1, m_it2, value);
 
   return linear(m_it2, m_it3, value);
@@ -418,18 +423,18 @@ float simil::VoltagesPlayer::VoltageIterator::catmullRom(const float value)
 #endif
 
   // try to ensure the middle interval. [m_it1, m_it2];
-  if (!isAtBegin() && value < (*m_it1).first)
+  if (!isAtBegin() && value < timeOf(m_it1))
     operator--();
 
-  if(!isAtEnd() && value > (*m_it2).first)
+  if(!isAtEnd() && value > timeOf(m_it2))
     operator++();
 
-  glm::vec2 p0 = {(*m_it0).first, (*m_it0).second};
-  glm::vec2 p1 = {(*m_it1).first, (*m_it1).second};
-  glm::vec2 p2 = {(*m_it2).first, (*m_it2).second};
-  glm::vec2 p3 = {(*m_it3).first, (*m_it3).second};
+  glm::vec2 p0 = {timeOf(m_it0), valueOf(m_it0)};
+  glm::vec2 p1 = {timeOf(m_it1), valueOf(m_it1)};
+  glm::vec2 p2 = {timeOf(m_it2), valueOf(m_it2)};
+  glm::vec2 p3 = {timeOf(m_it3), valueOf(m_it3)};
 
-  float t = (value - (*m_it1).first) / ((*m_it2).first - (*m_it1).first);
+  float t = (value - timeOf(m_it1)) / (timeOf(m_it2) - timeOf(m_it1));
 
   // handle t < 0 at the beginning.
   if(t < 0 && isAtBegin())
@@ -441,7 +446,7 @@ float simil::VoltagesPlayer::VoltageIterator::catmullRom(const float value)
       p3 = p2;
       p2 = p1;
       p1 = p0;
-      p0 = {(*m_it0).first - ((*m_it1).first-(*m_it0).first), (*m_it0).second};
+      p0 = {timeOf(m_it0) - (timeOf(m_it1)-timeOf(m_it0)), valueOf(m_it0)};
     }
 
     t += 1.f;
@@ -465,7 +470,7 @@ float simil::VoltagesPlayer::VoltageIterator::catmullRom(const float value)
       p0 = p1;
       p1 = p2;
       p2 = p3;
-      p3 = {(*m_it3).first + ((*m_it3).first-(*m_it2).first), (*m_it3).second};
+      p3 = {timeOf(m_it3) + (timeOf(m_it3)-timeOf(m_it2)), valueOf(m_it3)};
     }
 
     t -= 1.f;
@@ -25,6 +25,7 @@
 
 // SimIL
 #include <simil/SimulationPlayer.h>
+#include <simil/VoltageMatrix.h>
 
 // C++
 #include <iterator>
@@ -127,10 +128,11 @@ namespace simil
       {
         public:
           /** \brief VoltageIterator class constructor. 
-           * \param[in] data Voltages data to iterate. 
+           * \param[in] matrix Voltages data to iterate. 
+           * \param[in] column Column of the group in the matrix.
            * 
           */
-          VoltageIterator(const simil::Voltages &data);
+          VoltageIterator(const simil::VoltageMatrix &matrix, const unsigned int column);
 
           /** \brief VoltageIterator class destructor. 
            * 
@@ -210,18 +212,25 @@ namespace simil
           };
 
           /** Helper methods to compute interpolation values */
-          float linear(const Voltages::const_iterator &A, const Voltages::const_iterator &B, const float value) const;
+          float linear(const size_t A, const size_t B, const float value) const;
           float linearInterpolation(const float value) const;
           float catmullRom(const float value);
           void computeCacheData(const glm::vec2 &p0, const glm::vec2 &p1, const glm::vec2 &p2, const glm::vec2 &p3);
 
-          Voltages::const_iterator m_it0;   /** begin iterator for current interval. */
-          Voltages::const_iterator m_it1;   /** middle 1 iterator for current interval. */
-          Voltages::const_iterator m_it2;   /** middle 2 iterator for current interval. */
-          Voltages::const_iterator m_it3;   /** end iterator for current interval . */
-          Cache                    m_cache; /** catmull-rom curves cache. */
-          InterpolationType        m_type;  /** value interpolation type. */
-          const simil::Voltages   &m_data;  /** data to iterate. */
+          /** \brief Returns the time and the value of a row of the group. */
+          float timeOf(const size_t row) const
+          { return m_data.time(row); }
+          float valueOf(const size_t row) const
+          { return m_data.value(row, m_column); }
+
+          size_t                    m_it0;    /** begin row for current interval. */
+          size_t                    m_it1;    /** middle 1 row for current interval. */
+          size_t                    m_it2;    /** middle 2 row for current interval. */
+          size_t                    m_it3;    /** end row for current interval . */
+          Cache                     m_cache;  /** catmull-rom curves cache. */
+          InterpolationType         m_type;   /** value interpolation type. */
+          const simil::VoltageMatrix &m_data; /** data to iterate. */
+          const unsigned int        m_column; /** column of the group in the data. */
 #ifdef TEST
           unsigned long m_requests; /** number of interpolation requests, not linear. */
           unsigned long m_failed;   /** number if requests that needed cache computation. */
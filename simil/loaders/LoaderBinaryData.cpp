@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "LoaderBinaryData.h"
+
+namespace simil
+{
+  LoaderBinaryData::LoaderBinaryData( )
+    : LoaderSimData( )
+  { }
+
+  LoaderBinaryData::~LoaderBinaryData( )
+  { }
+
+  std::unique_ptr< Network >
+  LoaderBinaryData::loadNetwork( const std::string& containerFile ,
+                                 const std::string& )
+  {
+    auto network = std::unique_ptr< Network >(
+      new Network( containerFile , TBINARY ));
+    network->setDataType( TBINARY );
+
+    return network;
+  }
+
+  std::unique_ptr< SimulationData >
+  LoaderBinaryData::loadSimulationData( const std::string& containerFile ,
+                                        const std::string& )
+  {
+    auto simulationdata = std::unique_ptr< SpikeData >(
+      new SpikeData( containerFile , TBINARY ));
+
+    simulationdata->setSimulationType( TSimSpikes );
+
+    // The mapped spikes are adopted, so only the accepted ones are copied.
+    if ( const auto filter = gidFilter( *simulationdata->subsetsEvents( )))
+    {
+      const auto& mapped = simulationdata->spikes( );
+      Spikes spikes;
+      for ( size_t i = 0; i < mapped.size( ); ++i )
+        if ( filter->contains( mapped.gid( i )))
+          spikes.push_back( mapped.time( i ) , mapped.gid( i ));
+
+      simulationdata->setSpikes( std::move( spikes ));
+    }
+
+    return simulationdata;
+  }
+
+} // namespace simil
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef __SIMIL__LOADBINARYDATA_H__
+#define __SIMIL__LOADBINARYDATA_H__
+
+#include "LoaderSimData.h"
+#include <simil/api.h>
+
+namespace simil
+{
+  /** \class LoaderBinaryData
+   * \brief Loads the network and the spikes of a native SimIL container.
+   *
+   */
+  class SIMIL_API LoaderBinaryData : public LoaderSimData
+  {
+  public:
+    LoaderBinaryData( );
+    virtual ~LoaderBinaryData( );
+
+    virtual std::unique_ptr< SimulationData >
+      loadSimulationData( const std::string& containerFile,
+                          const std::string& aux = "" ) override;
+
+    virtual std::unique_ptr< Network >
+    loadNetwork( const std::string& containerFile,
+                 const std::string& aux = "" ) override;
+  };
+
+} // namespace simil
+
+#endif /* __SIMIL__LOADBINARYDATA_H__ */
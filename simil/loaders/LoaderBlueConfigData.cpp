@@ -52,12 +52,13 @@ namespace simil
 
     brain::Circuit* circuit = new brain::Circuit( *_blueConfig );
 
-    if ( !aux.empty( ))
-      _network->setGids( brion::Target::parse( targets , aux ));
-    else
-      _network->setGids( circuit->getGIDs( ));
+    const TGIDSet gids = !aux.empty( ) ?
+      TGIDSet( brion::Target::parse( targets , aux )) :
+      TGIDSet( circuit->getGIDs( ));
 
-    _network->setPositions( circuit->getPositions( _network->gids( )));
+    // Circuit positions come in gid order.
+    _network->setNeurons( GIDVec( gids.begin( ) , gids.end( )) ,
+                          circuit->getPositions( gids.toSet( )));
 
     delete circuit;
 
@@ -75,10 +76,36 @@ namespace simil
       _blueConfig = new brion::BlueConfig( filePath_ );
     }
 
-    brain::SpikeReportReader spikeReport( _blueConfig->getSpikeSource( ));
     simulationdata->setSimulationType( TSimSpikes );
-    simulationdata->setSpikes(
-      spikeReport.getSpikes( 0 , spikeReport.getEndTime( )));
+
+    // Subset names are the circuit targets, parsing throws on unknown ones.
+    SubsetEventManager targetSubsets;
+    if ( !_subsetFilter.empty( ))
+    {
+      const brion::Targets targets = _blueConfig->getTargets( );
+      for ( const auto& name : _subsetFilter )
+        targetSubsets.addSubset( name ,
+                                 GIDSet( brion::Target::parse( targets , name )));
+    }
+
+    // The reader only decodes the spikes of the filtered gids. An empty gid
+    // set means all of them to the reader, so an empty filter reads nothing.
+    const auto filter = gidFilter( targetSubsets );
+    if ( filter && filter->empty( ))
+      return simulationdata;
+
+    brion::GIDSet subset;
+    if ( filter )
+    {
+      const auto gids = filter->gids( );
+      subset.insert( gids.begin( ) , gids.end( ));
+    }
+
+    brain::SpikeReportReader spikeReport( _blueConfig->getSpikeSource( ) ,
+                                          subset );
+    TSpikes spikes = spikeReport.getSpikes( 0 , spikeReport.getEndTime( ));
+
+    simulationdata->setSpikes( spikes );
     simulationdata->setStartTime( 0.0f );
     simulationdata->setEndTime( spikeReport.getEndTime( ));
 
@@ -22,6 +22,8 @@
 
 #include "LoaderCSVData.h"
 
+#include <iostream>
+#include <stdexcept>
 
 namespace simil
 {
@@ -51,9 +53,8 @@ namespace simil
     }
     _network->setDataType( TCSV );
 
-    _network->setGids( _csvNetwork->getGIDs( ));
-
-    _network->setPositions( _csvNetwork->getComposedPositions( ));
+    _network->setNeurons( _csvNetwork->getGIDVec( ),
+                          _csvNetwork->getComposedPositions( ));
 
     return _network;
   }
@@ -66,7 +67,20 @@ namespace simil
 
     if ( _csvActivity == nullptr )
     {
-      _csvActivity = new CSVSpikes( *_csvNetwork , activityFile );
+      // CSV networks define no subsets to resolve subset filters against.
+      if ( !_subsetFilter.empty( ))
+      {
+        const std::string errorText =
+          "LoaderCSVData: subset filters are not supported by CSV networks.";
+        std::cerr << "EXCEPTION: " << errorText << " -> " << __FILE__ << ":"
+                  << __LINE__ << std::endl;
+
+        throw std::runtime_error( errorText );
+      }
+
+      auto csvSpikes = new CSVSpikes( *_csvNetwork , activityFile );
+      csvSpikes->setGIDFilter( _gidFilter );
+      _csvActivity = csvSpikes;
       _csvActivity->load( );
     }
 
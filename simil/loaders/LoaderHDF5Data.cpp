@@ -22,6 +22,8 @@
 
 #include "LoaderHDF5Data.h"
 
+#include <limits>
+
 namespace simil
 {
   LoaderHDF5Data::LoaderHDF5Data( )
@@ -47,9 +49,8 @@ namespace simil
     }
     _network->setDataType( THDF5 );
 
-    _network->setGids( _h5Network->getGIDs( ));
-
-    _network->setPositions( _h5Network->getComposedPositions( ));
+    const TPosVect positions = _h5Network->getComposedPositions( );
+    _network->setNeurons( _h5Network->getGIDVec( ), positions );
 
     SubsetEventManager subsetEventManager;
     const auto subsetIts = _h5Network->getSubsets( );
@@ -68,6 +69,16 @@ namespace simil
   std::unique_ptr< SimulationData >
   LoaderHDF5Data::loadSimulationData( const std::string& networkFile ,
                                       const std::string& activityFile )
+  {
+    return loadSimulationData( networkFile , activityFile ,
+                               std::numeric_limits< float >::lowest( ) ,
+                               std::numeric_limits< float >::max( ));
+  }
+
+  std::unique_ptr< SimulationData >
+  LoaderHDF5Data::loadSimulationData( const std::string& networkFile ,
+                                      const std::string& activityFile ,
+                                      float startTime , float endTime )
   {
     auto simulationdata = std::unique_ptr< SpikeData >( new SpikeData( ));
 
@@ -80,9 +91,6 @@ namespace simil
     simulationdata->setGids( _h5Network->getGIDs( ));
     simulationdata->setPositions( _h5Network->getComposedPositions( ));
 
-    simil::H5Spikes spikeReport( *_h5Network , activityFile );
-    spikeReport.Load( );
-
     SubsetEventManager subsetEventManager;
     const auto subsetIts = _h5Network->getSubsets( );
     const auto& subsetColors = _h5Network->getSubsetsColors( );
@@ -92,6 +100,10 @@ namespace simil
       subsetEventManager.addSubset( it->first , it->second ,
                                     subsetColors.at( it->first ));
 
+    simil::H5Spikes spikeReport( *_h5Network , activityFile );
+    spikeReport.setGIDFilter( gidFilter( subsetEventManager ));
+    spikeReport.Load( startTime , endTime );
+
     simulationdata->setSubset( subsetEventManager );
 
     /*simil::StorageSparse* newStorage =
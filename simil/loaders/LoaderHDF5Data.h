@@ -39,6 +39,20 @@ namespace simil
       loadSimulationData( const std::string& networkFile,
                           const std::string& activityFile="" ) override;
 
+    /** \brief Loads the network and the spikes of the activity file in the
+     * [startTime, endTime] window. Only the rows of the window are read from
+     * each spike dataset, so time and memory depend on the window size.
+     * \param[in] networkFile Network file name.
+     * \param[in] activityFile Activity file name.
+     * \param[in] startTime Window start time.
+     * \param[in] endTime Window end time.
+     *
+     */
+    std::unique_ptr< SimulationData >
+      loadSimulationData( const std::string& networkFile,
+                          const std::string& activityFile,
+                          float startTime, float endTime );
+
     virtual std::unique_ptr< Network >
     loadNetwork( const std::string& networkFile,
                                   const std::string& aux = "" ) override;
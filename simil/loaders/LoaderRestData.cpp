@@ -28,6 +28,7 @@
 // C++
 #include <iostream>
 #include <memory>
+#include <stdexcept>
 
 // JsonCpp
 #include "jsoncpp/json/json.h"
@@ -68,6 +69,18 @@ namespace simil
     m_config.url = serverUrl;
     m_config.port = serverPort;
 
+    // Subset names are resolved once, with the subsets known at this point.
+    const auto network = m_config.network.lock( );
+    if ( !network && !_subsetFilter.empty( ))
+    {
+      const std::string errorText =
+        "REST: subset filters need a network to resolve the subsets.";
+      std::cerr << "EXCEPTION: " << errorText << " -> " << __FILE__ << ":"
+                << __LINE__ << std::endl;
+      throw std::runtime_error( errorText );
+    }
+    m_filter = network ? gidFilter( *network->subsetsEvents( )) : _gidFilter;
+
     auto data = new SpikeData( );
     loopSpikes( data , serverUrl , restAPIPrefix( ) , serverPort );
 
@@ -142,6 +155,9 @@ namespace simil
         continue;
       }
 
+      if ( m_filter && !m_filter->contains( static_cast<uint32_t>(nodeId)))
+        continue;
+
       auto time = times[ idx ].asFloat( );
       startTime = std::min( time , startTime );
       endTime = std::max( time , endTime );
@@ -220,7 +236,7 @@ namespace simil
         }
         const auto groupId32 = static_cast<uint32_t>(groupId);
 
-        populationMap[ std::to_string( groupId32 ) ].push_back( gid32 );
+        populationMap[ std::to_string( groupId32 ) ].insert( gid32 );
 
         const auto position = props[ "position" ];
 
@@ -256,7 +272,7 @@ namespace simil
     if ( !populationMap.empty( ))
     {
       auto addSubset = [ network ](
-        const std::pair< std::string , GIDVec >& item )
+        const SubsetMap::value_type& item )
       {
         network->subsetsEvents( )->addSubset(
           std::string( "Subset " ) + item.first , item.second );
@@ -182,6 +182,7 @@ namespace simil
     std::atomic< bool > _forceStop;
     std::atomic< unsigned int > _spikesRead;
     Configuration m_config;
+    std::shared_ptr< const GIDFilter > m_filter;
   };
 
 } // namespace simil
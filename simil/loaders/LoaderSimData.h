@@ -24,8 +24,11 @@
 #define __SIMIL__LOADSIMDATA_H__
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "../DataSet.h"
+#include "../GIDFilter.h"
 #include <simil/api.h>
 
 namespace simil
@@ -45,6 +48,46 @@ namespace simil
     virtual std::unique_ptr< Network >
     loadNetwork( const std::string& filePath_ ,
                  const std::string& aux = "" ) = 0;
+
+    /** \brief Restricts the activity read by loadSimulationData to the
+     * gids of the filter. Other spikes are dropped as they are read.
+     * \param[in] filter Gids to load, nullptr to load all of them.
+     *
+     */
+    void setGIDFilter( std::shared_ptr< const GIDFilter > filter )
+    {
+      _gidFilter = std::move( filter );
+      _subsetFilter.clear( );
+    }
+
+    /** \brief Restricts the activity read by loadSimulationData to the
+     * gids of the given subsets of the network.
+     * \param[in] subsets Subset names, empty to load all the gids.
+     *
+     */
+    void setSubsetFilter( const std::vector< std::string >& subsets )
+    {
+      _subsetFilter = subsets;
+      _gidFilter.reset( );
+    }
+
+  protected:
+    /** \brief Returns the filter to apply to the activity, with subset
+     * names resolved in the given manager, or nullptr to load everything.
+     * \param[in] subsets Subsets of the loaded network.
+     *
+     */
+    std::shared_ptr< const GIDFilter >
+    gidFilter( const SubsetEventManager& subsets ) const
+    {
+      if( _subsetFilter.empty( ))
+        return _gidFilter;
+
+      return std::make_shared< GIDFilter >( subsets, _subsetFilter );
+    }
+
+    std::shared_ptr< const GIDFilter > _gidFilter;
+    std::vector< std::string > _subsetFilter;
   };
 
   inline LoaderSimData::~LoaderSimData( )
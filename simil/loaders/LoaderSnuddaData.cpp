@@ -21,6 +21,7 @@
  */
 
 #include "LoaderSnuddaData.h"
+#include "../SpikeSort.h"
 
 #include <unordered_map>
 #include <vector>
@@ -215,6 +216,8 @@ namespace simil
 
         simil::TSpikes* spikes = new simil::TSpikes();
         simil::GIDVec neuronTypes[2]; // 0 virtual, 1 real.
+        const auto filter = gidFilter(_subsetEventManager);
+        const auto rejected = [&filter](uint32_t gid) { return filter && !filter->contains(gid); };
 
         // input spikes
         if (!simFile1.empty()) {
@@ -232,8 +235,11 @@ namespace simil
             inputGroup.close();
 
             for (auto& neuronId : neuronIds) {
+                const uint32_t gid = std::stoi(neuronId);
                 if (HDF5pathExists(dsId, "input/" + neuronId + "/activity")) {
-                    neuronTypes[0].emplace_back(atoi(neuronId.c_str()));
+                    neuronTypes[0].emplace_back(gid);
+                    if (rejected(gid)) continue;
+
                     auto spikesDs = inputSimFile.openDataSet("input/" + neuronId + "/activity/spikes");
                     hsize_t dims;
                     spikesDs.getSpace().getSimpleExtentDims(&dims);
@@ -244,11 +250,13 @@ namespace simil
                     for (hsize_t i = 0; i < times.size(); ++i) {
                         startTime = std::min(startTime, times[i]);
                         endTime = std::max(endTime, times[i]);
-                        spikes->emplace_back(times[i], std::stoi(neuronId));
+                        spikes->emplace_back(times[i], gid);
                     }
                     spikesDs.close();
                 } else {
-                    neuronTypes[1].emplace_back(atoi(neuronId.c_str()));
+                    neuronTypes[1].emplace_back(gid);
+                    if (rejected(gid)) continue;
+
                     for (auto subGroup :
                          {"input/" + neuronId + "/cortical/spikes", "input/" + neuronId + "/cortical_background/spikes",
                           "input/" + neuronId + "/thalamic_background/spikes"}) {
@@ -266,7 +274,7 @@ namespace simil
                             }
                             startTime = std::min(startTime, static_cast<double>(times[i]));
                             endTime = std::max(endTime, static_cast<double>(times[i]));
-                            spikes->emplace_back(times[i], std::stoi(neuronId));
+                            spikes->emplace_back(times[i], gid);
                         }
                         spikesDs.close();
                     }
@@ -295,6 +303,8 @@ namespace simil
             const int numNeurons = dims;
 
             for (int idx = 0; idx < numNeurons; ++idx) {
+                if (rejected(idx)) continue;
+
                 const std::string name = "neurons/" + std::to_string(idx);
                 if (HDF5pathExists(outputSimFile.getId(), name)) {
                     hsize_t sDims[2];
@@ -315,10 +325,7 @@ namespace simil
             outputSimFile.close();
         }
 
-        auto sortSpike = [](const simil::TSpikes::value_type& a, const simil::TSpikes::value_type& b) {
-            return a.first < b.first;
-        };
-        std::sort(spikes->begin(), spikes->end(), sortSpike);
+        simil::sortSpikes(*spikes);
 
         simData->setStartTime(startTime);
         simData->setEndTime(endTime);
@@ -332,18 +339,18 @@ namespace simil
     {
         _networkFilename = networkFile;
 
-        simil::TGIDSet ids;
+        simil::GIDVec ids;
         simil::TPosVect pos;
 
         for (auto value : loadNeurons()) {
-            ids.emplace(value.first);
+            ids.push_back(value.first);
             pos.push_back(value.second);
         }
 
         if (_loadSynapses) {
             const auto neuronsSize = ids.size();
             for (auto value : loadSynapses()) {
-                ids.emplace(neuronsSize + value.first);
+                ids.push_back(neuronsSize + value.first);
                 pos.push_back(value.second);
             }
         }
@@ -352,8 +359,7 @@ namespace simil
 
         auto network = std::make_unique<simil::Network>();
         network->setDataType(simil::TDataType::TSNUDDA);
-        network->setGids(ids);
-        network->setPositions(pos);
+        network->setNeurons(ids, pos);
         network->setSubset(_subsetEventManager);
 
         return network;
@@ -0,0 +1,375 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "BinaryContainer.h"
+#include "MappedFile.h"
+#include "../../SpikeData.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace
+{
+  const char MAGIC[ 8 ] = { 'S', 'I', 'M', 'I', 'L', 'B', 'I', 'N' };
+  const uint32_t VERSION = 1;
+  const uint32_t BYTE_ORDER_MARK = 0x01020304;
+  const uint64_t SECTION_ALIGNMENT = 4096;
+
+  /** Fixed size file header, followed by the sections. */
+  struct FileHeader
+  {
+    char magic[ 8 ];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t spikeCount;
+    float startTime;
+    float endTime;
+    uint32_t chunkSize;
+    uint32_t fenceStride;
+    uint64_t gidCount;
+    uint64_t positionCount;
+    uint64_t subsetCount;
+    uint64_t timesOffset;
+    uint64_t gidsOffset;
+    uint64_t fencesOffset;
+    uint64_t networkOffset;
+    uint64_t positionsOffset;
+    uint64_t subsetsOffset;
+    uint64_t fileSize;
+  };
+
+  uint64_t aligned( uint64_t offset )
+  {
+    return ( offset + SECTION_ALIGNMENT - 1 ) / SECTION_ALIGNMENT *
+      SECTION_ALIGNMENT;
+  }
+
+  void pad( std::ostream& stream, uint64_t offset )
+  {
+    const uint64_t position = static_cast< uint64_t >( stream.tellp( ));
+    for( uint64_t i = position; i < offset; ++i )
+      stream.put( 0 );
+  }
+
+  template< typename T >
+  void writeValue( std::ostream& stream, const T& value )
+  {
+    stream.write( reinterpret_cast< const char* >( &value ), sizeof( T ));
+  }
+
+  template< typename T >
+  T readValue( const uint8_t*& data )
+  {
+    T value;
+    std::memcpy( &value, data, sizeof( T ));
+    data += sizeof( T );
+    return value;
+  }
+}
+
+namespace simil
+{
+  BinaryContainer::BinaryContainer( const std::string& fileName_ )
+  : _fileName( fileName_ )
+  , _spikeCount( 0 )
+  , _startTime( 0.0f )
+  , _endTime( 0.0f )
+  , _times( nullptr )
+  , _gids( nullptr )
+  , _fences( nullptr )
+  { }
+
+  BinaryContainer::~BinaryContainer( void )
+  { }
+
+  void BinaryContainer::load( void )
+  {
+    _file = std::make_shared< MappedFile >( _fileName );
+
+    FileHeader header;
+    if( _file->size( ) < sizeof( header ))
+      throw std::runtime_error( "Invalid SimIL container " + _fileName );
+    std::memcpy( &header, _file->data( ), sizeof( header ));
+
+    if( std::memcmp( header.magic, MAGIC, sizeof( MAGIC )) != 0 ||
+        header.fileSize != _file->size( ))
+      throw std::runtime_error( "Invalid SimIL container " + _fileName );
+    if( header.byteOrder != BYTE_ORDER_MARK || header.version != VERSION ||
+        header.fenceStride == 0 )
+      throw std::runtime_error( "Unsupported SimIL container " + _fileName );
+
+    _spikeCount = header.spikeCount;
+    _startTime = header.startTime;
+    _endTime = header.endTime;
+
+    const uint64_t fenceCount =
+      ( _spikeCount + header.fenceStride - 1 ) / header.fenceStride;
+    _times = reinterpret_cast< const float* >(
+      section( header.timesOffset, _spikeCount * sizeof( float )));
+    _gids = reinterpret_cast< const uint32_t* >(
+      section( header.gidsOffset, _spikeCount * sizeof( uint32_t )));
+    _fences = reinterpret_cast< const float* >(
+      section( header.fencesOffset, fenceCount * sizeof( float )));
+
+    // Containers written with another chunk layout are loaded by copy.
+    if( header.chunkSize != SpikeColumns::CHUNK_SIZE ||
+        header.fenceStride != SpikeColumns::FENCE_STRIDE )
+      _fences = nullptr;
+  }
+
+  const uint8_t* BinaryContainer::section( uint64_t offset,
+                                           uint64_t bytes ) const
+  {
+    if( offset > _file->size( ) || bytes > _file->size( ) - offset )
+      throw std::runtime_error( "Truncated SimIL container " + _fileName );
+
+    return _file->data( ) + offset;
+  }
+
+  Spikes BinaryContainer::spikes( void ) const
+  {
+    Spikes result;
+    if( !_file )
+      return result;
+
+    if( _fences )
+    {
+      result.adopt( _times, _gids, _fences, _spikeCount, _file );
+      return result;
+    }
+
+    result.reserve( _spikeCount );
+    for( uint64_t i = 0; i < _spikeCount; ++i )
+      result.push_back( _times[ i ], _gids[ i ]);
+    return result;
+  }
+
+  TGIDSet BinaryContainer::gids( void ) const
+  {
+    TGIDSet result;
+    if( !_file )
+      return result;
+
+    FileHeader header;
+    std::memcpy( &header, _file->data( ), sizeof( header ));
+    const uint32_t* gids_ = reinterpret_cast< const uint32_t* >(
+      section( header.networkOffset, header.gidCount * sizeof( uint32_t )));
+
+    result.insert( gids_, gids_ + header.gidCount );
+    return result;
+  }
+
+  TPosVect BinaryContainer::positions( void ) const
+  {
+    TPosVect result;
+    if( !_file )
+      return result;
+
+    FileHeader header;
+    std::memcpy( &header, _file->data( ), sizeof( header ));
+    const float* coordinates = reinterpret_cast< const float* >(
+      section( header.positionsOffset,
+               header.positionCount * 3 * sizeof( float )));
+
+    result.reserve( header.positionCount );
+    for( uint64_t i = 0; i < header.positionCount; ++i )
+      result.emplace_back( coordinates[ 3 * i ], coordinates[ 3 * i + 1 ],
+                           coordinates[ 3 * i + 2 ]);
+    return result;
+  }
+
+  SubsetEventManager BinaryContainer::subsets( void ) const
+  {
+    SubsetEventManager result;
+    if( !_file )
+      return result;
+
+    FileHeader header;
+    std::memcpy( &header, _file->data( ), sizeof( header ));
+    const uint8_t* data = section( header.subsetsOffset, 0 );
+    const uint8_t* end = _file->data( ) + _file->size( );
+
+    // Each subset: name length, name, color and gid count, then the gids.
+    for( uint64_t s = 0; s < header.subsetCount; ++s )
+    {
+      if( static_cast< size_t >( end - data ) < sizeof( uint32_t ))
+        throw std::runtime_error( "Truncated SimIL container " + _fileName );
+      const uint32_t nameLength = readValue< uint32_t >( data );
+
+      const size_t fixed = nameLength + 3 * sizeof( float ) + sizeof( uint32_t );
+      if( static_cast< size_t >( end - data ) < fixed )
+        throw std::runtime_error( "Truncated SimIL container " + _fileName );
+
+      const std::string name( reinterpret_cast< const char* >( data ),
+                              nameLength );
+      data += nameLength;
+
+      vmml::Vector3f color;
+      for( unsigned int c = 0; c < 3; ++c )
+        color[ c ] = readValue< float >( data );
+
+      const uint32_t gidCount = readValue< uint32_t >( data );
+      if( static_cast< size_t >( end - data ) < gidCount * sizeof( uint32_t ))
+        throw std::runtime_error( "Truncated SimIL container " + _fileName );
+
+      GIDVec gids_( gidCount );
+      std::memcpy( gids_.data( ), data, gidCount * sizeof( uint32_t ));
+      data += gidCount * sizeof( uint32_t );
+
+      result.addSubset( name, gids_, color );
+    }
+
+    return result;
+  }
+
+  float BinaryContainer::startTime( void ) const
+  {
+    return _startTime;
+  }
+
+  float BinaryContainer::endTime( void ) const
+  {
+    return _endTime;
+  }
+
+  std::string BinaryContainer::fileName( void ) const
+  {
+    return _fileName;
+  }
+
+  bool BinaryContainer::save( const std::string& fileName_,
+                              const SimulationData& data )
+  {
+    std::ofstream stream( fileName_, std::ios::out | std::ios::binary |
+                                     std::ios::trunc );
+    if( !stream.is_open( ))
+    {
+      std::cerr << "Unable to create SimIL container " << fileName_
+                << std::endl;
+      return false;
+    }
+
+    const SpikeData* spikeData = dynamic_cast< const SpikeData* >( &data );
+    const Spikes emptySpikes;
+    const Spikes& spikes_ = spikeData ? spikeData->spikes( ) : emptySpikes;
+    const Spikes::ReadGuard guard( spikes_ );
+    const size_t count = spikes_.size( );
+
+    const auto& gids_ = data.gids( );
+    const auto& positions_ = data.positions( );
+    const auto* subsets_ = data.subsetsEvents( );
+    const auto subsetNames = subsets_->subsetNames( );
+
+    FileHeader header;
+    std::memcpy( header.magic, MAGIC, sizeof( MAGIC ));
+    header.version = VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.spikeCount = count;
+    header.startTime = data.startTime( );
+    header.endTime = data.endTime( );
+    header.chunkSize = SpikeColumns::CHUNK_SIZE;
+    header.fenceStride = SpikeColumns::FENCE_STRIDE;
+    header.gidCount = gids_.size( );
+    header.positionCount = positions_.size( );
+    header.subsetCount = subsetNames.size( );
+
+    const uint64_t fenceCount =
+      ( count + SpikeColumns::FENCE_STRIDE - 1 ) / SpikeColumns::FENCE_STRIDE;
+    header.timesOffset = aligned( sizeof( header ));
+    header.gidsOffset = aligned( header.timesOffset + count * sizeof( float ));
+    header.fencesOffset =
+      aligned( header.gidsOffset + count * sizeof( uint32_t ));
+    header.networkOffset =
+      aligned( header.fencesOffset + fenceCount * sizeof( float ));
+    header.positionsOffset =
+      aligned( header.networkOffset + header.gidCount * sizeof( uint32_t ));
+    header.subsetsOffset = aligned( header.positionsOffset +
+      header.positionCount * 3 * sizeof( float ));
+    header.fileSize = 0;
+
+    writeValue( stream, header );
+
+    pad( stream, header.timesOffset );
+    for( size_t position = 0; position < count; )
+    {
+      const auto run = spikes_.run( position, count );
+      stream.write( reinterpret_cast< const char* >( run.times ),
+                    run.size * sizeof( float ));
+      position += run.size;
+    }
+
+    pad( stream, header.gidsOffset );
+    for( size_t position = 0; position < count; )
+    {
+      const auto run = spikes_.run( position, count );
+      stream.write( reinterpret_cast< const char* >( run.gids ),
+                    run.size * sizeof( uint32_t ));
+      position += run.size;
+    }
+
+    pad( stream, header.fencesOffset );
+    for( size_t i = 0; i < count; i += SpikeColumns::FENCE_STRIDE )
+      writeValue( stream, spikes_.time( i ));
+
+    pad( stream, header.networkOffset );
+    for( const auto gid : gids_ )
+      writeValue( stream, gid );
+
+    pad( stream, header.positionsOffset );
+    for( const auto& position : positions_ )
+      for( unsigned int c = 0; c < 3; ++c )
+        writeValue( stream, position[ c ]);
+
+    pad( stream, header.subsetsOffset );
+    for( const auto& name : subsetNames )
+    {
+      const auto subset = subsets_->getSubset( name );
+      const auto color = subsets_->getSubsetColor( name );
+
+      writeValue( stream, static_cast< uint32_t >( name.size( )));
+      stream.write( name.data( ), name.size( ));
+      for( unsigned int c = 0; c < 3; ++c )
+        writeValue( stream, color[ c ]);
+      writeValue( stream, static_cast< uint32_t >( subset.size( )));
+      stream.write( reinterpret_cast< const char* >( subset.data( )),
+                    subset.size( ) * sizeof( uint32_t ));
+    }
+
+    // The size is written last so that truncated files are rejected.
+    header.fileSize = static_cast< uint64_t >( stream.tellp( ));
+    stream.seekp( 0 );
+    writeValue( stream, header );
+    stream.close( );
+
+    if( !stream )
+    {
+      std::cerr << "Unable to write SimIL container " << fileName_
+                << std::endl;
+      return false;
+    }
+
+    return true;
+  }
+
+} // namespace simil
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef __SIMIL__BINARYCONTAINER_H__
+#define __SIMIL__BINARYCONTAINER_H__
+
+#include "../../types.h"
+#include "../../Spikes.hpp"
+#include "../../SubsetEventManager.h"
+#include <simil/api.h>
+
+#include <memory>
+#include <string>
+
+namespace simil
+{
+  class SimulationData;
+  class MappedFile;
+
+  /** \class BinaryContainer
+   * \brief Native SimIL file holding a spike report and its network.
+   *
+   * The file starts with a fixed header followed by page aligned sections:
+   * the time column, the gid column, the time index (the time of every
+   * FENCE_STRIDE-th spike), the network gids and positions and the subset
+   * table. The file is memory mapped and the spikes returned by spikes()
+   * point straight into the mapping, so opening a report costs only the
+   * page faults of the data actually read. Files are written in the byte
+   * order of the host and rejected on hosts of the other one.
+   *
+   */
+  class SIMIL_API BinaryContainer
+  {
+  public:
+
+    /** \brief BinaryContainer class constructor.
+     * \param[in] fileName Container file name.
+     *
+     */
+    BinaryContainer( const std::string& fileName );
+
+    virtual ~BinaryContainer( void );
+
+    /** \brief Maps the file and validates its header. Throws
+     * std::runtime_error if the file cannot be mapped or is not a valid
+     * container.
+     *
+     */
+    void load( void );
+
+    /** \brief Returns the spikes, referencing the mapped columns.
+     *
+     */
+    Spikes spikes( void ) const;
+
+    TGIDSet gids( void ) const;
+    TPosVect positions( void ) const;
+    SubsetEventManager subsets( void ) const;
+
+    float startTime( void ) const;
+    float endTime( void ) const;
+
+    std::string fileName( void ) const;
+
+    /** \brief Writes the spikes, gids, positions and subsets of the given
+     * simulation data in a container. Returns false on failure.
+     * \param[in] fileName Container file name.
+     * \param[in] data Simulation data, spikes are written if it is a
+     * SpikeData instance.
+     *
+     */
+    static bool save( const std::string& fileName,
+                      const SimulationData& data );
+
+  protected:
+
+    /** \brief Returns a pointer to the given section, throwing if it does
+     * not fit in the file.
+     *
+     */
+    const uint8_t* section( uint64_t offset, uint64_t bytes ) const;
+
+    std::string _fileName;
+    std::shared_ptr< MappedFile > _file;
+
+    uint64_t _spikeCount;
+    float _startTime;
+    float _endTime;
+
+    const float* _times;
+    const uint32_t* _gids;
+    const float* _fences;
+  };
+
+} // namespace simil
+
+#endif /* __SIMIL__BINARYCONTAINER_H__ */
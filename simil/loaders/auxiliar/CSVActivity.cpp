@@ -22,26 +22,25 @@
 
 
 #include "CSVActivity.h"
+#include "CSVParser.h"
+#include "../../Parallel.h"
+#include "../../SpikeMerge.h"
 
-#include <sys/stat.h>
-#include <cassert>
-#include <locale>
+#include <algorithm>
+#include <cmath>
 #include <fstream>
+#include <iostream>
 #include <limits>
-#include <map>
+#include <locale>
+#include <stdexcept>
 #include <tuple>
 #include <utility> // std::swap
 
-#include <QFile>
-#include <QStringList>
-
 struct dotSeparator: std::numpunct<char>
 {
     char do_decimal_point() const { return '.'; }
 };
 
-const std::vector<char> SEPARATORS{ ',',';','\t',' ' };
-
 namespace simil
 {
   CSVActivity::CSVActivity( const CSVNetwork& network,
@@ -78,103 +77,130 @@ namespace simil
 
   void CSVSpikes::load( void )
   {
-    QFile file( QString( _fileName.data( )));
-    if( !file.open( QIODevice::ReadOnly | QFile::Text))
-    {
-      const std::string errorMessage = std::string("Error, could not open CSV activity/spikes file: ") + _fileName;
-      throw std::runtime_error(errorMessage);
-    }
-
+    const auto file = csv::mapFile( _fileName, "activity/spikes" );
     clear();
 
+    const csv::Text text = csv::fileText( *file );
     unsigned int gidPos = 0;
     unsigned int timePos = 1;
-    bool ok = false;
 
     // Tests for correct separator and fields position, use second line in
     // case file has a header line.
-    QByteArray line = file.readLine( );
-    line = file.readLine();
-    QList< QByteArray > wordList = line.split( _separator );
-    if(wordList.size() != 2)
-    {
-      for(auto candidate: SEPARATORS )
-      {
-        wordList = line.split( candidate );
-        if( wordList.size( ) != 2 )
-          continue;
+    const char* position = text.begin;
+    const csv::Text first = csv::nextLine( position, text.end );
+    const csv::Text sample =
+      position < text.end ? csv::nextLine( position, text.end ) : first;
+    _separator = csv::detectSeparator( sample, _separator, 2, 2 );
 
-        _separator = candidate;
-        break;
-      }
-    }
+    std::vector< csv::Text > fields;
+    unsigned int gid = 0;
+    float time = 0.f;
 
     // Check order, that's why we need the second line.
-    if(wordList.size() == 2)
+    if( csv::splitFields( sample, _separator, fields ) == 2 &&
+        !csv::parseUnsigned( fields[ gidPos ], gid ))
+      std::swap( gidPos, timePos );
+
+    // A first line that doesn't convert is the header.
+    csv::Text body = text;
+    size_t firstLine = 0;
+    if( csv::splitFields( first, _separator, fields ) == 2 &&
+        !( csv::parseUnsigned( fields[ gidPos ], gid ) &&
+           csv::parseFloat( fields[ timePos ], time )))
     {
-      wordList[gidPos].toInt(&ok);
-      if(!ok)
-        std::swap(gidPos, timePos);
+      csv::nextLine( body.begin, text.end );
+      firstLine = 1;
     }
-    assert(file.seek(0));
-
-    unsigned int counter = 0;
-    while( !file.atEnd( ))
-    {
-      QStringList stringLine;
-      line = file.readLine( );
-      wordList = line.split(_separator);
-      wordList.removeAll("");
-
-      if(wordList.size() != 2)
-      {
-        const std::string errorText = std::string("CSV error in line: ") + std::to_string(counter) +
-                                      std::string(". Please check file format and make sure all lines match the following structure for each line:") +
-                                      std::string(" GID, TIME\n") + std::string("Both fields are obligatory.\n") +
-                                      std::string("Separator used: '") + _separator + "'\n";
-        throw std::runtime_error(errorText);
-      }
-
-      for( auto word : wordList )
-        stringLine.append( word.constData( ));
-
-      QString gidString = stringLine[ gidPos ];
-      QString timeString = stringLine[ timePos ];
-
-      bool okGID = false;
-      const unsigned int gidValue = gidString.toInt( &okGID );
-
-      bool okTime = false;
-      const float timeValue = timeString.toFloat( &okTime );
 
-      if( !okGID || !okTime )
+    // Each piece of the file is parsed on its own thread into a run, in
+    // file order, and the runs are sorted and merged at the end.
+    const auto pieces = csv::splitLines(
+      body, parallel::threadCount( body.end - body.begin, csv::MIN_PIECE_BYTES ));
+    std::vector< csv::Piece > parsed( pieces.size( ));
+    std::vector< std::pair< float, float >> ranges( pieces.size( ),
+      std::make_pair( 0.f, 0.f ));
+    std::vector< SpikeRun > runs( pieces.size( ));
+    const char separator = _separator;
+    const GIDFilter* filter = _gidFilter.get( );
+
+    parallel::forRanges( pieces.size( ), pieces.size( ),
+      [ & ]( unsigned int, size_t begin, size_t end )
       {
-        std::cout << std::boolalpha << "Warning: Line " << counter << ". Invalid conversion of '" << gidString.toStdString( )
-                  << "' or '" << timeString.toStdString( ) << "' results: " << okGID << "," << okTime << std::endl;
-        continue;
-      }
-
-      _startTime = std::min(_startTime, timeValue);
-      _endTime = std::max(_endTime, timeValue);
-
-      _spikes.insert( std::make_pair( timeValue, gidValue ));
+        std::vector< csv::Text > words;
+        for( size_t p = begin; p < end; ++p )
+        {
+          auto& piece = parsed[ p ];
+          auto& run = runs[ p ];
+          const char* current = pieces[ p ].begin;
+
+          for( ; current < pieces[ p ].end; ++piece.lines )
+          {
+            const csv::Text line = csv::nextLine( current, pieces[ p ].end );
+            const size_t count = csv::splitFields( line, separator, words );
+            if( count == 0 )
+              continue;
+
+            if( count != 2 )
+            {
+              piece.errorLine = piece.lines;
+              break;
+            }
+
+            unsigned int gidValue = 0;
+            float timeValue = 0.f;
+            const bool okGID = csv::parseUnsigned( words[ gidPos ], gidValue );
+            const bool okTime = csv::parseFloat( words[ timePos ], timeValue );
+
+            if( !okGID || !okTime )
+            {
+              piece.warnings.emplace_back( piece.lines,
+                "Invalid conversion of '" + csv::toString( words[ gidPos ]) +
+                "' or '" + csv::toString( words[ timePos ]) + "' results: " +
+                ( okGID ? "true," : "false," ) + ( okTime ? "true" : "false" ));
+              continue;
+            }
+
+            if( filter && !filter->contains( gidValue ))
+              continue;
+
+            auto& range = ranges[ p ];
+            range.first = std::min( range.first, timeValue );
+            range.second = std::max( range.second, timeValue );
+
+            run.times.push_back( timeValue );
+            run.gids.push_back( gidValue );
+          }
+        }
+      });
+
+    const size_t errorLine = csv::report( parsed, firstLine, std::cout );
+    if( errorLine != csv::NO_LINE )
+    {
+      const std::string errorText = std::string("CSV error in line: ") + std::to_string(errorLine) +
+                                    std::string(". Please check file format and make sure all lines match the following structure for each line:") +
+                                    std::string(" GID, TIME\n") + std::string("Both fields are obligatory.\n") +
+                                    std::string("Separator used: '") + _separator + "'\n";
+      throw std::runtime_error(errorText);
+    }
 
-      counter++;
+    for( const auto& range : ranges )
+    {
+      _startTime = std::min( _startTime, range.first );
+      _endTime = std::max( _endTime, range.second );
     }
 
-    file.close( );
+    _spikes = mergeSpikeRuns( runs );
     std::cout << "CSV Read " << _spikes.size( ) << " spikes. Start time: " << _startTime << " End time: " << _endTime << std::endl;
   }
 
   TSpikes CSVSpikes::spikes() const
   {
-    TSpikes result;
-
-    result.reserve( _spikes.size( ));
-    for( auto spike : _spikes )
-      result.push_back( spike );
+    return _spikes;
+  }
 
-    return result;
+  void CSVSpikes::setGIDFilter(std::shared_ptr<const GIDFilter> filter)
+  {
+    _gidFilter = std::move(filter);
   }
 
   void CSVSpikes::save(const std::string filename)
@@ -217,126 +243,143 @@ namespace simil
 
   void CSVVoltages::load(void)
   {
-    QFile file( QString( _fileName.data( )));
-    if( !file.open( QIODevice::ReadOnly | QFile::Text))
-    {
-      const std::string errorMessage = std::string("Error, could not open CSV activity/voltages file: ") + _fileName;
-      throw std::runtime_error(errorMessage);
-    }
-
+    const auto file = csv::mapFile( _fileName, "activity/voltages" );
     clear();
 
-    // Tests for correct separator
-    QByteArray line = file.readLine( );
-    QList< QByteArray > wordList = line.split( _separator );
-    if(wordList.size() < 2)
-    {
-      for(auto candidate: SEPARATORS )
-      {
-        wordList = line.split( candidate );
-        if( wordList.size( ) < 2 )
-          continue;
-
-        _separator = candidate;
-        break;
-      }
-    }
+    const csv::Text text = csv::fileText( *file );
 
-    if(wordList.size() < 2)
+    // Tests for correct separator
+    const char* position = text.begin;
+    const csv::Text first = csv::nextLine( position, text.end );
+    _separator = csv::detectSeparator( first, _separator, 2,
+                                       std::numeric_limits< size_t >::max( ));
+
+    std::vector< csv::Text > fields;
+    const size_t columns = csv::splitFields( first, _separator, fields );
+    if(columns < 2)
     {
       const std::string errorMessage = std::string("Error, unable to guess separator for activity/voltages file: ") + _fileName;
       throw std::runtime_error(errorMessage);
     }
 
-    bool okHeader = false;
-    wordList[0].toFloat(&okHeader);
-    if(okHeader)
+    float value = 0.f;
+    csv::Text body = text;
+    size_t firstLine = 0;
+    if(csv::parseFloat(fields[0], value))
     {
       // Do not have header names, first line are values.
-      for(int i = 1; i < wordList.size(); ++i)
+      for(size_t i = 1; i < columns; ++i)
       {
         m_groups.emplace_back(std::string("Group ") + std::to_string(i));
       }
     }
     else
     {
-      for(int i = 1; i < wordList.size(); ++i)
+      for(size_t i = 1; i < columns; ++i)
       {
-        auto nameStr = wordList[i].toStdString();
-        nameStr.erase(std::remove(nameStr.begin(), nameStr.end(), '\n'), nameStr.end());
-        m_groups.emplace_back(nameStr);
+        m_groups.emplace_back(csv::toString(fields[i]));
       }
+      body.begin = position;
+      firstLine = 1;
     }
 
-    assert(file.seek(0));
-
-    unsigned int counter = 0;
-    while( !file.atEnd( ))
-    {
-      QStringList stringLine;
-      line = file.readLine( );
-      wordList = line.split(_separator);
-      wordList.removeAll("");
-
-      if(wordList.size() < 2)
+    const auto pieces = csv::splitLines(
+      body, parallel::threadCount( body.end - body.begin, csv::MIN_PIECE_BYTES ));
+    std::vector< csv::Piece > parsed( pieces.size( ));
+    std::vector< std::pair< float, float >> ranges( pieces.size( ),
+      std::make_pair( 0.f, 0.f ));
+    std::vector< std::vector< float >> times( pieces.size( ));
+    std::vector< std::vector< float >> values( pieces.size( ));
+    const size_t groups = m_groups.size( );
+    const char separator = _separator;
+
+    parallel::forRanges( pieces.size( ), pieces.size( ),
+      [ & ]( unsigned int, size_t begin, size_t end )
       {
-        const std::string errorText = std::string("CSV error in line: ") + std::to_string(counter) +
-                                      std::string(". Please check file format and make sure all lines match the following structure for each line:") +
-                                      std::string(" TIME,VOLTAGE0, ... ,VOLTAGEN\n") +
-                                      std::string("Separator used: '") + _separator + "'\n";
-        throw std::runtime_error(errorText);
-      }
-
-      for( auto word : wordList )
-        stringLine.append( word.constData( ));
-
-      QString timeString = stringLine[0];
-
-      bool okTime = false;
-      const float timeValue = timeString.toFloat( &okTime );
-
-      if( !okTime )
-      {
-        std::cout << std::boolalpha << "Warning: Line " << counter << ". Invalid conversion of '" << timeString.toStdString( ) 
-		  << "'" << std::endl;
-        continue;
-      }
-
-      bool okValue = false;
-      std::vector<float> voltages;
-      voltages.reserve(stringLine.size() - 1);
-      for(int i = 1; i < stringLine.size(); ++i)
-      {
-        const float value = stringLine[i].toFloat(&okValue);
-        if(okValue) voltages.push_back(value);
-        else break;
-      }
-
-      if(voltages.size() != static_cast<size_t>(stringLine.size() -1))
-      {
-        std::cout << "Warning: Line " << counter << ". Invalid voltage conversion, values: ";
-        for(int i = 1; i < stringLine.size(); ++i) std::cout << stringLine[i].toStdString() << " ";
-        std::cout << std::endl;
-        continue;
-      }
-
-      _startTime = std::min(_startTime, timeValue);
-      _endTime = std::max(_endTime, timeValue);
+        std::vector< csv::Text > words;
+        std::vector< float > voltages;
+        for( size_t p = begin; p < end; ++p )
+        {
+          auto& piece = parsed[ p ];
+          const char* current = pieces[ p ].begin;
+
+          for( ; current < pieces[ p ].end; ++piece.lines )
+          {
+            const csv::Text line = csv::nextLine( current, pieces[ p ].end );
+            const size_t count = csv::splitFields( line, separator, words );
+            if( count == 0 )
+              continue;
+
+            if( count < 2 )
+            {
+              piece.errorLine = piece.lines;
+              break;
+            }
+
+            float timeValue = 0.f;
+            if( !csv::parseFloat( words[ 0 ], timeValue ))
+            {
+              piece.warnings.emplace_back( piece.lines,
+                "Invalid conversion of '" + csv::toString( words[ 0 ]) + "'" );
+              continue;
+            }
+
+            voltages.clear( );
+            float voltage = 0.f;
+            for( size_t i = 1; i < count && csv::parseFloat( words[ i ], voltage ); ++i )
+              voltages.push_back( voltage );
+
+            if( voltages.size( ) != count - 1 || voltages.size( ) != groups )
+            {
+              std::string message = "Invalid voltage conversion, values: ";
+              for( size_t i = 1; i < count; ++i )
+                message += csv::toString( words[ i ]) + " ";
+              piece.warnings.emplace_back( piece.lines, message );
+              continue;
+            }
+
+            auto& range = ranges[ p ];
+            range.first = std::min( range.first, timeValue );
+            range.second = std::max( range.second, timeValue );
+
+            times[ p ].push_back( timeValue );
+            values[ p ].insert( values[ p ].end( ), voltages.cbegin( ), voltages.cend( ));
+          }
+        }
+      });
+
+    const size_t errorLine = csv::report( parsed, firstLine, std::cout );
+    if( errorLine != csv::NO_LINE )
+    {
+      const std::string errorText = std::string("CSV error in line: ") + std::to_string(errorLine) +
+                                    std::string(". Please check file format and make sure all lines match the following structure for each line:") +
+                                    std::string(" TIME,VOLTAGE0, ... ,VOLTAGEN\n") +
+                                    std::string("Separator used: '") + _separator + "'\n";
+      throw std::runtime_error(errorText);
+    }
 
-      for(auto it = voltages.cbegin(); it != voltages.cend(); ++it)
-      {
-        m_voltages.emplace_back(timeValue, *it, std::distance(voltages.cbegin(),it));
-      }
+    size_t total = 0;
+    for( size_t p = 0; p < pieces.size( ); ++p )
+    {
+      _startTime = std::min( _startTime, ranges[ p ].first );
+      _endTime = std::max( _endTime, ranges[ p ].second );
+      total += times[ p ].size( );
+    }
 
-      counter++;
+    m_matrix.reset( groups );
+    m_matrix.reserve( total );
+    for( size_t p = 0; p < pieces.size( ); ++p )
+    {
+      m_matrix.appendRows( times[ p ], values[ p ]);
+      std::vector< float >( ).swap( times[ p ]);
+      std::vector< float >( ).swap( values[ p ]);
     }
 
-    file.close( );
-    std::cout << "CSV Read " << m_voltages.size( ) << " voltages. " << m_groups.size() << " groups.  Start time: " << _startTime << " End time: " << _endTime << std::endl;
+    std::cout << "CSV Read " << m_matrix.rows( ) * groups << " voltages. " << m_groups.size() << " groups.  Start time: " << _startTime << " End time: " << _endTime << std::endl;
+    const auto step = timeStep(m_matrix.times());
     for(unsigned int i = 0; i < m_groups.size(); ++i)
     {
-      const auto range = groupRange(m_voltages, i);
-      const auto step = groupTimeStep(m_voltages, i);
+      const auto range = m_matrix.range(i);
       std::cout << "Group '" << m_groups[i] << "' range: [" << range.first << ", " << range.second << "] time step: " << step << std::endl;
     }
   }
@@ -362,20 +405,25 @@ namespace simil
 
   float CSVVoltages::groupTimeStep(const TVoltages &voltages, const unsigned int group)
   {
-    float timestep = std::numeric_limits<float>::max();
-
-    TVoltages filtered;
+    std::vector<float> filtered;
     auto insertGroupTuple = [&filtered, group](const std::tuple<float, float, int> &t)
     {
       if(std::get<2>(t) == static_cast<int>(group))
-        filtered.push_back(t);
+        filtered.push_back(std::get<0>(t));
     };
     std::for_each(voltages.cbegin(), voltages.cend(), insertGroupTuple );
 
-    for(unsigned int i = 0; i < filtered.size() - 1; ++i)
+    return timeStep(filtered);
+  }
+
+  float CSVVoltages::timeStep(const std::vector<float> &times)
+  {
+    float timestep = std::numeric_limits<float>::max();
+
+    for(size_t i = 0; i + 1 < times.size(); ++i)
     {
-      const auto timeA = std::get<0>(filtered[i]);
-      const auto timeB = std::get<0>(filtered[i+1]);
+      const auto timeA = times[i];
+      const auto timeB = times[i+1];
       auto timeStr = std::to_string(timeB-timeA);
       auto num_digits = std::count(timeStr.cbegin(), timeStr.cend(), '0');
       float power_of_10 = std::pow(10, num_digits);
@@ -439,15 +487,15 @@ namespace simil
       if(it != m_groups.cend() - 1) aFile << ",";
     }
 
-    for(auto it = m_voltages.cbegin(); it != m_voltages.cend(); it += m_groups.size())
+    aFile << '\n';
+
+    std::vector<float> row(m_matrix.groups());
+    for(size_t r = 0; r < m_matrix.rows(); ++r)
     {
-      for(size_t i = 0; i < m_groups.size(); ++i)
-      {
-        auto &val = *(it + i);
-        if(i == 0) aFile << std::get<0>(val) << ",";
-        aFile << std::get<1>(val);
-        if(i +1 != m_groups.size()) aFile << ",";
-      }
+      m_matrix.row(r, 0, row.size(), row.data());
+      aFile << m_matrix.time(r);
+      for(const auto value: row)
+        aFile << "," << value;
       aFile << '\n';
     }
 
@@ -459,13 +507,29 @@ namespace simil
   void CSVVoltages::clear()
   {
     _startTime = _endTime = 0.f;
-    m_voltages.clear();
+    m_matrix.reset(0);
     m_groups.clear();
   }
 
   TVoltages CSVVoltages::voltages() const
   {
-    return m_voltages;
+    TVoltages result;
+    result.reserve(m_matrix.rows() * m_matrix.groups());
+
+    std::vector<float> row(m_matrix.groups());
+    for(size_t r = 0; r < m_matrix.rows(); ++r)
+    {
+      m_matrix.row(r, 0, row.size(), row.data());
+      for(size_t i = 0; i < row.size(); ++i)
+        result.emplace_back(m_matrix.time(r), row[i], static_cast<int>(i));
+    }
+
+    return result;
+  }
+
+  const VoltageMatrix &CSVVoltages::matrix() const
+  {
+    return m_matrix;
   }
 
   std::vector<std::string> CSVVoltages::groups() const
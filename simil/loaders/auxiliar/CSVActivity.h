@@ -25,8 +25,12 @@
 
 #include "../../types.h"
 #include "CSVNetwork.h"
+#include "../../GIDFilter.h"
+#include "../../VoltageMatrix.h"
 #include <simil/api.h>
 
+#include <memory>
+
 namespace simil
 {
   /** \class CSVActivity
@@ -119,8 +123,16 @@ namespace simil
        */
       TSpikes spikes() const;
 
+      /** \brief Keeps only the spikes of the gids accepted by the filter,
+       * the rest are skipped while parsing. To be called before load().
+       * \param[in] filter Gid filter, nullptr to keep every spike.
+       *
+       */
+      void setGIDFilter(std::shared_ptr<const GIDFilter> filter);
+
     protected:
-      std::multimap< float, uint32_t > _spikes; /** spikes as a map of time - multiple gids. */
+      TSpikes _spikes; /** spikes sorted by time. */
+      std::shared_ptr<const GIDFilter> _gidFilter; /** gids to keep, all if null. */
   };
 
   /** \class CSVVoltages
@@ -149,11 +161,16 @@ namespace simil
 
       virtual void clear();
 
-      /** \brief Returns the voltage activity data as a vector<time,vector<voltage>>.
+      /** \brief Returns a copy of the voltage activity data as a vector<time,voltage,group>.
        *
        */
       TVoltages voltages() const;
 
+      /** \brief Returns the voltages of every group, one row per time.
+       *
+       */
+      const VoltageMatrix &matrix() const;
+
       /** \brief Returns the names of the groups.
        *
        */
@@ -173,6 +190,12 @@ namespace simil
        */
       static float groupTimeStep(const TVoltages &voltages, const unsigned int group);
 
+      /** \brief Returns the minimum time step between the given times.
+       * \param[in] times Sample times, in time order.
+       *
+       */
+      static float timeStep(const std::vector<float> &times);
+
       /** \brief Returns the time range of the data. 
        * \param[in] voltages TVoltages vector.
        * 
@@ -187,7 +210,7 @@ namespace simil
       static std::pair<float, float> timeRangeOfGroup(const TVoltages &voltages, const unsigned int group);
 
     protected:
-      TVoltages m_voltages; /** spikes as vector of multiple voltages. */
+      VoltageMatrix m_matrix; /** voltages of every group, one row per time. */
       std::vector<std::string> m_groups;
   };
 }
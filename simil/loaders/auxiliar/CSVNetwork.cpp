@@ -21,22 +21,19 @@
  */
 
 #include "CSVNetwork.h"
+#include "CSVParser.h"
+#include "../../Parallel.h"
 
-#include <sys/stat.h>
-#include <locale>
 #include <fstream>
-#include <cassert>
-
-#include <QFile>
-#include <QStringList>
+#include <iostream>
+#include <locale>
+#include <stdexcept>
 
 struct dotSeparator: std::numpunct<char>
 {
     char do_decimal_point() const { return '.'; }
 };
 
-const std::vector<char> SEPARATORS{ ',',';','\t',' ' };
-
 namespace simil
 {
   CSVNetwork::CSVNetwork( const std::string& filename,
@@ -50,104 +47,118 @@ namespace simil
 
   void CSVNetwork::load( void )
   {
-    QFile file( QString::fromStdString( _fileName));
-    if( !file.open( QIODevice::ReadOnly | QFile::Text))
-    {
-      const std::string errorMessage = std::string("Error, could not open CSV network file: ") + _fileName;
-      throw std::runtime_error(errorMessage);
-    }
-
+    const auto file = csv::mapFile( _fileName, "network" );
     clear();
 
-    bool ok = false;
-    bool includesGID = false;
-    unsigned int counter = 0;
-    unsigned int gid = 0;
+    const csv::Text text = csv::fileText( *file );
 
     // Tests for correct separator
-    QByteArray line = file.readLine( );
-    QList< QByteArray > wordList = line.split( _separator );
-    if(wordList.size() < 3 || wordList.size() > 4)
-    {
-      for(auto candidate: SEPARATORS)
-      {
-        wordList = line.split( candidate );
-        if( wordList.size( ) < 3 || wordList.size( ) > 4 )
-          continue;
+    const char* position = text.begin;
+    _separator = csv::detectSeparator( csv::nextLine( position, text.end ),
+                                       _separator, 3, 4 );
 
-        _separator = candidate;
-        break;
-      }
-    }
-    assert(file.seek(0));
-
-    while( !file.atEnd( ))
+    // Lines without GID take their index among the loaded ones, known once
+    // all the previous pieces are parsed.
+    struct Neuron
     {
-      QStringList stringLine;
-      line = file.readLine( );
-      wordList = line.split( _separator );
-      wordList.removeAll("");
-
-      if( wordList.size( ) < 3 || wordList.size( ) > 4 )
-      {
-      	const std::string errorText = std::string("CSV error in line: ") + std::to_string(counter) +
-      			                          std::string(". Please check file format and make sure all lines match the following structure for each line:") +
-																			std::string(" '[GID,]X,Y,Z' where the GID is an optional field, and  X,Y,Z are the 3D coordinates.\n") +
-																			std::string("Separator used: '") + _separator + "'\n";
-        throw std::runtime_error(errorText);
-      }
-
-      for( const auto &word : wordList )
-        stringLine.append( word.constData( ));
-
-      vmml::Vector3f coordinates;
-
-      includesGID = wordList.size( ) > 3;
-
-      gid = ( includesGID ) ? stringLine[ 0 ].toUInt( &ok ) : counter;
-
-      if(includesGID && !ok)
-      {
-        std::cerr << "Warning: Unable to convert gid value: " << stringLine[0].toStdString() << std::endl;
-        continue;
-      }
-
-      unsigned int i = 0;
-      for( auto word : stringLine )
+      bool includesGID;
+      unsigned int gid;
+      vmml::Vector3f position;
+    };
+
+    const auto pieces = csv::splitLines(
+      text, parallel::threadCount( text.end - text.begin, csv::MIN_PIECE_BYTES ));
+    std::vector< csv::Piece > parsed( pieces.size( ));
+    std::vector< std::vector< Neuron >> neurons( pieces.size( ));
+    const char separator = _separator;
+
+    parallel::forRanges( pieces.size( ), pieces.size( ),
+      [ & ]( unsigned int, size_t begin, size_t end )
       {
-        // skips gid number to make it sequential from 0.
-        if( includesGID && i == 0 )
+        std::vector< csv::Text > words;
+        for( size_t p = begin; p < end; ++p )
         {
-          ++i;
-          continue;
+          auto& piece = parsed[ p ];
+          const char* current = pieces[ p ].begin;
+
+          for( ; current < pieces[ p ].end; ++piece.lines )
+          {
+            const csv::Text line = csv::nextLine( current, pieces[ p ].end );
+            const size_t count = csv::splitFields( line, separator, words );
+            if( count == 0 )
+              continue;
+
+            if( count < 3 || count > 4 )
+            {
+              piece.errorLine = piece.lines;
+              break;
+            }
+
+            Neuron neuron;
+            neuron.includesGID = count > 3;
+            neuron.gid = 0;
+            neuron.position = vmml::Vector3f( 0.f, 0.f, 0.f );
+
+            if( neuron.includesGID &&
+                !csv::parseUnsigned( words[ 0 ], neuron.gid ))
+            {
+              piece.warnings.emplace_back( piece.lines,
+                "Unable to convert gid value: " + csv::toString( words[ 0 ]));
+              continue;
+            }
+
+            // skips gid number to make it sequential from 0.
+            unsigned int i = 0;
+            for( size_t w = neuron.includesGID ? 1 : 0; w < count; ++w )
+            {
+              float value = 0.f;
+              if( !csv::parseFloat( words[ w ], value ))
+              {
+                piece.warnings.emplace_back( piece.lines, "Value " +
+                  csv::toString( words[ w ]) + " not converted to float." );
+                continue;
+              }
+
+              neuron.position[ i++ ] = value;
+            }
+
+            neurons[ p ].push_back( neuron );
+          }
         }
+      });
 
-        const float value = word.toFloat( &ok );
-
-        if( !ok )
-        {
-          std::cerr << "Warning: Value " << word.toStdString( ) << " not converted to float." << std::endl;
-          continue;
-        }
-
-        coordinates[ i - (includesGID ? 1:0) ] = value;
+    const size_t errorLine = csv::report( parsed, 0, std::cerr );
+    if( errorLine != csv::NO_LINE )
+    {
+      const std::string errorText = std::string("CSV error in line: ") + std::to_string(errorLine) +
+                                    std::string(". Please check file format and make sure all lines match the following structure for each line:") +
+                                    std::string(" '[GID,]X,Y,Z' where the GID is an optional field, and  X,Y,Z are the 3D coordinates.\n") +
+                                    std::string("Separator used: '") + _separator + "'\n";
+      throw std::runtime_error(errorText);
+    }
 
-        i++;
+    unsigned int counter = 0;
+    for( const auto& piece : neurons )
+    {
+      _positions.reserve( _positions.size( ) + piece.size( ));
+      _gidVec.reserve( _gidVec.size( ) + piece.size( ));
+      for( const auto& neuron : piece )
+      {
+        const uint32_t gid = neuron.includesGID ? neuron.gid : counter;
+        _gids.insert( gid );
+        _gidVec.push_back( gid );
+        _positions.push_back( neuron.position );
+        ++counter;
       }
-
-      _gids.insert( gid );
-      _positions.push_back( coordinates );
-
-      counter++;
     }
 
-    file.close( );
     std::cout << "CSV Read " << counter << " gids" << std::endl;
   }
 
   void CSVNetwork::clear( void )
   {
     _gids.clear();
+    _gidVec.clear();
     _positions.clear();
   }
 
@@ -156,6 +167,11 @@ namespace simil
     return _gids;
   }
 
+  const simil::GIDVec& CSVNetwork::getGIDVec( void ) const
+  {
+    return _gidVec;
+  }
+
   void CSVNetwork::save(const std::string filename)
   {
     std::ofstream nFile;
@@ -170,7 +186,7 @@ namespace simil
     nFile.imbue(std::locale(nFile.getloc(), new dotSeparator()));
 
     auto pit = _positions.cbegin();
-    for(auto git = _gids.cbegin(); git != _gids.cend(); ++git, ++pit)
+    for(auto git = _gidVec.cbegin(); git != _gidVec.cend(); ++git, ++pit)
     {
       auto &pos = *pit;
       nFile << std::to_string(*git) << "," << pos[0] << "," << pos[1] << "," << pos[2] << '\n';
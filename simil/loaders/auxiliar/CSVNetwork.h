@@ -70,6 +70,11 @@ namespace simil
        */
       simil::TGIDSet getGIDs( void ) const;
 
+      /** \brief Returns the gids in file order, the order of the positions.
+       *
+       */
+      const simil::GIDVec& getGIDVec( void ) const;
+
       /** \brief Returns the gids positions vector.
        *
        */
@@ -80,6 +85,7 @@ namespace simil
       char _separator;       /** suggested separator character. */
 
       simil::TGIDSet _gids;       /** gids set. */
+      simil::GIDVec _gidVec;      /** gids in file order. */
       simil::TPosVect _positions; /** gids positions vector. */
   };
 }
@@ -0,0 +1,352 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "CSVParser.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <locale>
+#include <sstream>
+#include <stdexcept>
+
+#if defined( __SSE2__ ) || defined( _M_X64 )
+#include <emmintrin.h>
+#define SIMIL_CSVPARSER_SSE2
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+namespace
+{
+  const char SEPARATORS[ ] = { ',', ';', '\t', ' ' };
+
+  // Powers of ten exactly representable as doubles.
+  const double POWERS_OF_TEN[ ] =
+  {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+  };
+
+  const int MAX_EXACT_POWER = 22;
+  const int MAX_DIGITS = 19;
+  const uint64_t MAX_EXACT_MANTISSA = uint64_t( 1 ) << 53;
+
+  inline bool isSpace( char c )
+  {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' ||
+      c == '\f' || c == '\v';
+  }
+
+  inline bool isDigit( char c )
+  {
+    return c >= '0' && c <= '9';
+  }
+
+  void trim( const char*& begin, const char*& end )
+  {
+    while( begin < end && isSpace( *begin ))
+      ++begin;
+    while( end > begin && isSpace( end[ -1 ]))
+      --end;
+  }
+
+#ifdef SIMIL_CSVPARSER_SSE2
+  inline unsigned int firstBit( unsigned int mask )
+  {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward( &index, mask );
+    return static_cast< unsigned int >( index );
+#else
+    return static_cast< unsigned int >( __builtin_ctz( mask ));
+#endif
+  }
+#endif
+
+  /** Numbers with too many digits or large exponents, always in the C
+   * locale. */
+  bool parseSlowFloat( const char* begin, const char* end, float& value )
+  {
+    std::istringstream stream( std::string( begin, end ));
+    stream.imbue( std::locale::classic( ));
+
+    double result = 0;
+    stream >> result;
+    if( stream.fail( ) || !stream.eof( ))
+      return false;
+
+    value = static_cast< float >( result );
+    return true;
+  }
+}
+
+namespace simil
+{
+  namespace csv
+  {
+    std::unique_ptr< MappedFile > mapFile( const std::string& fileName,
+                                           const std::string& kind )
+    {
+      try
+      {
+        return std::unique_ptr< MappedFile >( new MappedFile( fileName ));
+      }
+      catch( const std::runtime_error& )
+      {
+        throw std::runtime_error( "Error, could not open CSV " + kind +
+                                  " file: " + fileName );
+      }
+    }
+
+    Text fileText( const MappedFile& file )
+    {
+      const char* data = reinterpret_cast< const char* >( file.data( ));
+      return Text{ data, data + file.size( )};
+    }
+
+    size_t report( const std::vector< Piece >& pieces, size_t firstLine,
+                   std::ostream& stream )
+    {
+      size_t line = firstLine;
+      for( const auto& piece : pieces )
+      {
+        for( const auto& warning : piece.warnings )
+          stream << "Warning: Line " << line + warning.first << ". "
+                 << warning.second << std::endl;
+
+        if( piece.errorLine != NO_LINE )
+          return line + piece.errorLine;
+        line += piece.lines;
+      }
+
+      return NO_LINE;
+    }
+
+    const char* findLineBreak( const char* begin, const char* end )
+    {
+#ifdef SIMIL_CSVPARSER_SSE2
+      const __m128i lineBreak = _mm_set1_epi8( '\n' );
+      for( ; end - begin >= 16; begin += 16 )
+      {
+        const __m128i block =
+          _mm_loadu_si128( reinterpret_cast< const __m128i* >( begin ));
+        const unsigned int mask = static_cast< unsigned int >(
+          _mm_movemask_epi8( _mm_cmpeq_epi8( block, lineBreak )));
+        if( mask )
+          return begin + firstBit( mask );
+      }
+#endif
+      while( begin < end && *begin != '\n' )
+        ++begin;
+      return begin;
+    }
+
+    Text nextLine( const char*& position, const char* end )
+    {
+      const char* lineEnd = findLineBreak( position, end );
+      Text line{ position, lineEnd };
+      position = lineEnd < end ? lineEnd + 1 : end;
+
+      if( line.end > line.begin && line.end[ -1 ] == '\r' )
+        --line.end;
+      return line;
+    }
+
+    std::vector< Text > splitLines( const Text& text, unsigned int count )
+    {
+      std::vector< Text > pieces;
+      const size_t size = static_cast< size_t >( text.end - text.begin );
+      const char* start = text.begin;
+
+      for( unsigned int i = 1; i <= count && start < text.end; ++i )
+      {
+        const char* limit = text.end;
+        if( i < count )
+        {
+          limit = std::max( start, text.begin + size / count * i );
+          limit = findLineBreak( limit, text.end );
+          if( limit < text.end )
+            ++limit;
+        }
+
+        if( limit > start )
+          pieces.push_back( Text{ start, limit });
+        start = limit;
+      }
+
+      return pieces;
+    }
+
+    size_t splitFields( const Text& line, char separator,
+                        std::vector< Text >& fields )
+    {
+      fields.clear( );
+      const char* start = line.begin;
+      for( const char* position = line.begin; ; ++position )
+      {
+        if( position == line.end || *position == separator )
+        {
+          if( position > start )
+            fields.push_back( Text{ start, position });
+          if( position == line.end )
+            break;
+          start = position + 1;
+        }
+      }
+
+      return fields.size( );
+    }
+
+    char detectSeparator( const Text& line, char suggested,
+                          size_t minFields, size_t maxFields )
+    {
+      std::vector< Text > fields;
+      const auto fits = [ & ]( char candidate )
+      {
+        const size_t count = splitFields( line, candidate, fields );
+        return count >= minFields && count <= maxFields;
+      };
+
+      if( fits( suggested ))
+        return suggested;
+
+      for( const char candidate : SEPARATORS )
+        if( fits( candidate ))
+          return candidate;
+
+      return suggested;
+    }
+
+    bool parseFloat( const Text& field, float& value )
+    {
+      const char* begin = field.begin;
+      const char* end = field.end;
+      trim( begin, end );
+
+      const char* position = begin;
+      bool negative = false;
+      if( position < end && ( *position == '+' || *position == '-' ))
+        negative = *position++ == '-';
+
+      // Up to MAX_DIGITS significant digits are kept in the mantissa,
+      // leading zeros don't count.
+      uint64_t mantissa = 0;
+      int digits = 0;
+      int exponent = 0;
+      bool anyDigit = false;
+      bool truncated = false;
+
+      for( ; position < end && isDigit( *position ); ++position )
+      {
+        anyDigit = true;
+        const unsigned int digit = *position - '0';
+        if( digits < MAX_DIGITS )
+        {
+          mantissa = mantissa * 10 + digit;
+          digits += mantissa != 0;
+        }
+        else
+        {
+          ++exponent;
+          truncated |= digit != 0;
+        }
+      }
+
+      if( position < end && *position == '.' )
+      {
+        for( ++position; position < end && isDigit( *position ); ++position )
+        {
+          anyDigit = true;
+          const unsigned int digit = *position - '0';
+          if( digits < MAX_DIGITS )
+          {
+            mantissa = mantissa * 10 + digit;
+            digits += mantissa != 0;
+            --exponent;
+          }
+          else
+            truncated |= digit != 0;
+        }
+      }
+
+      if( !anyDigit )
+        return false;
+
+      if( position < end && ( *position == 'e' || *position == 'E' ))
+      {
+        ++position;
+        bool negativeExponent = false;
+        if( position < end && ( *position == '+' || *position == '-' ))
+          negativeExponent = *position++ == '-';
+        if( position == end || !isDigit( *position ))
+          return false;
+
+        int written = 0;
+        for( ; position < end && isDigit( *position ); ++position )
+          written = std::min( written * 10 + ( *position - '0' ), 100000 );
+        exponent += negativeExponent ? -written : written;
+      }
+
+      if( position != end )
+        return false;
+
+      if( truncated || mantissa > MAX_EXACT_MANTISSA ||
+          exponent < -MAX_EXACT_POWER || exponent > MAX_EXACT_POWER )
+        return parseSlowFloat( begin, end, value );
+
+      // Exact mantissa and power of ten, so a single correctly rounded
+      // operation gives the nearest double.
+      double result = static_cast< double >( mantissa );
+      result = exponent < 0 ? result / POWERS_OF_TEN[ -exponent ]
+                            : result * POWERS_OF_TEN[ exponent ];
+      value = static_cast< float >( negative ? -result : result );
+      return true;
+    }
+
+    bool parseUnsigned( const Text& field, unsigned int& value )
+    {
+      const char* begin = field.begin;
+      const char* end = field.end;
+      trim( begin, end );
+
+      if( begin < end && *begin == '+' )
+        ++begin;
+      if( begin == end )
+        return false;
+
+      uint64_t result = 0;
+      for( ; begin < end; ++begin )
+      {
+        if( !isDigit( *begin ))
+          return false;
+        result = result * 10 + static_cast< unsigned int >( *begin - '0' );
+        if( result > std::numeric_limits< unsigned int >::max( ))
+          return false;
+      }
+
+      value = static_cast< unsigned int >( result );
+      return true;
+    }
+  }
+}
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef __SIMIL__CSVPARSER_H__
+#define __SIMIL__CSVPARSER_H__
+
+#include "MappedFile.h"
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace simil
+{
+  /** \brief Helpers to parse CSV text mapped in memory, shared by the CSV
+   * loaders. Internal header.
+   *
+   */
+  namespace csv
+  {
+    /** \brief Range of characters, a line without its line break or a
+     * field of a line.
+     *
+     */
+    struct Text
+    {
+      const char* begin;
+      const char* end;
+    };
+
+    /** \brief Line index of a piece without errors.
+     *
+     */
+    const size_t NO_LINE = std::numeric_limits< size_t >::max( );
+
+    /** \brief Files are split in pieces of at least this size to be parsed
+     * in parallel.
+     *
+     */
+    const size_t MIN_PIECE_BYTES = size_t( 1 ) << 20;
+
+    /** \brief Outcome of parsing a piece of a file, with line indices
+     * relative to the start of the piece.
+     *
+     */
+    struct Piece
+    {
+      size_t lines = 0;
+      size_t errorLine = NO_LINE;
+      std::vector< std::pair< size_t, std::string >> warnings;
+    };
+
+    /** \brief Maps the file in memory. Throws std::runtime_error naming the
+     * kind of file if it can't be opened.
+     * \param[in] fileName Name of the file on disk.
+     * \param[in] kind Description of the file for the error message.
+     *
+     */
+    std::unique_ptr< MappedFile > mapFile( const std::string& fileName,
+                                           const std::string& kind );
+
+    /** \brief Returns the contents of the mapped file as text.
+     * \param[in] file Mapped file.
+     *
+     */
+    Text fileText( const MappedFile& file );
+
+    /** \brief Prints the warnings of the pieces in file order up to the
+     * first error, and returns the file line index of that error or NO_LINE.
+     * \param[in] pieces Parsed pieces, in file order.
+     * \param[in] firstLine Line index of the start of the first piece.
+     * \param[in] stream Output for the warnings.
+     *
+     */
+    size_t report( const std::vector< Piece >& pieces, size_t firstLine,
+                   std::ostream& stream );
+
+    /** \brief Returns the position of the first line break in [begin, end),
+     * or end if there is none. Uses SSE2 where available.
+     * \param[in] begin Start of the text.
+     * \param[in] end End of the text.
+     *
+     */
+    const char* findLineBreak( const char* begin, const char* end );
+
+    /** \brief Returns the line starting at position, without line break or
+     * carriage return, and moves position to the start of the next line.
+     * \param[in,out] position Start of the line.
+     * \param[in] end End of the text.
+     *
+     */
+    Text nextLine( const char*& position, const char* end );
+
+    /** \brief Splits the text in up to count consecutive pieces of similar
+     * size, each one starting at the beginning of a line.
+     * \param[in] text Text to split.
+     * \param[in] count Number of pieces.
+     *
+     */
+    std::vector< Text > splitLines( const Text& text, unsigned int count );
+
+    /** \brief Splits the line at the separator, dropping empty fields, and
+     * returns the number of fields.
+     * \param[in] line Line to split.
+     * \param[in] separator Field separator.
+     * \param[out] fields Fields of the line.
+     *
+     */
+    size_t splitFields( const Text& line, char separator,
+                        std::vector< Text >& fields );
+
+    /** \brief Returns the separator that splits the line in a number of
+     * fields in [minFields, maxFields], trying the suggested one first and
+     * then ',', ';', tab and space. Returns the suggested separator if none
+     * of them does.
+     * \param[in] line Sample line.
+     * \param[in] suggested Suggested separator.
+     * \param[in] minFields Minimum number of fields.
+     * \param[in] maxFields Maximum number of fields.
+     *
+     */
+    char detectSeparator( const Text& line, char suggested,
+                          size_t minFields, size_t maxFields );
+
+    /** \brief Parses a decimal float ignoring surrounding whitespace.
+     * Returns false if the field is not a number.
+     * \param[in] field Text to parse.
+     * \param[out] value Parsed value.
+     *
+     */
+    bool parseFloat( const Text& field, float& value );
+
+    /** \brief Parses an unsigned integer ignoring surrounding whitespace.
+     * Returns false if the field is not a number or doesn't fit.
+     * \param[in] field Text to parse.
+     * \param[out] value Parsed value.
+     *
+     */
+    bool parseUnsigned( const Text& field, unsigned int& value );
+
+    /** \brief Returns the text as a string, for messages.
+     * \param[in] text Text range.
+     *
+     */
+    inline std::string toString( const Text& text )
+    {
+      return std::string( text.begin, text.end );
+    }
+  }
+}
+
+#endif /* __SIMIL__CSVPARSER_H__ */
@@ -22,10 +22,130 @@
 
 
 #include "H5Activity.h"
+#include "../../SpikeMerge.h"
+#include <algorithm>
 #include <cassert>
+#include <limits>
 
 const char RECORDERS_TAG[]="recorders/soma_spikes";
 
+namespace
+{
+  // Window bound searches read single elements until this many rows are
+  // left, and then read them at once.
+  const hsize_t PROBE_ROWS = 4096;
+
+  // Spike datasets are read in blocks of this many rows, so filtered loads
+  // only hold one block of rejected spikes.
+  const hsize_t READ_ROWS = hsize_t( 1 ) << 20;
+
+  /** Reads count rows of a column of a one or two dimensional dataset,
+   * starting at row. */
+  void readColumn( const H5::DataSet& dataSet, const H5::PredType& type,
+                   hsize_t row, hsize_t count, hsize_t column, void* values )
+  {
+    if( count == 0 )
+      return;
+
+    H5::DataSpace space = dataSet.getSpace( );
+    const hsize_t offset[ 2 ] = { row, column };
+    const hsize_t size[ 2 ] = { count, 1 };
+    space.selectHyperslab( H5S_SELECT_SET, size, offset );
+
+    H5::DataSpace memory( 1, &count );
+    dataSet.read( values, type, memory, space );
+  }
+
+  /** Sets bound to the first row in [first, rows) with a time not less
+   * than value, or greater than value if inclusive. The rows read must lie
+   * in [low, high], the times of the first and last rows, or false is
+   * returned as the times are not sorted. */
+  bool timeBound( const H5::DataSet& dataSet, hsize_t first, hsize_t rows,
+                  hsize_t column, float value, bool inclusive,
+                  float low, float high, hsize_t& bound )
+  {
+    hsize_t length = rows - first;
+    float probe = 0.0f;
+    while( length > PROBE_ROWS )
+    {
+      const hsize_t half = length / 2;
+      readColumn( dataSet, H5::PredType::NATIVE_FLOAT, first + half, 1,
+                  column, &probe );
+      if( probe < low || probe > high )
+        return false;
+
+      if( inclusive ? probe <= value : probe < value )
+      {
+        low = probe;
+        first += half + 1;
+        length -= half + 1;
+      }
+      else
+      {
+        high = probe;
+        length = half;
+      }
+    }
+
+    std::vector< float > block( length );
+    readColumn( dataSet, H5::PredType::NATIVE_FLOAT, first, length, column,
+                block.data( ));
+    if( !std::is_sorted( block.cbegin( ), block.cend( )) ||
+        ( !block.empty( ) && ( block.front( ) < low || block.back( ) > high )))
+      return false;
+
+    const auto position = inclusive ?
+      std::upper_bound( block.cbegin( ), block.cend( ), value ) :
+      std::lower_bound( block.cbegin( ), block.cend( ), value );
+    bound = first + static_cast< hsize_t >( position - block.cbegin( ));
+    return true;
+  }
+
+  /** Sets first and count to the rows with times in [start, end]. Returns
+   * false, leaving them untouched, if the times turn out unsorted. */
+  bool windowRows( const H5::DataSet& dataSet, hsize_t rows, hsize_t column,
+                   float start, float end, hsize_t& first, hsize_t& count )
+  {
+    if( rows == 0 )
+      return true;
+
+    float low = 0.0f;
+    float high = 0.0f;
+    readColumn( dataSet, H5::PredType::NATIVE_FLOAT, 0, 1, column, &low );
+    readColumn( dataSet, H5::PredType::NATIVE_FLOAT, rows - 1, 1, column,
+                &high );
+
+    hsize_t begin = 0;
+    hsize_t last = 0;
+    if( low > high ||
+        !timeBound( dataSet, 0, rows, column, start, false, low, high,
+                    begin ) ||
+        !timeBound( dataSet, begin, rows, column, end, true, low, high,
+                    last ))
+      return false;
+
+    first = begin;
+    count = last - begin;
+    return true;
+  }
+
+  /** Drops the spikes of the run out of [start, end]. */
+  void filterRun( simil::SpikeRun& run, float start, float end )
+  {
+    size_t kept = 0;
+    for( size_t i = 0; i < run.times.size( ); ++i )
+    {
+      if( run.times[ i ] < start || run.times[ i ] > end )
+        continue;
+      run.times[ kept ] = run.times[ i ];
+      run.gids[ kept ] = run.gids[ i ];
+      ++kept;
+    }
+    run.times.resize( kept );
+    run.gids.resize( kept );
+  }
+}
+
 namespace simil
 {
   H5Activity::H5Activity( H5Network& network,
@@ -58,6 +178,8 @@ namespace simil
   , _startTime( 0.f )
   , _endTime( 0.f )
   , _totalRecords( 0 )
+  , _windowStart( std::numeric_limits< float >::lowest( ))
+  , _windowEnd( std::numeric_limits< float >::max( ))
   { }
 
   H5Spikes::~H5Spikes( void )
@@ -65,6 +187,15 @@ namespace simil
 
   void H5Spikes::Load( void )
   {
+    Load( std::numeric_limits< float >::lowest( ),
+          std::numeric_limits< float >::max( ));
+  }
+
+  void H5Spikes::Load( float startTime_, float endTime_ )
+  {
+    _windowStart = startTime_;
+    _windowEnd = endTime_;
+
     if( _fileName.empty( ))
     {
       std::cerr << "Error: file path cannot be empty." << std::endl;
@@ -188,7 +319,10 @@ namespace simil
     if(!_spikes.empty())
       return _spikes;
 
-    std::multimap< float, uint32_t > sortedResult;
+    // Datasets are read as runs and merged at the end, they usually come
+    // sorted by time.
+    std::vector< SpikeRun > runs;
+    runs.reserve( _groupNames.size( ));
 
     auto& attribs = _network._attributes;
 
@@ -208,6 +342,17 @@ namespace simil
 
       unsigned int currentOffset = std::get< H5Network::tna_offset >( att->second );
 
+      // Populations without accepted gids are not read.
+      if( _gidFilter )
+      {
+        hsize_t population[ 2 ] = { 0, 0 };
+        std::get< H5Network::tna_dataset >( att->second ).getSpace( )
+          .getSimpleExtentDims( population );
+        if( !_gidFilter->containsAny( currentOffset, static_cast< uint32_t >(
+               currentOffset + population[ 0 ])))
+          continue;
+      }
+
       hsize_t dimsTimes[ 2 ];
       hsize_t dimsIds[ 2 ];
 
@@ -216,50 +361,102 @@ namespace simil
 
       assert( dimsTimes[ 0 ] == dimsIds[ 0 ] );
 
-      unsigned int numRecords = dimsTimes[ 0 ];
-
-      std::vector< float > tempTimes( numRecords );
-      std::vector< unsigned int > tempIds( numRecords );
+      const hsize_t numRecords = dimsTimes[ 0 ];
+      hsize_t first = 0;
+      hsize_t count = numRecords;
+      bool sorted = !windowed( ) ||
+        windowRows( times, numRecords, 0, _windowStart, _windowEnd,
+                    first, count );
+
+      runs.emplace_back( );
+      SpikeRun& run = runs.back( );
+      std::vector< float >& tempTimes = run.times;
+      std::vector< uint32_t >& tempIds = run.gids;
+
+      // Rows are read in blocks at the end of the run, which is compacted
+      // to the accepted gids before the next block.
+      const auto readRows = [ & ]( )
+      {
+        tempTimes.clear( );
+        tempIds.clear( );
+        for( hsize_t row = first; row < first + count; row += READ_ROWS )
+        {
+          const hsize_t rows = std::min( READ_ROWS, first + count - row );
+          const size_t start = tempTimes.size( );
+          tempTimes.resize( start + rows );
+          tempIds.resize( start + rows );
+          readColumn( times, H5::PredType::IEEE_F32LE, row, rows, 0,
+                      tempTimes.data( ) + start );
+          readColumn( ids, H5::PredType::NATIVE_UINT, row, rows, 0,
+                      tempIds.data( ) + start );
+
+          size_t kept = start;
+          for( size_t j = start; j < start + rows; ++j )
+          {
+            const uint32_t id = tempIds[ j ];
+            if( id + currentOffset > numRecords )
+            {
+              std::cout << "ID " << id << " out of bounds. " << id
+                        << " + " << currentOffset
+                        << " = " << id + currentOffset << std::endl;
+            }
+
+            if( _gidFilter && !_gidFilter->contains( id + currentOffset ))
+              continue;
+
+            tempTimes[ kept ] = tempTimes[ j ];
+            tempIds[ kept ] = id + currentOffset;
+            ++kept;
+          }
+          tempTimes.resize( kept );
+          tempIds.resize( kept );
+        }
+      };
+      readRows( );
 
-      times.read( tempTimes.data( ), H5::PredType::IEEE_F32LE );
-      ids.read( tempIds.data( ), H5::PredType::NATIVE_UINT );
+      // Unsorted datasets are read whole and filtered.
+      if( sorted && windowed( ) &&
+          !std::is_sorted( tempTimes.cbegin( ), tempTimes.cend( )))
+      {
+        sorted = false;
+        first = 0;
+        count = numRecords;
+        readRows( );
+      }
+      if( !sorted )
+        filterRun( run, _windowStart, _windowEnd );
 
       times.close( );
       ids.close( );
 
       _startTime = 0.0f;
 
-      if( tempTimes.back( ) > _endTime )
+      if( !tempTimes.empty( ) && tempTimes.back( ) > _endTime )
         _endTime = tempTimes.back( );
 
-      auto time = tempTimes.begin( );
-      for( auto id : tempIds )
-      {
-        if( id + currentOffset > tempIds.size( ))
-        {
-          std::cout << "ID " << id << " out of bounds. " << id
-                    << " + " << currentOffset
-                    << " = " << id + currentOffset << std::endl;
-        }
-
-        sortedResult.insert( std::make_pair( *time, id + currentOffset ));
-
-        time++;
-
-      }
-
       std::cout << "Loaded dataset " << currentName << " with " << tempTimes.size( ) << std::endl;
     }
 
-    for( auto spike : sortedResult )
-      _spikes.push_back( spike );
+    _spikes = mergeSpikeRuns( runs );
+    _endTime = std::max( _endTime, startTime( ));
 
     return _spikes;
   }
 
+  void H5Spikes::setGIDFilter( std::shared_ptr< const GIDFilter > filter )
+  {
+    _gidFilter = std::move( filter );
+  }
+
   float H5Spikes::startTime( void )
   {
-    return 0;
+    return std::max( 0.0f, _windowStart );
+  }
+
+  bool H5Spikes::windowed( void ) const
+  {
+    return _windowStart > std::numeric_limits< float >::lowest( ) ||
+      _windowEnd < std::numeric_limits< float >::max( );
   }
 
   float H5Spikes::endTime( void )
@@ -274,7 +471,7 @@ namespace simil
     _startTime = std::numeric_limits< float >::max( );
     _endTime = std::numeric_limits< float >::min( );
 
-    std::multimap< float, uint32_t > sortedResult;
+    std::vector< SpikeRun > runs;
 
     std::map<std::string, std::string> colors;
 
@@ -306,58 +503,50 @@ namespace simil
 
       dataSet.openAttribute("cell_id").read(scalarType, &gid);
 
-      auto bufferFloatType = H5::PredType::IEEE_F64LE;
+      // Recorders of rejected cells are not read.
+      if(_gidFilter && !_gidFilter->contains(static_cast<uint32_t>(gid))) continue;
 
       assert(dataSet.getTypeClass() == H5T_FLOAT);
-      const auto floatType = dataSet.getFloatType();
-      const auto byteSize = floatType.getSize();
-
-      if(byteSize == 4)      bufferFloatType = H5::PredType::IEEE_F32LE;
-      else if(byteSize == 8) bufferFloatType = H5::PredType::IEEE_F64LE;
 
       hsize_t dims[2];
       memset(dims, 0, 2*sizeof(hsize_t));
       dataSet.getSpace().getSimpleExtentDims( dims );
       assert(dataSet.getSpace().getSimpleExtentNdims() == 2);
-      if(dims[0] == 0 || dims[1] == 0) continue;
-
-      auto buffer = new char[dims[0]*dims[1]*byteSize];
-      std::memset(buffer, 0, dims[0]*dims[1]*byteSize);
-
-      dataSet.read( reinterpret_cast<void*>(buffer), bufferFloatType );
-
-      TPosVect subset;
-      if(byteSize == 4)
+      if(dims[0] == 0 || dims[1] < 2) continue;
+
+      // Each recorder holds the spikes of a single cell, times in the
+      // second column.
+      const hsize_t timeColumn = 1;
+      hsize_t first = 0;
+      hsize_t count = dims[0];
+      bool sorted = !windowed() ||
+        windowRows(dataSet, dims[0], timeColumn, _windowStart, _windowEnd, first, count);
+
+      runs.emplace_back( );
+      auto &run = runs.back();
+      run.times.resize(count);
+      readColumn(dataSet, H5::PredType::NATIVE_FLOAT, first, count, timeColumn, run.times.data());
+
+      // Unsorted recorders are read whole and filtered.
+      if(sorted && windowed() && !std::is_sorted(run.times.cbegin(), run.times.cend()))
       {
-        auto bufferF = reinterpret_cast<float*>(&buffer[0]);
-        for(size_t bidx = 0; bidx < dims[0]*dims[1]; )
-        {
-          bidx++;
-          sortedResult.emplace(std::make_pair(bufferF[bidx], gid));
-          bidx++;
-        }
+        sorted = false;
+        run.times.resize(dims[0]);
+        readColumn(dataSet, H5::PredType::NATIVE_FLOAT, 0, dims[0], timeColumn, run.times.data());
       }
-      else
+      if(!sorted)
       {
-        auto bufferD = reinterpret_cast<double*>(&buffer[0]);
-        for(size_t bidx = 0; bidx < dims[0]*dims[1];)
-        {
-          bidx++;
-          sortedResult.emplace(std::make_pair(static_cast<float>(bufferD[bidx]), gid));
-          bidx++;
-        }
+        run.gids.resize(run.times.size());
+        filterRun(run, _windowStart, _windowEnd);
       }
-      delete [] buffer;
+      run.gids.assign(run.times.size(), static_cast<uint32_t>(gid));
     }
 
-    if(!sortedResult.empty())
+    _spikes = mergeSpikeRuns(runs);
+    if(!_spikes.empty())
     {
-      for(auto item: sortedResult)
-      {
-        _startTime = std::min(_startTime, item.first);
-        _endTime = std::max(_endTime, item.first);
-        _spikes.emplace_back(item);
-      }
+      _startTime = std::min(_startTime, _spikes.front().first);
+      _endTime = std::max(_endTime, _spikes.back().first);
     }
 
     assignColors(colors);
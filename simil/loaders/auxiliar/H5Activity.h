@@ -25,8 +25,11 @@
 
 #include "../../types.h"
 #include "H5Network.h"
+#include "../../GIDFilter.h"
 #include <simil/api.h>
 
+#include <memory>
+
 namespace simil
 {
   class SIMIL_API H5Activity
@@ -72,6 +75,25 @@ namespace simil
 
     void Load( void );
 
+    /** \brief Loads the file like Load( ), but only the spikes in the
+     * [startTime, endTime] window are read later by spikes( ). Each time
+     * dataset must be sorted, as the window bounds are found with a binary
+     * search of a few elements per step. Datasets whose window turns out
+     * unsorted are read whole and filtered.
+     * \param[in] startTime Window start time.
+     * \param[in] endTime Window end time.
+     *
+     */
+    void Load( float startTime, float endTime );
+
+    /** \brief Keeps only the spikes of the gids accepted by the filter.
+     * Populations and recorders without accepted gids are not read. To be
+     * called before Load( ).
+     * \param[in] filter Gid filter, nullptr to keep every spike.
+     *
+     */
+    void setGIDFilter( std::shared_ptr< const GIDFilter > filter );
+
     TSpikes spikes( void );
     float startTime( void );
     float endTime( void );
@@ -83,11 +105,21 @@ namespace simil
      */
     void loadRecordersFormat();
 
+    /** \brief Returns true if only a time window is loaded.
+     *
+     */
+    bool windowed( void ) const;
+
     float _startTime;
     float _endTime;
 
     unsigned int _totalRecords;
 
+    float _windowStart;
+    float _windowEnd;
+
+    std::shared_ptr< const GIDFilter > _gidFilter;
+
     TSpikes _spikes;
 
     std::vector< H5::DataSet > _spikeTimes;
@@ -143,6 +143,10 @@ namespace simil
         // Assume dataset is correct so far...
         _offsets.push_back( records );
         _gids.reserve(_gids.size() + dims[0]);
+
+        // Only the gids of this dataset belong to its subset.
+        const size_t firstGid = _gids.size( );
+        GIDSet datasetGids;
         if(dims[1] == 3)
         {
           // no gids, only positions so gids are sequential. Positions
@@ -151,6 +155,8 @@ namespace simil
           {
             _gids.emplace_back(_offsets.back() + gid);
           }
+          datasetGids.insertRange( _offsets.back( ),
+            static_cast< uint32_t >( _offsets.back( ) + dims[ 0 ]));
         }
         else
         {
@@ -195,16 +201,19 @@ namespace simil
           }
           delete [] buffer;
           _positions.insert( _positions.end( ), subset.begin( ), subset.end( ));
+          datasetGids.insert( _gids.cbegin( ) + firstGid, _gids.cend( ));
         }
 
-        _subsets.insert( std::make_pair( label, _gids));
+        // Datasets sharing a label are merged into one subset.
+        _subsets[ label ] |= datasetGids;
         _groupNames.push_back( currentName );
         _datasetNames.push_back( label );
         _groups.push_back( group );
         _datasets.push_back( dataset );
 
         TNetworkAttributes attribs =
-            std::make_tuple( currentName, label, _gids, records, group, dataset );
+            std::make_tuple( currentName, label, datasetGids, records, group,
+                             dataset );
 
         _attributes.insert( std::make_pair( currentName, attribs ));
 
@@ -233,11 +242,12 @@ namespace simil
 
   TGIDSet H5Network::getGIDs( void ) const
   {
-    TGIDSet set;
-
-    for(const auto &value: _gids) set.insert(value);
+    return TGIDSet( _gids.cbegin( ), _gids.cend( ));
+  }
 
-    return set;
+  const GIDVec& H5Network::getGIDVec( void ) const
+  {
+    return _gids;
   }
 
   TPosVect H5Network::getComposedPositions( void )
@@ -303,7 +313,7 @@ namespace simil
   {
     if(_subsets.empty() && !_gids.empty())
     {
-      _subsets.insert( std::make_pair("Unknown", _gids));
+      _subsets.insert( std::make_pair("Unknown", GIDSet(_gids.cbegin(), _gids.cend())));
     }
 
     return std::make_pair( _subsets.begin( ), _subsets.end( ));
@@ -427,7 +437,7 @@ namespace simil
         }
         delete [] buffer;
         const auto groupName = "group " + name;
-        _subsets.insert(std::make_pair(groupName, gids));
+        _subsets.insert(std::make_pair(groupName, GIDSet(gids.cbegin(), gids.cend())));
         _subsetsColors.insert(std::make_pair(groupName, vmml::Vector3f{0,0,0}));
         innerDs.close();
       }
@@ -495,7 +505,7 @@ namespace simil
         }
         delete [] buffer;
         const auto groupName = "connection " + name;
-        _subsets.insert(std::make_pair(groupName, gids));
+        _subsets.insert(std::make_pair(groupName, GIDSet(gids.cbegin(), gids.cend())));
         _subsetsColors.insert(std::make_pair(groupName, vmml::Vector3f{0,0,0}));
         innerDs.close();
       }
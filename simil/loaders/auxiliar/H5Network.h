@@ -56,7 +56,7 @@ namespace simil
 
     typedef std::tuple< std::string,
                         std::string,
-                        GIDVec,
+                        GIDSet,
                         unsigned int,
                         H5::Group,
                         H5::DataSet > TNetworkAttributes;
@@ -77,6 +77,11 @@ namespace simil
     unsigned int subSetsNumber( void ) const;
 
     simil::TGIDSet getGIDs( void ) const;
+
+    /** \brief Returns the gids in file order, the order of the positions.
+     *
+     */
+    const GIDVec& getGIDVec( void ) const;
     simil::TPosVect getComposedPositions( void );
 
     simil::SubsetMapRange getSubsets( void );
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "MappedFile.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace simil
+{
+  MappedFile::MappedFile( const std::string& fileName )
+  : _data( nullptr )
+  , _size( 0 )
+  {
+#ifdef _WIN32
+    _file = CreateFileA( fileName.c_str( ), GENERIC_READ, FILE_SHARE_READ,
+                         nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                         nullptr );
+    _mapping = nullptr;
+    LARGE_INTEGER size;
+    if( _file == INVALID_HANDLE_VALUE || !GetFileSizeEx( _file, &size ))
+    {
+      if( _file != INVALID_HANDLE_VALUE )
+        CloseHandle( _file );
+      throw std::runtime_error( "Unable to open file " + fileName );
+    }
+
+    _size = static_cast< size_t >( size.QuadPart );
+    if( _size == 0 )
+      return;
+
+    _mapping = CreateFileMappingA( _file, nullptr, PAGE_READONLY, 0, 0,
+                                   nullptr );
+    if( _mapping )
+      _data = MapViewOfFile( _mapping, FILE_MAP_READ, 0, 0, 0 );
+    if( !_data )
+    {
+      if( _mapping )
+        CloseHandle( _mapping );
+      CloseHandle( _file );
+      throw std::runtime_error( "Unable to map file " + fileName );
+    }
+#else
+    const int file = open( fileName.c_str( ), O_RDONLY );
+    struct stat status;
+    if( file < 0 || fstat( file, &status ) != 0 )
+    {
+      if( file >= 0 )
+        close( file );
+      throw std::runtime_error( "Unable to open file " + fileName );
+    }
+
+    _size = static_cast< size_t >( status.st_size );
+    if( _size == 0 )
+    {
+      close( file );
+      return;
+    }
+
+    void* data = mmap( nullptr, _size, PROT_READ, MAP_PRIVATE, file, 0 );
+    close( file );
+
+    if( data == MAP_FAILED )
+      throw std::runtime_error( "Unable to map file " + fileName );
+    _data = data;
+#endif
+  }
+
+  MappedFile::~MappedFile( void )
+  {
+#ifdef _WIN32
+    if( _data )
+      UnmapViewOfFile( _data );
+    if( _mapping )
+      CloseHandle( _mapping );
+    if( _file != INVALID_HANDLE_VALUE )
+      CloseHandle( _file );
+#else
+    if( _data )
+      munmap( _data, _size );
+#endif
+  }
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2015-2024 VG-Lab/URJC.
+ *
+ * Authors: Félix de las Pozas Álvarez <felix.delaspozas@urjc.es>
+ *
+ * This file is part of SimIL <https://github.com/vg-lab/SimIL>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef __SIMIL__MAPPEDFILE_H__
+#define __SIMIL__MAPPEDFILE_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace simil
+{
+  /** \class MappedFile
+   * \brief Read only memory mapping of a whole file. Internal header.
+   *
+   */
+  class MappedFile
+  {
+  public:
+
+    /** \brief MappedFile class constructor. Throws std::runtime_error if
+     * the file can't be opened or mapped. Empty files give an empty mapping.
+     * \param[in] fileName Name of the file on disk.
+     *
+     */
+    MappedFile( const std::string& fileName );
+
+    /** \brief MappedFile class destructor, unmaps the file.
+     *
+     */
+    ~MappedFile( void );
+
+    MappedFile( const MappedFile& ) = delete;
+    MappedFile& operator=( const MappedFile& ) = delete;
+
+    /** \brief Returns the contents of the file.
+     *
+     */
+    const uint8_t* data( void ) const
+    {
+      return static_cast< const uint8_t* >( _data );
+    }
+
+    /** \brief Returns the size of the file in bytes.
+     *
+     */
+    size_t size( void ) const
+    {
+      return _size;
+    }
+
+  private:
+
+    void* _data;
+    size_t _size;
+#ifdef _WIN32
+    void* _file;
+    void* _mapping;
+#endif
+  };
+}
+
+#endif /* __SIMIL__MAPPEDFILE_H__ */
@@ -31,11 +31,13 @@
 
 #include <vmmlib/vmmlib.h>
 
+#include "GIDSet.h"
+
 namespace simil
 {
   class Spikes;
 
-  typedef std::set< uint32_t > TGIDSet;
+  typedef GIDSet TGIDSet;
   typedef std::unordered_set< uint32_t > TGIDUSet;
   typedef std::vector< uint32_t > TGIDVect;
   typedef std::vector< vmml::Vector3f > TPosVect;
@@ -43,11 +45,14 @@ namespace simil
   typedef std::pair< float, uint32_t > Spike;
   typedef std::vector< Spike > TSpikes;
 
+  typedef std::vector< float > TSpikeTrain;
+  typedef std::map< uint32_t, TSpikeTrain > TSpikeTrainMap;
+
   typedef std::pair< float, float > Event;
   typedef std::vector< uint32_t > GIDVec;
   typedef std::vector< Event > EventVec;
 
-  typedef std::map< std::string, GIDVec > SubsetMap;
+  typedef std::map< std::string, GIDSet > SubsetMap;
   typedef std::map< std::string, EventVec > EventMap;
 
   typedef SubsetMap::const_iterator SubsetMapCIt;
@@ -75,6 +80,7 @@ namespace simil
     TREST,
     TCONE,
     TSNUDDA,
+    TBINARY,
     TDataUndefined
   } TDataType;
 